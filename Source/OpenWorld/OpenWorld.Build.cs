@@ -15,6 +15,7 @@ public class OpenWorld : ModuleRules
 			"Engine", 
 			"InputCore",
 			"EnhancedInput",
+			"Landscape",
 			"NavigationSystem",
 			"Niagara",
 			"UMG"
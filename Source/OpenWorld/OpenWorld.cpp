@@ -1,6 +1,145 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "OpenWorld.h"
+#include "HAL/IConsoleManager.h"
 #include "Modules/ModuleManager.h"
 
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, OpenWorld, "OpenWorld" );
+
+// ==================== Profiling ==================== //
+
+DEFINE_STAT(STAT_OW_LockOn);
+DEFINE_STAT(STAT_OW_HitTrace);
+DEFINE_STAT(STAT_OW_ApplyDamage);
+DEFINE_STAT(STAT_OW_Engage);
+DEFINE_STAT(STAT_OW_Strafing);
+DEFINE_STAT(STAT_OW_UpdateTime);
+DEFINE_STAT(STAT_OW_UpdateRain);
+DEFINE_STAT(STAT_OW_ChangeLightingValues);
+DEFINE_STAT(STAT_OW_AffectsFoliage);
+DEFINE_STAT(STAT_OW_NativeUpdateAnimation);
+
+DEFINE_STAT(STAT_OW_ActiveAI);
+DEFINE_STAT(STAT_OW_LockedPairs);
+DEFINE_STAT(STAT_OW_Hits);
+DEFINE_STAT(STAT_OW_NiagaraSpawns);
+DEFINE_STAT(STAT_OW_DecalSpawns);
+
+UE_TRACE_CHANNEL_DEFINE(OpenWorldChannel);
+
+UE_TRACE_EVENT_DEFINE(OpenWorld, CombatHit);
+UE_TRACE_EVENT_DEFINE(OpenWorld, CombatDeath);
+UE_TRACE_EVENT_DEFINE(OpenWorld, CombatLockOn);
+UE_TRACE_EVENT_DEFINE(OpenWorld, AIEngage);
+
+std::atomic<bool> FOWStatTotal::bCollecting = false;
+
+FOWStatTotal::FOWStatTotal(const TCHAR* InName, bool bInCycles)
+	: Name(InName)
+	, bCycles(bInCycles)
+{
+	GetRegistry().Add(this);
+}
+
+TArray<FOWStatTotal*>& FOWStatTotal::GetRegistry()
+{
+	// Function static, the totals below are constructed during static initialization
+	static TArray<FOWStatTotal*> Registry;
+	return Registry;
+}
+
+const TArray<FOWStatTotal*>& FOWStatTotal::GetAll()
+{
+	return GetRegistry();
+}
+
+void FOWStatTotal::StartCollecting()
+{
+	for (FOWStatTotal* Total : GetRegistry()) Total->Value = 0;
+
+	bCollecting = true;
+}
+
+void FOWStatTotal::StopCollecting()
+{
+	bCollecting = false;
+}
+
+DEFINE_OW_CYCLE_TOTAL(LockOn);
+DEFINE_OW_CYCLE_TOTAL(HitTrace);
+DEFINE_OW_CYCLE_TOTAL(ApplyDamage);
+DEFINE_OW_CYCLE_TOTAL(Engage);
+DEFINE_OW_CYCLE_TOTAL(Strafing);
+DEFINE_OW_CYCLE_TOTAL(UpdateTime);
+DEFINE_OW_CYCLE_TOTAL(UpdateRain);
+DEFINE_OW_CYCLE_TOTAL(ChangeLightingValues);
+DEFINE_OW_CYCLE_TOTAL(AffectsFoliage);
+DEFINE_OW_CYCLE_TOTAL(NativeUpdateAnimation);
+
+DEFINE_OW_COUNTER_TOTAL(ActiveAI);
+DEFINE_OW_COUNTER_TOTAL(LockedPairs);
+DEFINE_OW_COUNTER_TOTAL(Hits);
+DEFINE_OW_COUNTER_TOTAL(NiagaraSpawns);
+DEFINE_OW_COUNTER_TOTAL(DecalSpawns);
+
+// ==================== Telemetry ==================== //
+
+CSV_DEFINE_CATEGORY_MODULE(OPENWORLD_API, OpenWorldAI, true);
+CSV_DEFINE_CATEGORY_MODULE(OPENWORLD_API, OpenWorldPopulation, true);
+CSV_DEFINE_CATEGORY_MODULE(OPENWORLD_API, OpenWorldWeather, true);
+
+// ==================== Memory ==================== //
+
+LLM_DEFINE_TAG(OpenWorld);
+LLM_DEFINE_TAG(OW_Characters, TEXT("Characters"), TEXT("OpenWorld"));
+LLM_DEFINE_TAG(OW_AI, TEXT("AI"), TEXT("OpenWorld"));
+LLM_DEFINE_TAG(OW_Weapons, TEXT("Weapons"), TEXT("OpenWorld"));
+LLM_DEFINE_TAG(OW_CombatFX, TEXT("CombatFX"), TEXT("OpenWorld"));
+LLM_DEFINE_TAG(OW_Environment, TEXT("Environment"), TEXT("OpenWorld"));
+LLM_DEFINE_TAG(OW_UI, TEXT("UI"), TEXT("OpenWorld"));
+LLM_DEFINE_TAG(OW_Terrain, TEXT("Terrain"), TEXT("OpenWorld"));
+
+static FAutoConsoleCommand MemoryDumpCommand(
+	TEXT("ow.Memory.Dump"),
+	TEXT("Log what every OpenWorld LLM tag currently holds, run with -llm"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+		FLowLevelMemTracker& Tracker = FLowLevelMemTracker::Get();
+
+		if (!Tracker.IsEnabled())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("ow.Memory.Dump: LLM is off, run with -llm"));
+			return;
+		}
+
+		// Amounts are gathered once per frame
+		Tracker.UpdateStatsPerFrame();
+
+		static const TCHAR* TagNames[] = {
+			TEXT("OpenWorld"),
+			TEXT("OW_Characters"),
+			TEXT("OW_AI"),
+			TEXT("OW_Weapons"),
+			TEXT("OW_CombatFX"),
+			TEXT("OW_Environment"),
+			TEXT("OW_UI"),
+			TEXT("OW_Terrain")
+		};
+
+		int64 Total = 0;
+
+		for (const TCHAR* TagName : TagNames)
+		{
+			const int64 Amount = Tracker.GetTagAmountForTracker(ELLMTracker::Default, FName(TagName), ELLMTagSet::None);
+			Total += Amount;
+
+			UE_LOG(LogTemp, Display, TEXT("%-16s %10.2f MB"), TagName, Amount / (1024.0 * 1024.0));
+		}
+
+		UE_LOG(LogTemp, Display, TEXT("%-16s %10.2f MB"), TEXT("Total"), Total / (1024.0 * 1024.0));
+#else
+		UE_LOG(LogTemp, Warning, TEXT("ow.Memory.Dump: LLM isn't compiled in this build"));
+#endif
+	})
+);
@@ -3,4 +3,175 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include <atomic>
 
+// ===== Profiling ========== //
+
+/** stat OpenWorld */
+DECLARE_STATS_GROUP(TEXT("OpenWorld"), STATGROUP_OpenWorld, STATCAT_Advanced);
+
+// Combat
+DECLARE_CYCLE_STAT_EXTERN(TEXT("LockOn"), STAT_OW_LockOn, STATGROUP_OpenWorld, OPENWORLD_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("HitTrace"), STAT_OW_HitTrace, STATGROUP_OpenWorld, OPENWORLD_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("ApplyDamage"), STAT_OW_ApplyDamage, STATGROUP_OpenWorld, OPENWORLD_API);
+
+// AI
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Engage"), STAT_OW_Engage, STATGROUP_OpenWorld, OPENWORLD_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Strafing"), STAT_OW_Strafing, STATGROUP_OpenWorld, OPENWORLD_API);
+
+// Environment
+DECLARE_CYCLE_STAT_EXTERN(TEXT("UpdateTime"), STAT_OW_UpdateTime, STATGROUP_OpenWorld, OPENWORLD_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("UpdateRain"), STAT_OW_UpdateRain, STATGROUP_OpenWorld, OPENWORLD_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("ChangeLightingValues"), STAT_OW_ChangeLightingValues, STATGROUP_OpenWorld, OPENWORLD_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("AffectsFoliage"), STAT_OW_AffectsFoliage, STATGROUP_OpenWorld, OPENWORLD_API);
+
+// Animation, NativeUpdateAnimation runs on the game thread
+DECLARE_CYCLE_STAT_EXTERN(TEXT("NativeUpdateAnimation"), STAT_OW_NativeUpdateAnimation, STATGROUP_OpenWorld, OPENWORLD_API);
+
+// Per frame, counters are cleared every frame
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Active AI"), STAT_OW_ActiveAI, STATGROUP_OpenWorld, OPENWORLD_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Locked Pairs"), STAT_OW_LockedPairs, STATGROUP_OpenWorld, OPENWORLD_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Hits"), STAT_OW_Hits, STATGROUP_OpenWorld, OPENWORLD_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Niagara Spawns"), STAT_OW_NiagaraSpawns, STATGROUP_OpenWorld, OPENWORLD_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Decal Spawns"), STAT_OW_DecalSpawns, STATGROUP_OpenWorld, OPENWORLD_API);
+
+/** Combat and AI events in Insights, -trace=cpu,OpenWorld */
+UE_TRACE_CHANNEL_EXTERN(OpenWorldChannel, OPENWORLD_API);
+
+/** Events on that channel, next to the scopes in the same capture. Actors are their GetUniqueID, 0 for none */
+UE_TRACE_EVENT_BEGIN_EXTERN(OpenWorld, CombatHit)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, Attacker)
+	UE_TRACE_EVENT_FIELD(uint32, Victim)
+	UE_TRACE_EVENT_FIELD(float, Damage)
+	UE_TRACE_EVENT_FIELD(bool, Blocked)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN_EXTERN(OpenWorld, CombatDeath)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, Victim)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN_EXTERN(OpenWorld, CombatLockOn)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, Owner)
+	UE_TRACE_EVENT_FIELD(uint32, Target)
+UE_TRACE_EVENT_END()
+
+/** Decision as in ACombatController::EngageChances */
+UE_TRACE_EVENT_BEGIN_EXTERN(OpenWorld, AIEngage)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, Enemy)
+	UE_TRACE_EVENT_FIELD(uint32, Target)
+	UE_TRACE_EVENT_FIELD(int8, Decision)
+UE_TRACE_EVENT_END()
+
+/**
+ * Run total of one of the stats above, only gathered while a benchmark collects (@see ACrowdBenchmark).
+ * Doesn't need STATS, so Test builds can be measured too
+ */
+struct OPENWORLD_API FOWStatTotal
+{
+	FOWStatTotal(const TCHAR* InName, bool bInCycles);
+
+	const TCHAR* Name;
+
+	/** Cycles for scopes, a count for counters */
+	bool bCycles;
+	std::atomic<int64> Value = 0;
+
+	FORCEINLINE void Add(int64 Amount)
+	{
+		if (IsCollecting()) Value.fetch_add(Amount, std::memory_order_relaxed);
+	}
+
+	FORCEINLINE static bool IsCollecting()
+	{
+		return bCollecting.load(std::memory_order_relaxed);
+	}
+
+	/** Reset every total and start gathering */
+	static void StartCollecting();
+	static void StopCollecting();
+
+	/** In declaration order */
+	static const TArray<FOWStatTotal*>& GetAll();
+
+private:
+	static std::atomic<bool> bCollecting;
+	static TArray<FOWStatTotal*>& GetRegistry();
+};
+
+struct FOWStatTotalScope
+{
+	FORCEINLINE explicit FOWStatTotalScope(FOWStatTotal& InTotal)
+		: Total(InTotal)
+		, StartCycles(FOWStatTotal::IsCollecting() ? FPlatformTime::Cycles64() : 0)
+	{
+	}
+
+	FORCEINLINE ~FOWStatTotalScope()
+	{
+		if (StartCycles) Total.Add(FPlatformTime::Cycles64() - StartCycles);
+	}
+
+private:
+	FOWStatTotal& Total;
+	uint64 StartCycles;
+};
+
+#define DECLARE_OW_STAT_TOTAL(Name) extern OPENWORLD_API FOWStatTotal GOWTotal_##Name
+#define DEFINE_OW_CYCLE_TOTAL(Name) FOWStatTotal GOWTotal_##Name(TEXT(#Name), true)
+#define DEFINE_OW_COUNTER_TOTAL(Name) FOWStatTotal GOWTotal_##Name(TEXT(#Name), false)
+
+DECLARE_OW_STAT_TOTAL(LockOn);
+DECLARE_OW_STAT_TOTAL(HitTrace);
+DECLARE_OW_STAT_TOTAL(ApplyDamage);
+DECLARE_OW_STAT_TOTAL(Engage);
+DECLARE_OW_STAT_TOTAL(Strafing);
+DECLARE_OW_STAT_TOTAL(UpdateTime);
+DECLARE_OW_STAT_TOTAL(UpdateRain);
+DECLARE_OW_STAT_TOTAL(ChangeLightingValues);
+DECLARE_OW_STAT_TOTAL(AffectsFoliage);
+DECLARE_OW_STAT_TOTAL(NativeUpdateAnimation);
+
+DECLARE_OW_STAT_TOTAL(ActiveAI);
+DECLARE_OW_STAT_TOTAL(LockedPairs);
+DECLARE_OW_STAT_TOTAL(Hits);
+DECLARE_OW_STAT_TOTAL(NiagaraSpawns);
+DECLARE_OW_STAT_TOTAL(DecalSpawns);
+
+/** Stat counter, its run total, plus a named CPU scope on our channel. Name is the part after STAT_OW_ */
+#define OW_SCOPE_CYCLE_COUNTER(Name) \
+	SCOPE_CYCLE_COUNTER(STAT_OW_##Name); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(OW_##Name, OpenWorldChannel); \
+	FOWStatTotalScope OWStatTotalScope_##Name(GOWTotal_##Name)
+
+/** Per frame counter and its run total */
+#define OW_INC_COUNTER(Name) \
+	INC_DWORD_STAT(STAT_OW_##Name); \
+	GOWTotal_##Name.Add(1)
+
+// ===== Telemetry ========== //
+
+/** CSV profiler categories, -csvCategories=OpenWorldAI,OpenWorldPopulation,OpenWorldWeather or csvprofile start */
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(OPENWORLD_API, OpenWorldAI);
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(OPENWORLD_API, OpenWorldPopulation);
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(OPENWORLD_API, OpenWorldWeather);
+
+// ===== Memory ========== //
+
+/** LLM tags, under OpenWorld in stat LLM / LLMFULL, ow.Memory.Dump for a summary. Needs -llm */
+LLM_DECLARE_TAG_API(OpenWorld, OPENWORLD_API);
+LLM_DECLARE_TAG_API(OW_Characters, OPENWORLD_API);
+LLM_DECLARE_TAG_API(OW_AI, OPENWORLD_API);
+LLM_DECLARE_TAG_API(OW_Weapons, OPENWORLD_API);
+LLM_DECLARE_TAG_API(OW_CombatFX, OPENWORLD_API);
+LLM_DECLARE_TAG_API(OW_Environment, OPENWORLD_API);
+LLM_DECLARE_TAG_API(OW_UI, OPENWORLD_API);
+LLM_DECLARE_TAG_API(OW_Terrain, OPENWORLD_API);
@@ -3,6 +3,7 @@
 #include "Animations/HumanCharacterAnimation.h"
 #include "Characters/OWCharacter.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "OpenWorld.h"
 
 // ==================== Lifecycle ==================== //
 
@@ -15,6 +16,8 @@ void UHumanCharacterAnimation::NativeInitializeAnimation()
 
 void UHumanCharacterAnimation::NativeUpdateAnimation(float DeltaTime)
 {
+    OW_SCOPE_CYCLE_COUNTER(NativeUpdateAnimation);
+
     Super::NativeUpdateAnimation(DeltaTime);
 
     UpdateMovements();
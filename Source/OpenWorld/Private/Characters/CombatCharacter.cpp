@@ -3,15 +3,19 @@
 #include "Characters/CombatCharacter.h"
 #include "Characters/PlayerCharacter.h"
 #include "Components/CapsuleComponent.h"
-#include "Components/WidgetComponent.h"
 #include "GameFrameworks/CombatController.h"
+#include "GameFrameworks/OWHUD.h"
 #include "Kismet/GameplayStatics.h"
 #include "NavigationInvokerComponent.h"
+#include "OpenWorld.h"
+#include "Subsystems/CombatAudioSubsystem.h"
+#include "Subsystems/SimulationSubsystem.h"
 #include "Weapons/MeleeWeapon.h"
-#include "Widgets/HealthBar.h"
 
 ACombatCharacter::ACombatCharacter()
 {
+    LLM_SCOPE_BYTAG(OW_Characters);
+
     AutoPossessAI = EAutoPossessAI::PlacedInWorldOrSpawned;
 
     // Combat
@@ -23,20 +27,6 @@ ACombatCharacter::ACombatCharacter()
     GetCapsuleComponent()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Camera, ECollisionResponse::ECR_Ignore);
     GetMesh()            ->SetCollisionResponseToChannel(ECollisionChannel::ECC_Camera, ECollisionResponse::ECR_Ignore);
 
-    // Health Bar
-    HealthBar = CreateDefaultSubobject<UWidgetComponent>(TEXT("Health Bar"));
-    HealthBar->SetupAttachment(RootComponent);
-    HealthBar->SetWidgetSpace(EWidgetSpace::Screen);
-    HealthBar->SetDrawAtDesiredSize(true);
-    HealthBar->SetVisibility(true);
-
-    // Attack Indicator
-    AttackIndicator = CreateDefaultSubobject<UWidgetComponent>(TEXT("Attack Indicator"));
-    AttackIndicator->SetupAttachment(RootComponent);
-    AttackIndicator->SetWidgetSpace(EWidgetSpace::Screen);
-    AttackIndicator->SetDrawAtDesiredSize(true);
-    AttackIndicator->SetVisibility(false);
-
     // Nav Invoker
     NavInvoker = CreateDefaultSubobject<UNavigationInvokerComponent>(TEXT("Navigation Invoker"));
 
@@ -53,16 +43,6 @@ void ACombatCharacter::DefaultInitializer()
 
     AIControllerClass = CombatControllerAsset.Class;
 
-    static ConstructorHelpers::FClassFinder<UUserWidget> HealthBarAsset(
-        TEXT("/Game/Game/Blueprints/Widgets/CombatCharacter/WBP_HealthBar")
-    );
-    HealthBar->SetWidgetClass(HealthBarAsset.Class);
-
-    static ConstructorHelpers::FClassFinder<UUserWidget> AttackIndicatorAsset(
-        TEXT("/Game/Game/Blueprints/Widgets/CombatCharacter/WBP_AttackIndicator")
-    );
-    AttackIndicator->SetWidgetClass(AttackIndicatorAsset.Class);
-
     static ConstructorHelpers::FClassFinder<AMeleeWeapon> AxeAsset(
         TEXT("/Game/Game/Blueprints/Weapons/BP_Axe")
     );
@@ -81,22 +61,16 @@ void ACombatCharacter::DefaultInitializer()
 
 void ACombatCharacter::InitializeUI()
 {
-    HealthBarWidget = Cast<UHealthBar>(HealthBar->GetUserWidgetObject());
-    HealthBarWidget->UpdateHealth(Health / MaxHealth);
-
-    if (Team == ETeam::T_Friend)
-    {
-        HealthBarWidget->SetHealthColor({0.548f, 0.973f, 0.162f, 1.f});
-
-        // Destroy attack indicator as we don't need it
-        AttackIndicator->DestroyComponent();
-    }
+    // The overlay picks its color from our team
+    if (AOWHUD* HUD = GetOWHUD()) HUD->AddCombatant(this, Health / MaxHealth);
 }
 
 // ==================== Lifecycles ==================== //
 
 void ACombatCharacter::BeginPlay()
 {
+    LLM_SCOPE_BYTAG(OW_Characters);
+
     Super::BeginPlay();
 
     RandomizeWeapon();
@@ -115,6 +89,7 @@ void ACombatCharacter::Destroyed()
     Super::Destroyed();
 
     if (EnemyController.IsValid()) EnemyController->Destroy();
+    if (OWHUD.IsValid()) OWHUD->RemoveCombatant(this);
 }
 
 // ==================== Attributes ==================== //
@@ -123,16 +98,31 @@ void ACombatCharacter::Die()
 {
     Super::Die();
 
-    HealthBar->SetVisibility(false);
+    if (AOWHUD* HUD = GetOWHUD())
+    {
+        HUD->RemoveCombatant(this);
+        HUD->HideTips(this);
+    }
+}
+
+// ==================== Streaming ==================== //
+
+void ACombatCharacter::InitializeSpawn(ETeam InTeam, TSubclassOf<AMeleeWeapon> InWeaponClass, float InHealth)
+{
+    Team             = InTeam;
+    SpawnWeaponClass = InWeaponClass;
+    Health           = InHealth > 0.f ? FMath::Min(InHealth, MaxHealth) : MaxHealth;
 }
 
 // ==================== Combat ==================== //
 
 void ACombatCharacter::RandomizeWeapon()
 {
-    int8 RandomWeapon = FMath::RandRange(0, GivenWeaponClasses.Num() - 1);
+    LLM_SCOPE_BYTAG(OW_Weapons);
 
-    CarriedWeapon = GetWorld()->SpawnActor<AMeleeWeapon>(GivenWeaponClasses[RandomWeapon]);
+    int8 RandomWeapon = USimulationSubsystem::GetStream(this, ERandomStream::ERS_Loadout).RandRange(0, GivenWeaponClasses.Num() - 1);
+
+    CarriedWeapon = GetWorld()->SpawnActor<AMeleeWeapon>(SpawnWeaponClass ? SpawnWeaponClass : GivenWeaponClasses[RandomWeapon]);
     CarriedWeapon->Pickup(this, TEXT("Back0 Socket"));
 }
 
@@ -150,7 +140,7 @@ void ACombatCharacter::OnWeaponHit(AOWCharacter* DamagingCharacter, const FVecto
     }
 
     // Update UI
-    HealthBarWidget->UpdateHealth(Health / MaxHealth);
+    if (AOWHUD* HUD = GetOWHUD()) HUD->UpdateHealth(this, Health / MaxHealth);
 }
 
 void ACombatCharacter::AttackCombo()
@@ -160,8 +150,8 @@ void ACombatCharacter::AttackCombo()
     // Give player chance to dodge/block
     if (APlayerCharacter* PlayerCharacter = Cast<APlayerCharacter>(TargetCombat.Get()))
     {
-        AttackIndicator->SetVisibility(true);
-        PlayerCharacter->ShowTip(TEXT("[ALT] / [RMB] - To Dodge / Block"));
+        SetAttackIndicator(true);
+        PlayerCharacter->ShowTip(ETipMessage::ETM_DodgeBlock, this);
     }
 }
 
@@ -173,11 +163,12 @@ void ACombatCharacter::StartChargeAttack()
     if (APlayerCharacter* PlayerCharacter = Cast<APlayerCharacter>(TargetCombat.Get()))
     {
         // Attack Indicator
-        AttackIndicator->SetVisibility(true);
-        PlayerCharacter->ShowTip(TEXT("[ALT] + [WASD] - To dash"));
+        SetAttackIndicator(true);
+        PlayerCharacter->ShowTip(ETipMessage::ETM_Dash, this);
 
         // Slow the time
-        UGameplayStatics::PlaySound2D(this, SlowSFX.LoadSynchronous());
+        if (UCombatAudioSubsystem* CombatAudio = GetWorld()->GetSubsystem<UCombatAudioSubsystem>())
+            CombatAudio->PlaySound2D(SlowSFX.LoadSynchronous());
         UGameplayStatics::SetGlobalTimeDilation(this, .5f);
     }
 }
@@ -190,8 +181,8 @@ void ACombatCharacter::EnableWeapon(bool bEnabled)
     if (!bEnabled)
         if (APlayerCharacter* PlayerCharacter = Cast<APlayerCharacter>(TargetCombat.Get()))
         {
-            AttackIndicator->SetVisibility(false);
-            PlayerCharacter->HideTip();
+            SetAttackIndicator(false);
+            PlayerCharacter->HideTip(this);
 
             UGameplayStatics::SetGlobalTimeDilation(this, 1.f);
         }
@@ -211,3 +202,19 @@ void ACombatCharacter::SetLockOn(AOWCharacter* Target)
     if (!Target) return;
     EnemyController->MoveToLocation(Target->GetActorLocation(), 250.f, false);
 }
+
+// ==================== UI ==================== //
+
+AOWHUD* ACombatCharacter::GetOWHUD()
+{
+    if (!OWHUD.IsValid())
+        if (APlayerController* PlayerController = UGameplayStatics::GetPlayerController(this, 0))
+            OWHUD = Cast<AOWHUD>(PlayerController->GetHUD());
+
+    return OWHUD.Get();
+}
+
+void ACombatCharacter::SetAttackIndicator(bool bVisible)
+{
+    if (AOWHUD* HUD = GetOWHUD()) HUD->SetAttackIndicator(this, bVisible);
+}
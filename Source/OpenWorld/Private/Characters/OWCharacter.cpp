@@ -2,15 +2,20 @@
 
 #include "Characters/OWCharacter.h"
 #include "Components/CapsuleComponent.h"
+#include "Components/CooldownComponent.h"
 #include "Components/SphereComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Kismet/GameplayStatics.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "NiagaraFunctionLibrary.h"
+#include "OpenWorld.h"
+#include "Subsystems/CombatAudioSubsystem.h"
 #include "Weapons/MeleeWeapon.h"
 
 AOWCharacter::AOWCharacter()
 {
+	LLM_SCOPE_BYTAG(OW_Characters);
+
 	PrimaryActorTick.bCanEverTick = true;
 
 	// Pawn
@@ -39,6 +44,9 @@ AOWCharacter::AOWCharacter()
 	KickHitbox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
 	KickHitbox->SetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn, ECollisionResponse::ECR_Overlap);
 
+	// Cooldowns
+	Cooldowns = CreateDefaultSubobject<UCooldownComponent>(TEXT("Cooldowns"));
+
 	// ...
 	DefaultInitializer();
 }
@@ -70,10 +78,30 @@ void AOWCharacter::DefaultInitializer()
 
 void AOWCharacter::BeginPlay()
 {
+	LLM_SCOPE_BYTAG(OW_Characters);
+
 	Super::BeginPlay();
 	
 	// Collision Events
 	KickHitbox->OnComponentBeginOverlap.AddDynamic(this, &ThisClass::OnKick);
+
+	// Cooldowns
+	Cooldowns->Bind(ECooldown::EC_Stun, this, &ThisClass::FinishedStunned);
+	Cooldowns->Bind(ECooldown::EC_ComboOver, this, &ThisClass::ComboOver);
+	Cooldowns->BindLambda(ECooldown::EC_RootMotion, [this]() {
+		GetMesh()->GetAnimInstance()->SetRootMotionMode(ERootMotionMode::RootMotionFromMontagesOnly);
+	});
+	/** First it starts charging, then releases the charge attack */
+	Cooldowns->BindLambda(ECooldown::EC_Charge, [this]() {
+		if (bCharging) Attack();
+		else		   OnChargeAttack();
+	});
+	Cooldowns->BindLambda(ECooldown::EC_Ragdoll, [this]() {
+		GetMesh()->SetCollisionProfileName(TEXT("Ragdoll"));
+		GetMesh()->SetSimulatePhysics(true);
+
+		if (CarriedWeapon.IsValid()) CarriedWeapon->Drop();
+	});
 }
 
 void AOWCharacter::Tick(float DeltaTime)
@@ -81,6 +109,11 @@ void AOWCharacter::Tick(float DeltaTime)
 	Super::Tick(DeltaTime);
 
 	LockOn(DeltaTime);
+
+#if CSV_PROFILER
+	if (FCsvProfiler::Get()->IsCapturing())
+		CSV_CUSTOM_STAT(OpenWorldAI, ActiveTimers, Cooldowns->GetActiveCount(), ECsvCustomStatOp::Accumulate);
+#endif
 }
 
 // ==================== Locomotions ==================== //
@@ -118,9 +151,7 @@ void AOWCharacter::MoveForward()
 	GetCharacterMovement()->AddImpulse(GetActorForwardVector() * 400.f, true);
 
 	// Re-enable it after certain time
-	GetWorldTimerManager().SetTimer(RootMotionTimerHandler, [this]() {
-		GetMesh()->GetAnimInstance()->SetRootMotionMode(ERootMotionMode::RootMotionFromMontagesOnly);
-	}, .5f, false);
+	Cooldowns->Start(ECooldown::EC_RootMotion, .5f);
 }
 
 // ==================== Attributes ==================== //
@@ -135,9 +166,17 @@ void AOWCharacter::Die()
 	if (IsDead()) return;
 
 	CharacterState = ECharacterState::ECS_Died;
+	CSV_CUSTOM_STAT(OpenWorldPopulation, Deaths, 1, ECsvCustomStatOp::Accumulate);
+
+	UE_TRACE_LOG(OpenWorld, CombatDeath, OpenWorldChannel)
+		<< CombatDeath.Cycle(FPlatformTime::Cycles64())
+		<< CombatDeath.Victim(GetUniqueID());
 
 	// Make sure to remove anything left
 	GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Cooldowns->StopAll();
+	if (UCooldownComponent* ControllerCooldowns = GetController()->FindComponentByClass<UCooldownComponent>())
+		ControllerCooldowns->StopAll();
 	GetWorldTimerManager().ClearAllTimersForObject(this);
 	GetWorldTimerManager().ClearAllTimersForObject(GetController());
 	GetController()->UnPossess();
@@ -148,13 +187,7 @@ void AOWCharacter::Die()
 	SetLifeSpan(5.f);
 
 	// Enable rag doll
-	FTimerHandle RagdollTimerHandle;
-	GetWorldTimerManager().SetTimer(RagdollTimerHandle, [this]() {
-		GetMesh()->SetCollisionProfileName(TEXT("Ragdoll"));
-		GetMesh()->SetSimulatePhysics(true);
-
-		if (CarriedWeapon.IsValid()) CarriedWeapon->Drop();
-	}, 1.f, false);
+	Cooldowns->Start(ECooldown::EC_Ragdoll, 1.f);
 }
 
 void AOWCharacter::Stunned()
@@ -164,7 +197,7 @@ void AOWCharacter::Stunned()
 	GetCharacterMovement()->StopMovementImmediately();
 
 	// Un stunned after certain time
-	GetWorldTimerManager().SetTimer(StunTimerHandle, this, &ThisClass::FinishedStunned, 4.5f);
+	Cooldowns->Start(ECooldown::EC_Stun, 4.5f);
 }
 
 void AOWCharacter::FinishedStunned()
@@ -223,6 +256,14 @@ void AOWCharacter::SwapWeapon()
 
 void AOWCharacter::SetLockOn(AOWCharacter* Target)
 {
+	if (TargetCombat.Get() != Target)
+	{
+		UE_TRACE_LOG(OpenWorld, CombatLockOn, OpenWorldChannel)
+			<< CombatLockOn.Cycle(FPlatformTime::Cycles64())
+			<< CombatLockOn.Owner(GetUniqueID())
+			<< CombatLockOn.Target(Target ? Target->GetUniqueID() : 0);
+	}
+
 	TargetCombat = Target;
 
 	// Adjust orient movement to false to make the locking works
@@ -273,8 +314,12 @@ void AOWCharacter::LockNearest()
 
 void AOWCharacter::LockOn(float DeltaTime)
 {
+	OW_SCOPE_CYCLE_COUNTER(LockOn);
+
 	if (!TargetCombat.IsValid() || IsOnMontage("Stunned")) return;
 
+	OW_INC_COUNTER(LockedPairs);
+
 	FRotator CurrentRotation = GetActorRotation();
 	FRotator NewRotation 	 = UKismetMathLibrary::FindLookAtRotation(GetActorLocation(), TargetCombat->GetActorLocation());
 	NewRotation 		     = FMath::RInterpTo(CurrentRotation, NewRotation, DeltaTime, 5.f);
@@ -355,11 +400,12 @@ void AOWCharacter::OnKick(UPrimitiveComponent* OverlappedComponent, AActor* Othe
 	KickHitbox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 
 	// Play audio
-	UGameplayStatics::PlaySoundAtLocation(
-		this,
-		KickingSound.LoadSynchronous(),
-		KickHitbox->GetComponentLocation()
-	);
+	if (UCombatAudioSubsystem* CombatAudio = GetWorld()->GetSubsystem<UCombatAudioSubsystem>())
+		CombatAudio->PlaySoundAtLocation(
+			KickingSound.LoadSynchronous(),
+			ECombatSoundCategory::ECSC_Kick,
+			KickHitbox->GetComponentLocation()
+		);
 }
 
 void AOWCharacter::Attack()
@@ -379,7 +425,7 @@ void AOWCharacter::Attack()
     // Reset
 	DamageMultiplier = 1.f;
 	bCharging        = false;
-	GetWorldTimerManager().ClearTimer(ChargeTimerHandle);
+	Cooldowns->Stop(ECooldown::EC_Charge);
 }
 
 void AOWCharacter::AttackCombo()
@@ -391,12 +437,7 @@ void AOWCharacter::AttackCombo()
 
     // Updating combo, don't forget to update the combo over too
     AttackCount = (AttackCount + 1) % 3;
-    GetWorldTimerManager().SetTimer(
-        ComboOverHandler,
-        this,
-        &ThisClass::ComboOver,
-        ComboOverTimer
-	);
+    Cooldowns->Start(ECooldown::EC_ComboOver, ComboOverTimer);
 }
 
 void AOWCharacter::StartChargeAttack()
@@ -407,11 +448,8 @@ void AOWCharacter::StartChargeAttack()
 	DamageMultiplier += DamageMultiplierRate * GetWorld()->GetDeltaSeconds();
 
 	// Start timer for the first time
-	if (!GetWorldTimerManager().IsTimerActive(ChargeTimerHandle) && !bCharging)
-	{
-		GetWorldTimerManager().ClearTimer(ChargeTimerHandle);
-		GetWorldTimerManager().SetTimer(ChargeTimerHandle, this, &ThisClass::OnChargeAttack, ChargeAfter);
-	}
+	if (!Cooldowns->IsActive(ECooldown::EC_Charge) && !bCharging)
+		Cooldowns->Start(ECooldown::EC_Charge, ChargeAfter);
 }
 
 void AOWCharacter::OnChargeAttack()
@@ -423,8 +461,7 @@ void AOWCharacter::OnChargeAttack()
 	PlayAnimMontage(Montages["Charge Attack"].LoadSynchronous());
 
 	// Start timer to perform actual charge attack
-	GetWorldTimerManager().ClearTimer(ChargeTimerHandle);
-	GetWorldTimerManager().SetTimer(ChargeTimerHandle, this, &ThisClass::Attack, AutoChargeTimer);
+	Cooldowns->Start(ECooldown::EC_Charge, AutoChargeTimer);
 }
 
 void AOWCharacter::ChargeAttack()
@@ -440,6 +477,8 @@ void AOWCharacter::ChargeAttack()
 
 void AOWCharacter::OnWeaponHit(AOWCharacter* DamagingCharacter, const FVector& ImpactPoint, const float GivenDamage, bool bBlockable)
 {
+	LLM_SCOPE_BYTAG(OW_CombatFX);
+
 	if (IsDead()) return;
 
 	// Hit React
@@ -457,6 +496,7 @@ void AOWCharacter::OnWeaponHit(AOWCharacter* DamagingCharacter, const FVector& I
 		{
 			// Show hit visualization
 			UNiagaraFunctionLibrary::SpawnSystemAtLocation(this, BloodSplash.LoadSynchronous(), ImpactPoint);
+			OW_INC_COUNTER(NiagaraSpawns);
 
 			// Reduce health
 			SetHealth(-GivenDamage);
@@ -465,11 +505,12 @@ void AOWCharacter::OnWeaponHit(AOWCharacter* DamagingCharacter, const FVector& I
 
 	// Sound (Blocking or hitflesh sound)
 	if (GivenDamage > 0.f)
-		UGameplayStatics::PlaySoundAtLocation(
-			this, 
-			bSucceedBlocking ? BlockingSound.LoadSynchronous() : HitfleshSound.LoadSynchronous(), 
-			ImpactPoint
-		);
+		if (UCombatAudioSubsystem* CombatAudio = GetWorld()->GetSubsystem<UCombatAudioSubsystem>())
+			CombatAudio->PlaySoundAtLocation(
+				bSucceedBlocking ? BlockingSound.LoadSynchronous() : HitfleshSound.LoadSynchronous(),
+				bSucceedBlocking ? ECombatSoundCategory::ECSC_Block : ECombatSoundCategory::ECSC_Hit,
+				ImpactPoint
+			);
 }
 
 // ==================== Audio ==================== //
@@ -483,10 +524,12 @@ void AOWCharacter::PlayFootstepSound()
 	if (!bCrouching)
 		MakeNoise(1.f, this, CurrentLocation, 500.f);
 
-	if (FootstepSounds.Contains(TEXT("Concrete")))
-		UGameplayStatics::PlaySoundAtLocation(
-			this, 
-			FootstepSounds["Concrete"].LoadSynchronous(), 
+	if (!FootstepSounds.Contains(TEXT("Concrete"))) return;
+
+	if (UCombatAudioSubsystem* CombatAudio = GetWorld()->GetSubsystem<UCombatAudioSubsystem>())
+		CombatAudio->PlaySoundAtLocation(
+			FootstepSounds["Concrete"].LoadSynchronous(),
+			ECombatSoundCategory::ECSC_Footstep,
 			CurrentLocation,
 			bCrouching ? .4f : 1.f,
 			bCrouching ? .8f : 1.f
@@ -4,6 +4,7 @@
 #include "Camera/CameraComponent.h"
 #include "Components/BoxComponent.h"
 #include "Components/CapsuleComponent.h"
+#include "Components/CooldownComponent.h"
 #include "Components/InventoryComponent.h"
 #include "Components/TimelineComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
@@ -12,12 +13,13 @@
 #include "GameFrameworks/OWHUD.h"
 #include "EnhancedInputComponent.h"
 #include "Kismet/GameplayStatics.h"
-#include "Materials/MaterialParameterCollectionInstance.h"
-#include "Materials/MaterialParameterCollection.h"
+#include "OpenWorld.h"
 #include "Weapons/MeleeWeapon.h"
 
 APlayerCharacter::APlayerCharacter()
 {
+	LLM_SCOPE_BYTAG(OW_Characters);
+
 	// Spring Arm
 	SpringArm = CreateDefaultSubobject<USpringArmComponent>(TEXT("Spring Arm"));
 	SpringArm->SetupAttachment(RootComponent);
@@ -107,11 +109,6 @@ void APlayerCharacter::DefaultInitializer()
 	);
 	KickAction = KickActionAsset.Object;
 
-	static ConstructorHelpers::FObjectFinder<UMaterialParameterCollection> GlobalParamAsset(
-		TEXT("/Script/Engine.MaterialParameterCollection'/Game/Game/Materials/MP_Global.MP_Global'")
-	);
-	GlobalMatParam = GlobalParamAsset.Object;
-
 	static ConstructorHelpers::FObjectFinder<UCurveFloat> ParryCurveAsset(
 		TEXT("/Script/Engine.CurveFloat'/Game/Game/Curves/C_ParryCurve.C_ParryCurve'")
 	);
@@ -120,7 +117,15 @@ void APlayerCharacter::DefaultInitializer()
 
 void APlayerCharacter::ReferencesInitializer()
 {
-	GlobalMatParamIns = GetWorld()->GetParameterCollectionInstance(GlobalMatParam.LoadSynchronous());
+	GlobalParams = GetWorld()->GetSubsystem<UGlobalParamSubsystem>();
+
+	if (GlobalParams.IsValid())
+	{
+		// Location changes under a unit are not visible on the foliage
+		CurrentLocationParam = GlobalParams->ResolveVector(TEXT("Player Current Location"), 1.f);
+		LastLocationParam    = GlobalParams->ResolveVector(TEXT("Player Last Location"), 1.f);
+		LastLocation2Param   = GlobalParams->ResolveVector(TEXT("Player Last Location2"), 1.f);
+	}
 }
 
 // ==================== Lifecycles ==================== //
@@ -132,6 +137,8 @@ void APlayerCharacter::OnConstruction(const FTransform& Transform)
 
 void APlayerCharacter::BeginPlay()
 {
+	LLM_SCOPE_BYTAG(OW_Characters);
+
 	Super::BeginPlay();
 
 	ReferencesInitializer();
@@ -286,7 +293,7 @@ void APlayerCharacter::Block(const FInputActionValue& InputValue)
 	ToggleBlock(Value);
 
 	// Start parry timer
-	GetWorldTimerManager().SetTimer(ParryTimerHandle, ParryTimer, false);
+	Cooldowns->Start(ECooldown::EC_Parry, ParryTimer);
 
 	// Make player lock at nearest enemy
 	if (Value && bEquipWeapon) LockNearest();
@@ -355,6 +362,11 @@ void APlayerCharacter::OnWeaponHit(AOWCharacter* DamagingCharacter, const FVecto
 
 // ==================== Parry ==================== //
 
+const bool APlayerCharacter::IsParrySucceed() const
+{
+	return bSucceedBlocking && Cooldowns->IsActive(ECooldown::EC_Parry);
+}
+
 void APlayerCharacter::Parry(AOWCharacter* DamagingCharacter)
 {
 	ParryTimeline    ->PlayFromStart();
@@ -377,7 +389,7 @@ void APlayerCharacter::OnEnterTakedown(UPrimitiveComponent* OverlappedComponent,
 	if (Other && IsEnemy(Other) && OWHUD.IsValid())
 	{
 		TargetTakedown = Other;
-		ShowTip(TEXT("[LMB] - Perform Takedown"));
+		ShowTip(ETipMessage::ETM_Takedown, this);
 	}
 }
 
@@ -387,7 +399,7 @@ void APlayerCharacter::OnLeaveTakedown(UPrimitiveComponent* OverlappedComponent,
 
 	TargetTakedown = nullptr;
 
-	if (OWHUD.IsValid()) HideTip();
+	HideTip(this);
 }
 
 void APlayerCharacter::PerformTakedown()
@@ -405,15 +417,19 @@ void APlayerCharacter::PerformTakedown()
 
 void APlayerCharacter::AffectsFoliage()
 {
+	OW_SCOPE_CYCLE_COUNTER(AffectsFoliage);
+
 	FVector CurrentLocation = GetActorLocation();
 	CurrentLocation.Z -= GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
 
 	LastLocation1 = FMath::Lerp(LastLocation1, CurrentLocation, .05f);
 	LastLocation2 = FMath::Lerp(LastLocation2, CurrentLocation, .03f);
 
-	GlobalMatParamIns->SetVectorParameterValue(TEXT("Player Current Location"), CurrentLocation);
-	GlobalMatParamIns->SetVectorParameterValue(TEXT("Player Last Location"), LastLocation1);
-	GlobalMatParamIns->SetVectorParameterValue(TEXT("Player Last Location2"), LastLocation2);
+	if (!GlobalParams.IsValid()) return;
+
+	GlobalParams->SetVector(CurrentLocationParam, FLinearColor(CurrentLocation));
+	GlobalParams->SetVector(LastLocationParam, FLinearColor(LastLocation1));
+	GlobalParams->SetVector(LastLocation2Param, FLinearColor(LastLocation2));
 }
 
 void APlayerCharacter::Interact()
@@ -425,14 +441,14 @@ void APlayerCharacter::Interact()
 
 // ==================== UI ==================== //
 
-void APlayerCharacter::ShowTip(const FString& Text)
+void APlayerCharacter::ShowTip(ETipMessage Tip, const UObject* Source)
 {
 	if (OWHUD.IsValid())
-		OWHUD->ShowTip(Text);
+		OWHUD->ShowTip(Tip, Source);
 }
 
-void APlayerCharacter::HideTip()
+void APlayerCharacter::HideTip(const UObject* Source)
 {
 	if (OWHUD.IsValid())
-		OWHUD->HideTip();
+		OWHUD->HideTips(Source);
 }
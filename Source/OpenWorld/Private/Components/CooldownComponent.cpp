@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Components/CooldownComponent.h"
+#include "Engine/World.h"
+#include "Subsystems/CooldownSubsystem.h"
+
+UCooldownComponent::UCooldownComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+// ==================== Lifecycles ==================== //
+
+void UCooldownComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (Subsystem.IsValid()) Subsystem->Unregister(Handle);
+
+	Subsystem.Reset();
+	Handle = INDEX_NONE;
+
+	Super::EndPlay(EndPlayReason);
+}
+
+UCooldownSubsystem* UCooldownComponent::GetSubsystem()
+{
+	if (!Subsystem.IsValid())
+	{
+		UWorld* World = GetWorld();
+		Subsystem = World ? World->GetSubsystem<UCooldownSubsystem>() : nullptr;
+
+		if (Subsystem.IsValid()) Handle = Subsystem->Register(this);
+	}
+
+	return Subsystem.Get();
+}
+
+// ==================== Cooldowns ==================== //
+
+void UCooldownComponent::Start(ECooldown Cooldown, float Duration)
+{
+	if (UCooldownSubsystem* Cooldowns = GetSubsystem()) Cooldowns->Start(Handle, Cooldown, Duration);
+}
+
+void UCooldownComponent::Stop(ECooldown Cooldown)
+{
+	if (Subsystem.IsValid()) Subsystem->Stop(Handle, Cooldown);
+}
+
+void UCooldownComponent::StopAll()
+{
+	if (Subsystem.IsValid()) Subsystem->StopAll(Handle);
+}
+
+bool UCooldownComponent::IsActive(ECooldown Cooldown) const
+{
+	return Subsystem.IsValid() && Subsystem->IsActive(Handle, Cooldown);
+}
+
+float UCooldownComponent::GetRemaining(ECooldown Cooldown) const
+{
+	return Subsystem.IsValid() ? Subsystem->GetRemaining(Handle, Cooldown) : 0.f;
+}
+
+int32 UCooldownComponent::GetActiveCount() const
+{
+	return Subsystem.IsValid() ? Subsystem->GetActiveCount(Handle) : 0;
+}
@@ -0,0 +1,432 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Components/InputReplayComponent.h"
+#include "Engine/LocalPlayer.h"
+#include "EnhancedInputComponent.h"
+#include "EnhancedInputSubsystems.h"
+#include "EnhancedPlayerInput.h"
+#include "GameFramework/PlayerController.h"
+#include "InputAction.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Subsystems/SimulationSubsystem.h"
+
+static UInputReplayComponent* FindInputReplay(UWorld* World)
+{
+	APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+
+	return PlayerController ? PlayerController->FindComponentByClass<UInputReplayComponent>() : nullptr;
+}
+
+static FAutoConsoleCommandWithWorldAndArgs InputRecordCommand(
+	TEXT("ow.Input.Record"),
+	TEXT("ow.Input.Record <Name> [Seed=1], start simulation mode and record the player's input until ow.Input.Stop"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (Args.IsEmpty()) return;
+
+		if (UInputReplayComponent* InputReplay = FindInputReplay(World))
+			InputReplay->StartRecording(Args[0], Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 1);
+	})
+);
+
+static FAutoConsoleCommandWithWorldAndArgs InputReplayCommand(
+	TEXT("ow.Input.Replay"),
+	TEXT("ow.Input.Replay <Name> [Quit=0], replay a recording with its seed and log the frame times"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (Args.IsEmpty()) return;
+
+		if (UInputReplayComponent* InputReplay = FindInputReplay(World))
+			InputReplay->StartReplay(Args[0], Args.Num() > 1 && FCString::Atoi(*Args[1]) != 0);
+	})
+);
+
+static FAutoConsoleCommandWithWorld InputStopCommand(
+	TEXT("ow.Input.Stop"),
+	TEXT("Save the current input recording, or abort the replay"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (UInputReplayComponent* InputReplay = FindInputReplay(World)) InputReplay->Stop();
+	})
+);
+
+/** Components a value of that type carries, bool and 1D both take one */
+static int32 GetValueComponents(EInputActionValueType ValueType)
+{
+	switch (ValueType)
+	{
+	case EInputActionValueType::Axis2D: return 2;
+	case EInputActionValueType::Axis3D: return 3;
+	default:                            return 1;
+	}
+}
+
+UInputReplayComponent::UInputReplayComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+
+	// Read what the controller processed this frame, a replay moves before it
+	PrimaryComponentTick.TickGroup = TG_PostPhysics;
+}
+
+// ==================== Lifecycles ==================== //
+
+void UInputReplayComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Whatever was recorded so far is still worth keeping
+	Stop();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+bool UInputReplayComponent::CollectActions()
+{
+	APlayerController* PlayerController = Cast<APlayerController>(GetOwner());
+	APawn* Pawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+	UEnhancedInputComponent* EnhancedInput = Pawn ? Cast<UEnhancedInputComponent>(Pawn->InputComponent) : nullptr;
+
+	if (!EnhancedInput)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Input replay: The player has no pawn with enhanced input"));
+		return false;
+	}
+
+	Actions.Reset();
+
+	for (const TUniquePtr<FEnhancedInputActionEventBinding>& Binding : EnhancedInput->GetActionEventBindings())
+		if (const UInputAction* Action = Binding->GetAction()) Actions.AddUnique(Action);
+
+	// Stable indices between the recording and the replay
+	Actions.Sort([](const UInputAction& A, const UInputAction& B) {
+		return A.GetPathName() < B.GetPathName();
+	});
+
+	if (Actions.Num() > MAX_uint8)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Input replay: %d actions bound, at most %d can be recorded"), Actions.Num(), MAX_uint8);
+		return false;
+	}
+
+	LastValues.Init(FInputActionValue(), Actions.Num());
+
+	return true;
+}
+
+bool UInputReplayComponent::StartSimulation(int32 InSeed, float InFixedRate)
+{
+	USimulationSubsystem* Simulation = GetWorld()->GetSubsystem<USimulationSubsystem>();
+	if (!Simulation) return false;
+
+	Seed      = InSeed;
+	FixedRate = InFixedRate;
+	Frame     = 0;
+
+	Simulation->StartSimulation(Seed, FixedRate);
+
+	return true;
+}
+
+FString UInputReplayComponent::GetRecordingPath(const FString& Name)
+{
+	return FPaths::ProjectSavedDir() / TEXT("InputRecordings") / (Name + TEXT(".owinput"));
+}
+
+void UInputReplayComponent::Stop()
+{
+	if (IsRecording())
+	{
+		SaveRecording();
+	}
+	else if (IsReplaying())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Input replay: %s aborted at frame %u of %u"), *RecordingName, Frame, LastFrame);
+		FinishReplay();
+	}
+}
+
+void UInputReplayComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (IsRecording())
+		RecordFrame();
+	else if (IsReplaying())
+		ReplayFrame();
+
+	++Frame;
+}
+
+// ==================== Recording ==================== //
+
+bool UInputReplayComponent::StartRecording(const FString& Name, int32 InSeed)
+{
+	if (Mode != EMode::None || !CollectActions() || !StartSimulation(InSeed, 30.f)) return false;
+
+	Mode          = EMode::Recording;
+	RecordingName = Name;
+
+	Events.Reset();
+	LastEventFrame = 0;
+
+	SetComponentTickEnabled(true);
+
+	UE_LOG(LogTemp, Display, TEXT("Input replay: Recording %s, %d actions, seed %d"), *Name, Actions.Num(), Seed);
+
+	return true;
+}
+
+void UInputReplayComponent::RecordFrame()
+{
+	APlayerController* PlayerController = Cast<APlayerController>(GetOwner());
+	UEnhancedPlayerInput* PlayerInput = PlayerController ? Cast<UEnhancedPlayerInput>(PlayerController->PlayerInput) : nullptr;
+
+	if (!PlayerInput) return;
+
+	FMemoryWriter Writer(Events, false, true);
+
+	for (int32 Index = 0; Index < Actions.Num(); ++Index)
+	{
+		const FInputActionValue Value = PlayerInput->GetActionValue(Actions[Index]);
+		const FVector Components = Value.Get<FVector>();
+
+		if (Components == LastValues[Index].Get<FVector>()) continue;
+
+		LastValues[Index] = Value;
+
+		uint32 FrameDelta = Frame - LastEventFrame;
+		uint8 ActionIndex = Index;
+
+		Writer.SerializeIntPacked(FrameDelta);
+		Writer << ActionIndex;
+
+		for (int32 Component = 0; Component < GetValueComponents(Actions[Index]->ValueType); ++Component)
+		{
+			float ComponentValue = Components[Component];
+			Writer << ComponentValue;
+		}
+
+		LastEventFrame = Frame;
+	}
+}
+
+bool UInputReplayComponent::SaveRecording()
+{
+	Mode = EMode::None;
+	SetComponentTickEnabled(false);
+
+	if (USimulationSubsystem* Simulation = GetWorld()->GetSubsystem<USimulationSubsystem>()) Simulation->StopSimulation();
+
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes, true);
+
+	uint32 FileMagic   = Magic;
+	uint32 FileVersion = Version;
+	uint32 FrameCount  = Frame;
+	int32 ActionCount  = Actions.Num();
+
+	Writer << FileMagic << FileVersion << Seed << FixedRate << FrameCount << ActionCount;
+
+	// The events are decoded with the recorded type, the binding may change afterwards
+	for (const UInputAction* Action : Actions)
+	{
+		FString ActionPath = Action->GetPathName();
+		uint8 ValueType    = (uint8)Action->ValueType;
+		Writer << ActionPath << ValueType;
+	}
+
+	Writer.Serialize(Events.GetData(), Events.Num());
+
+	const FString Path = GetRecordingPath(RecordingName);
+
+	if (!FFileHelper::SaveArrayToFile(Bytes, *Path))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Input replay: Failed to write %s"), *Path);
+		return false;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Input replay: Saved %s, %u frames in %d bytes"), *Path, FrameCount, Bytes.Num());
+
+	return true;
+}
+
+// ==================== Replaying ==================== //
+
+bool UInputReplayComponent::StartReplay(const FString& Name, bool bInQuitWhenDone)
+{
+	if (Mode != EMode::None || !CollectActions()) return false;
+
+	const FString Path = GetRecordingPath(Name);
+	if (!LoadRecording(Path) || !StartSimulation(Seed, FixedRate)) return false;
+
+	Mode          = EMode::Replaying;
+	RecordingName = Name;
+	NextEvent     = 0;
+	bQuitWhenDone = bInQuitWhenDone;
+
+	LastFrameTime = 0.0;
+	FrameTimes.Reset(LastFrame);
+
+	SetInjectBeforeInput(true);
+	SetComponentTickEnabled(true);
+
+	UE_LOG(LogTemp, Display, TEXT("Input replay: Replaying %s, %u frames, seed %d"), *Name, LastFrame, Seed);
+
+	return true;
+}
+
+bool UInputReplayComponent::LoadRecording(const FString& Path)
+{
+	TArray<uint8> Bytes;
+
+	if (!FFileHelper::LoadFileToArray(Bytes, *Path))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Input replay: Can't read %s"), *Path);
+		return false;
+	}
+
+	FMemoryReader Reader(Bytes, true);
+
+	uint32 FileMagic   = 0;
+	uint32 FileVersion = 0;
+	int32 ActionCount  = 0;
+
+	Reader << FileMagic << FileVersion << Seed << FixedRate << LastFrame << ActionCount;
+
+	if (FileMagic != Magic || FileVersion != Version || ActionCount < 0 || ActionCount > MAX_uint8)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Input replay: %s isn't a recording of this version"), *Path);
+		return false;
+	}
+
+	// Map the recorded actions onto what the pawn binds now
+	TArray<int32> ActionRemap;
+	TArray<EInputActionValueType> RecordedTypes;
+
+	for (int32 Index = 0; Index < ActionCount; ++Index)
+	{
+		FString ActionPath;
+		uint8 ValueType = 0;
+		Reader << ActionPath << ValueType;
+
+		RecordedTypes.Add((EInputActionValueType)ValueType);
+
+		const int32 Current = Actions.IndexOfByPredicate([&ActionPath](const UInputAction* Action) {
+			return Action->GetPathName() == ActionPath;
+		});
+
+		if (Current == INDEX_NONE) UE_LOG(LogTemp, Warning, TEXT("Input replay: %s is no longer bound, skipped"), *ActionPath);
+
+		ActionRemap.Add(Current);
+	}
+
+	ReplayEvents.Reset();
+	uint32 EventFrame = 0;
+
+	while (!Reader.AtEnd() && !Reader.IsError())
+	{
+		uint32 FrameDelta;
+		uint8 ActionIndex;
+
+		Reader.SerializeIntPacked(FrameDelta);
+		Reader << ActionIndex;
+
+		if (ActionIndex >= ActionRemap.Num())
+		{
+			UE_LOG(LogTemp, Error, TEXT("Input replay: %s is corrupted"), *Path);
+			return false;
+		}
+
+		EventFrame += FrameDelta;
+
+		const int32 Current = ActionRemap[ActionIndex];
+
+		// The value is stored with the type it was recorded with, even when the action is gone or changed since
+		FVector Components = FVector::ZeroVector;
+
+		for (int32 Component = 0; Component < GetValueComponents(RecordedTypes[ActionIndex]); ++Component)
+		{
+			float ComponentValue;
+			Reader << ComponentValue;
+			Components[Component] = ComponentValue;
+		}
+
+		if (Current != INDEX_NONE) ReplayEvents.Add({ EventFrame, (uint8)Current, FInputActionValue(Actions[Current]->ValueType, Components) });
+	}
+
+	return !Reader.IsError();
+}
+
+void UInputReplayComponent::SetInjectBeforeInput(bool bBefore)
+{
+	SetTickGroup(bBefore ? TG_PrePhysics : TG_PostPhysics);
+
+	APlayerController* PlayerController = Cast<APlayerController>(GetOwner());
+	if (!PlayerController) return;
+
+	// The controller processes its input in its own tick
+	if (bBefore) PlayerController->PrimaryActorTick.AddPrerequisite(this, PrimaryComponentTick);
+	else		 PlayerController->PrimaryActorTick.RemovePrerequisite(this, PrimaryComponentTick);
+}
+
+void UInputReplayComponent::ReplayFrame()
+{
+	const double Now = FPlatformTime::Seconds();
+
+	if (LastFrameTime > 0.0) FrameTimes.Add((Now - LastFrameTime) * 1000.0);
+	LastFrameTime = Now;
+
+	APlayerController* PlayerController = Cast<APlayerController>(GetOwner());
+	UEnhancedInputLocalPlayerSubsystem* EnhancedInput = PlayerController ? ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(PlayerController->GetLocalPlayer()) : nullptr;
+
+	if (!EnhancedInput || Frame >= LastFrame)
+	{
+		FinishReplay();
+		return;
+	}
+
+	// A held value keeps being injected by the subsystem until it changes
+	for (; NextEvent < ReplayEvents.Num() && ReplayEvents[NextEvent].Frame <= Frame; ++NextEvent)
+	{
+		const FReplayEvent& Event = ReplayEvents[NextEvent];
+		const UInputAction* Action = Actions[Event.Action];
+
+		if (Event.Value.IsNonZero()) EnhancedInput->StartContinuousInputInjectionForAction(Action, Event.Value, {}, {});
+		else EnhancedInput->StopContinuousInputInjectionForAction(Action);
+	}
+}
+
+void UInputReplayComponent::FinishReplay()
+{
+	Mode = EMode::None;
+	SetComponentTickEnabled(false);
+	SetInjectBeforeInput(false);
+
+	APlayerController* PlayerController = Cast<APlayerController>(GetOwner());
+
+	if (UEnhancedInputLocalPlayerSubsystem* EnhancedInput = PlayerController ? ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(PlayerController->GetLocalPlayer()) : nullptr)
+		for (const UInputAction* Action : Actions) EnhancedInput->StopContinuousInputInjectionForAction(Action);
+
+	if (USimulationSubsystem* Simulation = GetWorld()->GetSubsystem<USimulationSubsystem>()) Simulation->StopSimulation();
+
+	float AverageFrameTime = 0.f;
+	float P99FrameTime     = 0.f;
+
+	if (!FrameTimes.IsEmpty())
+	{
+		double Total = 0.0;
+		for (const float FrameTime : FrameTimes) Total += FrameTime;
+
+		AverageFrameTime = Total / FrameTimes.Num();
+
+		FrameTimes.Sort();
+		P99FrameTime = FrameTimes[FMath::Min(FMath::FloorToInt32(FrameTimes.Num() * .99f), FrameTimes.Num() - 1)];
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Input replay: %s done, %d frames: %.3fms average, %.3fms p99"), *RecordingName, FrameTimes.Num(), AverageFrameTime, P99FrameTime);
+
+	if (bQuitWhenDone) FPlatformMisc::RequestExit(false);
+}
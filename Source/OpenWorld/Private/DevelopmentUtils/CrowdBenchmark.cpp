@@ -0,0 +1,294 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "DevelopmentUtils/CrowdBenchmark.h"
+#include "Characters/CombatCharacter.h"
+#include "EngineUtils.h"
+#include "HAL/FileManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "OpenWorld.h"
+#include "Subsystems/GroundHeightSubsystem.h"
+#include "Subsystems/SimulationSubsystem.h"
+#include "Weapons/MeleeWeapon.h"
+
+static FAutoConsoleCommandWithWorldAndArgs CrowdBenchmarkCommand(
+	TEXT("ow.Combat.CrowdBenchmark"),
+	TEXT("ow.Combat.CrowdBenchmark [Friends=25] [Enemies=25] [Duration=30] [Seed=1] [Quit=0], let two teams fight for Duration simulated seconds and log the frame times"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (!World) return;
+
+		// One at a time, the numbers would be meaningless otherwise
+		for (TActorIterator<ACrowdBenchmark> It(World); It; ++It) return;
+
+		const int32 Friends   = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 25;
+		const int32 Enemies   = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 25;
+		const float Duration  = Args.Num() > 2 ? FCString::Atof(*Args[2]) : 30.f;
+		const int32 Seed      = Args.Num() > 3 ? FCString::Atoi(*Args[3]) : 1;
+		const bool bQuit      = Args.Num() > 4 && FCString::Atoi(*Args[4]) != 0;
+
+		if (ACrowdBenchmark* Benchmark = World->SpawnActor<ACrowdBenchmark>())
+			Benchmark->Run(FMath::Max(Friends, 0), FMath::Max(Enemies, 0), FMath::Max(Duration, 1.f), Seed, bQuit);
+	})
+);
+
+ACrowdBenchmark::ACrowdBenchmark()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+
+	// Measure the whole frame, after everyone else ticked
+	PrimaryActorTick.TickGroup = TG_PostUpdateWork;
+}
+
+// ==================== Lifecycles ==================== //
+
+void ACrowdBenchmark::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	Super::EndPlay(EndPlayReason);
+
+	// Leaving the map mid run, the timestep must not stay fixed
+	if (bRunning)
+	{
+		if (USimulationSubsystem* Simulation = GetWorld()->GetSubsystem<USimulationSubsystem>()) Simulation->StopSimulation();
+		FOWStatTotal::StopCollecting();
+		bRunning = false;
+	}
+}
+
+// ==================== Running ==================== //
+
+void ACrowdBenchmark::Run(int32 InFriends, int32 InEnemies, float InDuration, int32 InSeed, bool bInQuitWhenDone)
+{
+	Friends       = InFriends;
+	Enemies       = InEnemies;
+	Duration      = InDuration;
+	Seed          = InSeed;
+	bQuitWhenDone = bInQuitWhenDone;
+
+	UClass* FriendClass = LoadClass<ACombatCharacter>(nullptr, TEXT("/Game/Game/Blueprints/Characters/BP_FriendCharacter.BP_FriendCharacter_C"));
+	UClass* EnemyClass  = LoadClass<ACombatCharacter>(nullptr, TEXT("/Game/Game/Blueprints/Characters/BP_EnemyCharacter.BP_EnemyCharacter_C"));
+
+	if (!EnemyClass)  EnemyClass  = ACombatCharacter::StaticClass();
+	if (!FriendClass) FriendClass = EnemyClass;
+
+	// Same seed, same weapons, same decisions, and simulated time doesn't depend on how fast the machine is
+	if (USimulationSubsystem* Simulation = GetWorld()->GetSubsystem<USimulationSubsystem>()) Simulation->StartSimulation(Seed, 1.f / FixedDeltaTime);
+
+	// Around the player so it can be watched when not headless, the map should be flat
+	APawn* PlayerPawn = UGameplayStatics::GetPlayerPawn(this, 0);
+	const FVector Center = PlayerPawn ? PlayerPawn->GetActorLocation() : FVector::ZeroVector;
+
+	SpawnTeam(FriendClass, ETeam::T_Friend, Friends, Center, -1.f);
+	SpawnTeam(EnemyClass, ETeam::T_Enemy, Enemies, Center, 1.f);
+
+	FrameTimes.Reset(FMath::CeilToInt32(Duration / FixedDeltaTime) + 1);
+	GameThreadTime   = 0.0;
+	RenderThreadTime = 0.0;
+	SimulatedTime    = 0.f;
+	LastFrameTime    = 0.0;
+
+	StartUsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+	FOWStatTotal::StartCollecting();
+
+#if STATS
+	// Every counter of the run, open it with the session frontend or Insights
+	GEngine->Exec(GetWorld(), TEXT("stat startfile"));
+#endif
+
+	bRunning = true;
+	SetActorTickEnabled(true);
+
+	UE_LOG(LogTemp, Display, TEXT("Crowd benchmark, %d friends vs %d enemies for %.0fs, seed %d"), Friends, Enemies, Duration, Seed);
+}
+
+void ACrowdBenchmark::SpawnTeam(UClass* CombatantClass, ETeam InTeam, int32 Count, const FVector& Center, float Side)
+{
+	UGroundHeightSubsystem* GroundHeights = GetWorld()->GetSubsystem<UGroundHeightSubsystem>();
+
+	// A block facing the other team
+	const int32 Columns = FMath::Max(FMath::CeilToInt32(FMath::Sqrt((float)Count)), 1);
+	const FRotator Facing(0.f, Side > 0.f ? 180.f : 0.f, 0.f);
+
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		FVector Location = Center + FVector(
+			Side * (FrontDistance * .5f + Index / Columns * Spacing),
+			(Index % Columns - (Columns - 1) * .5f) * Spacing,
+			0.f
+		);
+
+		float GroundHeight;
+		if (GroundHeights && GroundHeights->GetGroundHeight(FVector2D(Location), GroundHeight)) Location.Z = GroundHeight + 100.f;
+
+		const FTransform Transform(Facing, Location);
+
+		ACombatCharacter* Combatant = GetWorld()->SpawnActorDeferred<ACombatCharacter>(CombatantClass, Transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
+		if (!Combatant) continue;
+
+		Combatant->InitializeSpawn(InTeam, nullptr, 0.f);
+		Combatant->FinishSpawning(Transform);
+
+		Combatants.Add(Combatant);
+	}
+}
+
+void ACrowdBenchmark::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!bRunning) return;
+
+	const double Now = FPlatformTime::Seconds();
+
+	// The first frame still carries the spawning
+	if (LastFrameTime > 0.0)
+	{
+		FrameTimes.Add((Now - LastFrameTime) * 1000.0);
+		GameThreadTime   += FPlatformTime::ToMilliseconds(GGameThreadTime);
+		RenderThreadTime += FPlatformTime::ToMilliseconds(GRenderThreadTime);
+	}
+
+	LastFrameTime  = Now;
+	SimulatedTime += DeltaTime;
+
+	if (SimulatedTime >= Duration) Finish();
+}
+
+// ==================== Results ==================== //
+
+void ACrowdBenchmark::Finish()
+{
+	bRunning = false;
+	SetActorTickEnabled(false);
+
+	if (USimulationSubsystem* Simulation = GetWorld()->GetSubsystem<USimulationSubsystem>()) Simulation->StopSimulation();
+	FOWStatTotal::StopCollecting();
+
+#if STATS
+	GEngine->Exec(GetWorld(), TEXT("stat stopfile"));
+#endif
+
+	// Signed, memory may have been released during the run
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+	const double UsedMB     = ((double)MemoryStats.UsedPhysical - (double)StartUsedPhysical) / (1024.0 * 1024.0);
+	const double PeakUsedMB = (double)MemoryStats.PeakUsedPhysical / (1024.0 * 1024.0);
+
+	float AverageFrameTime = 0.f;
+	float P99FrameTime     = 0.f;
+
+	if (!FrameTimes.IsEmpty())
+	{
+		double Total = 0.0;
+		for (const float FrameTime : FrameTimes) Total += FrameTime;
+
+		AverageFrameTime = Total / FrameTimes.Num();
+
+		FrameTimes.Sort();
+		P99FrameTime = FrameTimes[FMath::Min(FMath::FloorToInt32(FrameTimes.Num() * .99f), FrameTimes.Num() - 1)];
+	}
+
+	int32 FriendsAlive = 0;
+	int32 EnemiesAlive = 0;
+
+	for (const TWeakObjectPtr<ACombatCharacter>& Combatant : Combatants)
+	{
+		if (!Combatant.IsValid() || Combatant->IsDead()) continue;
+
+		if (Combatant->GetTeam() == ETeam::T_Friend) ++FriendsAlive;
+		else ++EnemiesAlive;
+	}
+
+	const int32 Frames = FMath::Max(FrameTimes.Num(), 1);
+
+	UE_LOG(LogTemp, Display, TEXT("Crowd benchmark, %d frames: %.3fms average, %.3fms p99 (game %.3fms, render %.3fms), %d/%d friends and %d/%d enemies alive, %+.1fMB used, %.1fMB peak"),
+		FrameTimes.Num(),
+		AverageFrameTime,
+		P99FrameTime,
+		GameThreadTime / Frames,
+		RenderThreadTime / Frames,
+		FriendsAlive, Friends,
+		EnemiesAlive, Enemies,
+		UsedMB,
+		PeakUsedMB
+	);
+
+	for (const FOWStatTotal* Total : FOWStatTotal::GetAll())
+	{
+		if (Total->bCycles)
+			UE_LOG(LogTemp, Display, TEXT("  %-24s %10.3fms total, %.3fms per frame"), Total->Name, FPlatformTime::ToMilliseconds64(Total->Value.load()), FPlatformTime::ToMilliseconds64(Total->Value.load()) / Frames);
+		else
+			UE_LOG(LogTemp, Display, TEXT("  %-24s %10lld total, %.1f per frame"), Total->Name, Total->Value.load(), (double)Total->Value.load() / Frames);
+	}
+
+	WriteResults(AverageFrameTime, P99FrameTime, FriendsAlive, EnemiesAlive, UsedMB, PeakUsedMB);
+	Cleanup();
+
+	if (bQuitWhenDone) FPlatformMisc::RequestExit(false);
+	else Destroy();
+}
+
+void ACrowdBenchmark::WriteResults(float AverageFrameTime, float P99FrameTime, int32 FriendsAlive, int32 EnemiesAlive, double UsedMB, double PeakUsedMB) const
+{
+	const FString Path = FPaths::ProjectSavedDir() / TEXT("Benchmarks/CrowdBenchmark.csv");
+	const int32 Frames = FMath::Max(FrameTimes.Num(), 1);
+
+	// Stat totals per run, cycle stats in milliseconds
+	FString Header = TEXT("Date,Friends,Enemies,Duration,Seed,Frames,AverageMs,P99Ms,GameThreadMs,RenderThreadMs,FriendsAlive,EnemiesAlive,UsedMB,PeakUsedMB");
+	FString Totals;
+
+	for (const FOWStatTotal* Total : FOWStatTotal::GetAll())
+	{
+		Header += FString::Printf(TEXT(",%s%s"), Total->Name, Total->bCycles ? TEXT("Ms") : TEXT(""));
+		Totals += Total->bCycles ? FString::Printf(TEXT(",%.3f"), FPlatformTime::ToMilliseconds64(Total->Value.load())) : FString::Printf(TEXT(",%lld"), Total->Value.load());
+	}
+
+	// One row per run, the header only once. A file with other columns is moved aside rather than mixed
+	FString Lines;
+	TArray<FString> Existing;
+
+	if (FFileHelper::LoadFileToStringArray(Existing, *Path) && (Existing.IsEmpty() || Existing[0] != Header))
+	{
+		const FString OldPath = FPaths::ProjectSavedDir() / FString::Printf(TEXT("Benchmarks/CrowdBenchmark-%s.csv"), *FDateTime::Now().ToString());
+		IFileManager::Get().Move(*OldPath, *Path);
+		UE_LOG(LogTemp, Warning, TEXT("Crowd benchmark: %s had other columns, moved to %s"), *Path, *OldPath);
+	}
+
+	if (!FPaths::FileExists(Path)) Lines += Header + TEXT("\n");
+
+	Lines += FString::Printf(TEXT("%s,%d,%d,%.1f,%d,%d,%.3f,%.3f,%.3f,%.3f,%d,%d,%.1f,%.1f%s\n"),
+		*FDateTime::Now().ToString(),
+		Friends,
+		Enemies,
+		Duration,
+		Seed,
+		FrameTimes.Num(),
+		AverageFrameTime,
+		P99FrameTime,
+		GameThreadTime / Frames,
+		RenderThreadTime / Frames,
+		FriendsAlive,
+		EnemiesAlive,
+		UsedMB,
+		PeakUsedMB,
+		*Totals
+	);
+
+	if (!FFileHelper::SaveStringToFile(Lines, *Path, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM, &IFileManager::Get(), FILEWRITE_Append))
+		UE_LOG(LogTemp, Error, TEXT("Crowd benchmark: Failed to write %s"), *Path);
+}
+
+void ACrowdBenchmark::Cleanup()
+{
+	for (const TWeakObjectPtr<ACombatCharacter>& Combatant : Combatants)
+	{
+		if (!Combatant.IsValid()) continue;
+
+		if (AActor* Weapon = Combatant->GetCarriedWeapon()) Weapon->Destroy();
+
+		Combatant->Destroy();
+	}
+
+	Combatants.Empty();
+}
@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "DevelopmentUtils/HeightmapEncodeCommandlet.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Terrain/HeightmapR16.h"
+#include "Terrain/HeightmapTiled.h"
+
+UHeightmapEncodeCommandlet::UHeightmapEncodeCommandlet()
+{
+	IsClient       = false;
+	IsServer       = false;
+	IsEditor       = false;
+	LogToConsole   = true;
+	ShowErrorCount = true;
+}
+
+int32 UHeightmapEncodeCommandlet::Main(const FString& Params)
+{
+	// Arguments
+	FString Input;
+	FString Output;
+	int32 TileSize = 64;
+	int32 MaxError = 0;
+	int32 Width = 0;
+
+	if (!FParse::Value(*Params, TEXT("Input="), Input))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Usage: -run=HeightmapEncode -Input=<File.r16> [-Output=<File.owh>] [-TileSize=64] [-MaxError=0] [-Width=0]"));
+		return 1;
+	}
+
+	FParse::Value(*Params, TEXT("Output="), Output);
+	FParse::Value(*Params, TEXT("TileSize="), TileSize);
+	FParse::Value(*Params, TEXT("MaxError="), MaxError);
+	FParse::Value(*Params, TEXT("Width="), Width);
+
+	if (FPaths::IsRelative(Input)) Input = FPaths::Combine(FPaths::ProjectDir(), Input);
+	if (Output.IsEmpty()) Output = FPaths::ChangeExtension(Input, TEXT("owh"));
+	else if (FPaths::IsRelative(Output)) Output = FPaths::Combine(FPaths::ProjectDir(), Output);
+
+	FHeightmapR16 Heightmap;
+	if (!Heightmap.Open(Input, Width)) return 1;
+
+	// Encode
+	FHeightmapEncodeStats Stats;
+
+	if (!FHeightmapTiled::Encode(Heightmap, Output, TileSize, MaxError, &Stats))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to encode %s"), *Input);
+		return 1;
+	}
+
+	// Raw read, what loading the terrain costs today
+	double StartTime = FPlatformTime::Seconds();
+
+	TArray64<uint8> RawBytes;
+	FFileHelper::LoadFileToArray(RawBytes, *Input);
+
+	const double RawReadTime = FPlatformTime::Seconds() - StartTime;
+
+	// Full decode, checked against the source
+	FHeightmapTiled Tiled;
+	if (!Tiled.Open(Output)) return 1;
+
+	TArray<uint16> Decoded;
+	StartTime = FPlatformTime::Seconds();
+
+	if (!Tiled.DecodeAll(Decoded))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to decode %s"), *Output);
+		return 1;
+	}
+
+	const double DecodeTime = FPlatformTime::Seconds() - StartTime;
+
+	int32 WorstError = 0;
+	for (int32 Index = 0; Index < Decoded.Num(); ++Index)
+		WorstError = FMath::Max(WorstError, FMath::Abs(Decoded[Index] - Heightmap.GetData()[Index]));
+
+	// Streaming, a 512 sample window walking across the map like a player would
+	const int32 Window = FMath::Min(512, FMath::Min(Tiled.GetWidth(), Tiled.GetHeight()));
+	const int32 Steps = 256;
+
+	int32 StreamedTiles = 0;
+	int32 StreamErrors = 0;
+
+	StartTime = FPlatformTime::Seconds();
+
+	for (int32 Step = 0; Step < Steps; ++Step)
+	{
+		const float Alpha = (float)Step / (Steps - 1);
+		const FIntPoint Min(FMath::RoundToInt32(Alpha * (Tiled.GetWidth() - Window)), FMath::RoundToInt32(Alpha * (Tiled.GetHeight() - Window)));
+
+		StreamedTiles += Tiled.Stream(FIntRect(Min, Min + FIntPoint(Window)));
+
+		// Spot check the window through the streamed tiles
+		uint16 Raw;
+		const FIntPoint Center = Min + FIntPoint(Window / 2);
+
+		if (!Tiled.GetRaw(Center.X, Center.Y, Raw) || FMath::Abs(Raw - Heightmap.GetRaw(Center.X, Center.Y)) > MaxError) ++StreamErrors;
+	}
+
+	const double StreamTime = FPlatformTime::Seconds() - StartTime;
+	const double RawMB = Stats.RawBytes / (1024.0 * 1024.0);
+
+	UE_LOG(LogTemp, Display, TEXT("Encoded %s (%dx%d) -> %s, tiles of %d, max error %d"), *Input, Heightmap.GetWidth(), Heightmap.GetHeight(), *Output, TileSize, MaxError);
+	UE_LOG(LogTemp, Display, TEXT("Size: raw %.2fMB, tiled %.2fMB (%.1f%%)"), RawMB, Stats.EncodedBytes / (1024.0 * 1024.0), 100.0 * Stats.EncodedBytes / FMath::Max<int64>(Stats.RawBytes, 1));
+	UE_LOG(LogTemp, Display, TEXT("Throughput: encode %.1fMB/s, decode %.1fMB/s, raw read %.1fMB/s"), RawMB / FMath::Max(Stats.Seconds, 1e-6), RawMB / FMath::Max(DecodeTime, 1e-6), RawMB / FMath::Max(RawReadTime, 1e-6));
+	UE_LOG(LogTemp, Display, TEXT("Streaming: %d windows of %d in %.1fms, %d tiles loaded, %d resident at the end"), Steps, Window, StreamTime * 1000.0, StreamedTiles, Tiled.GetLoadedTileCount());
+
+	if (WorstError > MaxError || StreamErrors > 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Round trip failed: worst error %d (allowed %d), %d streamed samples off"), WorstError, MaxError, StreamErrors);
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Round trip ok, worst error %d"), WorstError);
+
+	return 0;
+}
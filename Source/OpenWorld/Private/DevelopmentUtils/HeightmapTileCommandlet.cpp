@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "DevelopmentUtils/HeightmapTileCommandlet.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Terrain/HeightmapR16.h"
+
+UHeightmapTileCommandlet::UHeightmapTileCommandlet()
+{
+	IsClient       = false;
+	IsServer       = false;
+	IsEditor       = false;
+	LogToConsole   = true;
+	ShowErrorCount = true;
+}
+
+int32 UHeightmapTileCommandlet::Main(const FString& Params)
+{
+	// Arguments
+	FString Input;
+	FString Output;
+	int32 TileSize = 505;
+	int32 Width = 0;
+
+	if (!FParse::Value(*Params, TEXT("Input="), Input))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Usage: -run=HeightmapTile -Input=<File.r16> [-Output=<Dir>] [-TileSize=505] [-Width=0]"));
+		return 1;
+	}
+
+	FParse::Value(*Params, TEXT("Output="), Output);
+	FParse::Value(*Params, TEXT("TileSize="), TileSize);
+	FParse::Value(*Params, TEXT("Width="), Width);
+
+	if (FPaths::IsRelative(Input)) Input = FPaths::Combine(FPaths::ProjectDir(), Input);
+	if (Output.IsEmpty()) Output = FPaths::Combine(FPaths::GetPath(Input), FPaths::GetBaseFilename(Input) + TEXT("_Tiles"));
+
+	if (TileSize < 2)
+	{
+		UE_LOG(LogTemp, Error, TEXT("TileSize must be at least 2"));
+		return 1;
+	}
+
+	// Source, mapped so only the rows being sliced are paged in
+	const double StartTime = FPlatformTime::Seconds();
+
+	FHeightmapR16 Heightmap;
+	if (!Heightmap.Open(Input, Width)) return 1;
+
+	IFileManager::Get().MakeDirectory(*Output, true);
+
+	const TArray<FHeightmapView> Tiles = Heightmap.GetTiles(TileSize);
+	const int32 TilesX = FMath::Max(FMath::DivideAndRoundUp(Heightmap.GetWidth() - 1, TileSize - 1), 1);
+	const FString Name = FPaths::GetBaseFilename(Input);
+
+	std::atomic<int32> Failed = 0;
+
+	ParallelFor(Tiles.Num(), [&](int32 Index)
+	{
+		const FHeightmapView& Tile = Tiles[Index];
+
+		// Every tile must have the same size for the import, the ones on the far edges repeat the last sample
+		TArray<uint16> Samples;
+		Samples.SetNumUninitialized(TileSize * TileSize);
+
+		for (int32 Y = 0; Y < TileSize; ++Y)
+			for (int32 X = 0; X < TileSize; ++X)
+				Samples[Y * TileSize + X] = Tile.GetRaw(X, Y);
+
+		const FString TilePath = FPaths::Combine(Output, FString::Printf(TEXT("%s_x%d_y%d.r16"), *Name, Index % TilesX, Index / TilesX));
+		const TArrayView<const uint8> Bytes(reinterpret_cast<const uint8*>(Samples.GetData()), Samples.Num() * sizeof(uint16));
+
+		if (!FFileHelper::SaveArrayToFile(Bytes, *TilePath))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Failed to write %s"), *TilePath);
+			++Failed;
+		}
+	});
+
+	UE_LOG(LogTemp, Display, TEXT("Sliced %s (%dx%d, %s) into %d tiles of %d in %.2fs -> %s"),
+		*Input,
+		Heightmap.GetWidth(),
+		Heightmap.GetHeight(),
+		Heightmap.IsMapped() ? TEXT("mapped") : TEXT("loaded"),
+		Tiles.Num(),
+		TileSize,
+		FPlatformTime::Seconds() - StartTime,
+		*Output
+	);
+
+	return Failed.load() == 0 ? 0 : 1;
+}
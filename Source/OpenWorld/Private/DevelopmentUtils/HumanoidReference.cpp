@@ -1,7 +1,13 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "DevelopmentUtils/HumanoidReference.h"
+#include "Async/ParallelFor.h"
 #include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "LandscapeHeightfieldCollisionComponent.h"
+#include "Misc/ScopedSlowTask.h"
+#include "Subsystems/GroundHeightSubsystem.h"
 
 AHumanoidReference::AHumanoidReference()
 {
@@ -21,38 +27,218 @@ AHumanoidReference::AHumanoidReference()
 
 void AHumanoidReference::AddHumanoidReference()
 {
-	// Clear all instances
-	DummyReference->ClearInstances();
+	if (Gap <= 0.f || CellPoints <= 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s: Gap and CellPoints must be positive"), *GetName());
+		return;
+	}
 
-	// Place the humanoid
-	FVector2D Size = GridSize / 2.f / Gap;
-	for (int32 X = Size.X * -1.f; X <= Size.X; ++X)
-		for (int32 Y = Size.Y * -1.f; Y <= Size.Y; ++Y)
-		{
-			FHitResult HitResult;
+	const double StartTime = FPlatformTime::Seconds();
 
-			GetWorld()->LineTraceSingleByChannel(
-				HitResult,
-				FVector(X * Gap, Y * Gap, TraceHeight),
-				FVector(X * Gap, Y * Gap, TraceHeight * -1.f),
-				ECollisionChannel::ECC_Visibility
-			);
+	// Grid points, centered at the grid origin
+	const FIntPoint Extent(FMath::FloorToInt32(GridSize.X / 2.f / Gap), FMath::FloorToInt32(GridSize.Y / 2.f / Gap));
+	const FIntRect GridPoints(-Extent, Extent + FIntPoint(1));
 
-			// Finally spawn the dummy humaniod
-			if (HitResult.bBlockingHit)
-			{
-				FTransform DummyTransform;
-				DummyTransform.SetLocation(HitResult.ImpactPoint);
+	const FIntRect GridCells(
+		FIntPoint(ToCell(GridPoints.Min.X), ToCell(GridPoints.Min.Y)),
+		FIntPoint(ToCell(GridPoints.Max.X - 1), ToCell(GridPoints.Max.Y - 1)) + FIntPoint(1)
+	);
+
+	TMap<FIntPoint, uint32> CellGeometry;
+	HashCellGeometry(GridCells, CellGeometry);
+
+	UGroundHeightSubsystem* GroundHeights = GetWorld()->GetSubsystem<UGroundHeightSubsystem>();
+
+	// Trace only the cells whose signature changed
+	FScopedSlowTask SlowTask(GridCells.Area(), INVTEXT("Generating humanoid references"));
+	SlowTask.MakeDialog(true);
+
+	int32 Traced = 0;
+	bool bCancelled = false;
 
-				DummyReference->AddInstance(
-					DummyTransform,
-					true
-				);
+	for (int32 CellY = GridCells.Min.Y; CellY < GridCells.Max.Y && !bCancelled; ++CellY)
+		for (int32 CellX = GridCells.Min.X; CellX < GridCells.Max.X; ++CellX)
+		{
+			SlowTask.EnterProgressFrame(1.f);
+
+			if (SlowTask.ShouldCancel())
+			{
+				bCancelled = true;
+				break;
 			}
+
+			const FIntPoint CellMin(CellX * CellPoints, CellY * CellPoints);
+
+			FIntRect Points(CellMin, CellMin + FIntPoint(CellPoints));
+			Points.Clip(GridPoints);
+
+			const uint32 Signature = ComputeCellSignature(Points, CellGeometry.FindRef(FIntPoint(CellX, CellY)));
+			FReferenceCell& Cell = Cells.FindOrAdd(FIntPoint(CellX, CellY));
+
+			if (Cell.bTraced && Cell.Signature == Signature) continue;
+
+			// Only this cell may have been sculpted, the cached heights of the others are still right
+			if (GroundHeights)
+				GroundHeights->Invalidate(FBox2D(FVector2D(GetPointLocation(Points.Min.X, Points.Min.Y)), FVector2D(GetPointLocation(Points.Max.X, Points.Max.Y))));
+
+			Cell.Signature = Signature;
+			Cell.bTraced   = true;
+			TraceCell(Points, GroundHeights, Cell.Transforms);
+
+			++Traced;
 		}
+
+	// Cells that left the grid, unless we stopped half way (then the rest is simply kept as it was)
+	int32 Removed = 0;
+
+	if (!bCancelled)
+		for (auto It = Cells.CreateIterator(); It; ++It)
+			if (!GridCells.Contains(It.Key()))
+			{
+				It.RemoveCurrent();
+				++Removed;
+			}
+
+	// Finally add every dummy humanoid in one go
+	int32 Total = 0;
+	for (const TPair<FIntPoint, FReferenceCell>& Pair : Cells)
+		Total += Pair.Value.Transforms.Num();
+
+	if (Traced > 0 || Removed > 0 || DummyReference->GetInstanceCount() != Total)
+	{
+		TArray<FTransform> Transforms;
+		Transforms.Reserve(Total);
+
+		for (const TPair<FIntPoint, FReferenceCell>& Pair : Cells)
+			Transforms.Append(Pair.Value.Transforms);
+
+		DummyReference->ClearInstances();
+		DummyReference->AddInstances(Transforms, false, true);
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("%s: traced %d of %d cells, %d references in %.2fs%s"),
+		*GetName(),
+		Traced,
+		GridCells.Area(),
+		Total,
+		FPlatformTime::Seconds() - StartTime,
+		bCancelled ? TEXT(" (cancelled)") : TEXT("")
+	);
 }
 
 void AHumanoidReference::ClearHumanoidRefenrence()
 {
 	DummyReference->ClearInstances();
+	Cells.Reset();
+}
+
+// ==================== Cells ==================== //
+
+void AHumanoidReference::HashCellGeometry(const FIntRect& GridCells, TMap<FIntPoint, uint32>& OutGeometry) const
+{
+	const double MinZ = GridOrigin.Z - TraceHeight;
+	const double MaxZ = GridOrigin.Z + TraceHeight;
+
+	auto ToGridCell = [this](double World, double Origin) {
+		return ToCell(FMath::FloorToInt32((World - Origin) / Gap));
+	};
+
+	for (TActorIterator<AActor> It(GetWorld()); It; ++It)
+	{
+		if (*It == this) continue;
+
+		It->ForEachComponent<UPrimitiveComponent>(false, [&](const UPrimitiveComponent* Component)
+		{
+			if (!Component->IsQueryCollisionEnabled() || Component->GetCollisionResponseToChannel(ECollisionChannel::ECC_Visibility) != ECR_Block) return;
+
+			const FBox Box = Component->Bounds.GetBox();
+			if (Box.Max.Z < MinZ || Box.Min.Z > MaxZ) return;
+
+			const FTransform& Transform = Component->GetComponentTransform();
+
+			uint32 Hash = HashCombineFast(GetTypeHash(Box.Min), GetTypeHash(Box.Max));
+			Hash = HashCombineFast(Hash, GetTypeHash(Transform.GetLocation()));
+			Hash = HashCombineFast(Hash, GetTypeHash(Transform.GetRotation().Euler()));
+			Hash = HashCombineFast(Hash, GetTypeHash(Transform.GetScale3D()));
+
+			// Sculpting changes the heights but not always the bounds
+			if (const ULandscapeHeightfieldCollisionComponent* Heightfield = Cast<ULandscapeHeightfieldCollisionComponent>(Component))
+				Hash = HashCombineFast(Hash, GetTypeHash(Heightfield->HeightfieldGuid));
+
+			// Every cell it covers, summed since components come in no particular order
+			FIntRect Covered(
+				FIntPoint(ToGridCell(Box.Min.X, GridOrigin.X), ToGridCell(Box.Min.Y, GridOrigin.Y)),
+				FIntPoint(ToGridCell(Box.Max.X, GridOrigin.X), ToGridCell(Box.Max.Y, GridOrigin.Y)) + FIntPoint(1)
+			);
+			Covered.Clip(GridCells);
+
+			for (int32 Y = Covered.Min.Y; Y < Covered.Max.Y; ++Y)
+				for (int32 X = Covered.Min.X; X < Covered.Max.X; ++X)
+					OutGeometry.FindOrAdd(FIntPoint(X, Y)) += Hash;
+		});
+	}
+}
+
+uint32 AHumanoidReference::ComputeCellSignature(const FIntRect& Points, uint32 Geometry) const
+{
+	// Grid parameters
+	uint32 Signature = HashCombineFast(GetTypeHash(GridOrigin), GetTypeHash(TraceHeight));
+	Signature = HashCombineFast(Signature, GetTypeHash(Gap));
+	Signature = HashCombineFast(Signature, HashCombineFast(GetTypeHash(Points.Min), GetTypeHash(Points.Max)));
+
+	return HashCombineFast(Signature, Geometry);
+}
+
+void AHumanoidReference::TraceCell(const FIntRect& Points, UGroundHeightSubsystem* GroundHeights, TArray<FTransform>& OutTransforms) const
+{
+	const int32 Width = Points.Width();
+	const UWorld* World = GetWorld();
+
+	// Terrain under every point from the ground height cache first, it is game thread only
+	TArray<FVector2D> Locations;
+	Locations.SetNumUninitialized(Points.Area());
+
+	for (int32 Index = 0; Index < Locations.Num(); ++Index)
+		Locations[Index] = FVector2D(GetPointLocation(Points.Min.X + Index % Width, Points.Min.Y + Index / Width));
+
+	TArray<FGroundSample> Terrain;
+	Terrain.SetNum(Locations.Num());
+
+	if (GroundHeights) GroundHeights->GetGroundBatch(Locations, Terrain);
+
+	// The dummies themselves must not be hit since they are still there while tracing
+	const FCollisionQueryParams Params(SCENE_QUERY_STAT(HumanoidReference), false, this);
+
+	// One slot per point so the workers share nothing, misses get compacted afterwards
+	TArray<TOptional<FVector>> Hits;
+	Hits.SetNum(Locations.Num());
+
+	// Scene queries only read the physics scene (under its read lock), so they can run on the workers
+	ParallelFor(Hits.Num(), [&](int32 Index)
+	{
+		const FGroundSample& Ground = Terrain[Index];
+
+		// Same as UGroundHeightSubsystem::TraceGround: with the terrain known, only trace from above it down to it,
+		// rocks and roofs are still found and the terrain itself doesn't need the trace
+		const double Top    = Ground.bValid ? Ground.Height + TraceHeight : GridOrigin.Z + TraceHeight;
+		const double Bottom = Ground.bValid ? Ground.Height - 10.f : GridOrigin.Z - TraceHeight;
+
+		FHitResult HitResult;
+
+		if (World->LineTraceSingleByChannel(
+			HitResult,
+			FVector(Locations[Index], Top),
+			FVector(Locations[Index], Bottom),
+			ECollisionChannel::ECC_Visibility,
+			Params
+		))
+			Hits[Index] = HitResult.ImpactPoint;
+		else if (Ground.bValid)
+			Hits[Index] = FVector(Locations[Index], Ground.Height);
+	});
+
+	OutTransforms.Reset(Hits.Num());
+
+	for (const TOptional<FVector>& Hit : Hits)
+		if (Hit.IsSet()) OutTransforms.Emplace(Hit.GetValue());
 }
@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "DevelopmentUtils/TerrainGenerateCommandlet.h"
+#include "Misc/Paths.h"
+#include "Terrain/TerrainGenerator.h"
+
+UTerrainGenerateCommandlet::UTerrainGenerateCommandlet()
+{
+	IsClient       = false;
+	IsServer       = false;
+	IsEditor       = false;
+	LogToConsole   = true;
+	ShowErrorCount = true;
+}
+
+int32 UTerrainGenerateCommandlet::Main(const FString& Params)
+{
+	// Arguments, anything not given keeps the default of FTerrainSettings
+	// Never defaults to the tracked OpenWorld.r16, overwriting it has to be asked for
+	FTerrainSettings Settings;
+	FString Output = TEXT("WorldGenerator/OpenWorld_Generated.r16");
+
+	FParse::Value(*Params, TEXT("Output="), Output);
+	FParse::Value(*Params, TEXT("Resolution="), Settings.Resolution);
+	FParse::Value(*Params, TEXT("Seed="), Settings.Seed);
+	FParse::Value(*Params, TEXT("Hydraulic="), Settings.HydraulicIterations);
+	FParse::Value(*Params, TEXT("Thermal="), Settings.ThermalIterations);
+	FParse::Value(*Params, TEXT("SeaLevel="), Settings.SeaLevel);
+	FParse::Value(*Params, TEXT("Ridged="), Settings.Ridged);
+	FParse::Value(*Params, TEXT("Frequency="), Settings.Frequency);
+	FParse::Value(*Params, TEXT("HeightRatio="), Settings.HeightRatio);
+
+	// Erosion normalizes heights by it
+	if (Settings.HeightRatio <= 0.f)
+	{
+		UE_LOG(LogTemp, Error, TEXT("HeightRatio must be above 0, got %f"), Settings.HeightRatio);
+		return 1;
+	}
+
+	if (FPaths::IsRelative(Output)) Output = FPaths::Combine(FPaths::ProjectDir(), Output);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	FTerrainGenerator Generator(Settings);
+	Generator.Generate();
+
+	if (!Generator.SaveR16(Output))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to write %s"), *Output);
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Generated %dx%d terrain (seed %d) in %.2fs -> %s"),
+		Generator.GetResolution(),
+		Generator.GetResolution(),
+		Settings.Seed,
+		FPlatformTime::Seconds() - StartTime,
+		*Output
+	);
+
+	return 0;
+}
@@ -0,0 +1,175 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Environments/RainOcclusionMap.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "LandscapeProxy.h"
+#include "WorldCollision.h"
+
+// ==================== Lifecycles ==================== //
+
+void FRainOcclusionMap::Initialize(int32 InResolution, float InCellSize)
+{
+	Resolution = FMath::Max(InResolution, 1);
+	CellSize   = FMath::Max(InCellSize, 1.f);
+	WindowMin  = FIntPoint(MAX_int32, MAX_int32);
+
+	Heights.Init(TNumericLimits<float>::Lowest(), Resolution * Resolution);
+	DirtyCells.Reset();
+	Landscapes.Reset();
+	bLandscapesCached = false;
+}
+
+bool FRainOcclusionMap::Recenter(const FVector& Center)
+{
+	if (Resolution == 0) return false;
+
+	const FIntPoint CenterCell(FMath::FloorToInt32(Center.X / CellSize), FMath::FloorToInt32(Center.Y / CellSize));
+	const FIntPoint NewMin = CenterCell - FIntPoint(Resolution / 2);
+
+	if (NewMin == WindowMin) return false;
+
+	const bool bFirstBuild = WindowMin.X == MAX_int32;
+	const FIntRect OldWindow(WindowMin, WindowMin + FIntPoint(Resolution));
+	const FIntRect NewWindow(NewMin, NewMin + FIntPoint(Resolution));
+
+	WindowMin = NewMin;
+
+	// Teleported or first build, everything is new
+	if (bFirstBuild || FMath::Abs(NewMin.X - OldWindow.Min.X) >= Resolution || FMath::Abs(NewMin.Y - OldWindow.Min.Y) >= Resolution)
+	{
+		DirtyCells.Reset();
+		MarkDirty(NewWindow);
+
+		return true;
+	}
+
+	// Only the strips that entered the window, split in X strip and Y strip so nothing gets added twice
+	const int32 MinY = FMath::Max(NewWindow.Min.Y, OldWindow.Min.Y);
+	const int32 MaxY = FMath::Min(NewWindow.Max.Y, OldWindow.Max.Y);
+
+	if (NewWindow.Min.X < OldWindow.Min.X) MarkDirty(FIntRect(NewWindow.Min.X, MinY, OldWindow.Min.X, MaxY));
+	if (NewWindow.Max.X > OldWindow.Max.X) MarkDirty(FIntRect(OldWindow.Max.X, MinY, NewWindow.Max.X, MaxY));
+
+	if (NewWindow.Min.Y < OldWindow.Min.Y) MarkDirty(FIntRect(NewWindow.Min.X, NewWindow.Min.Y, NewWindow.Max.X, OldWindow.Min.Y));
+	if (NewWindow.Max.Y > OldWindow.Max.Y) MarkDirty(FIntRect(NewWindow.Min.X, OldWindow.Max.Y, NewWindow.Max.X, NewWindow.Max.Y));
+
+	return true;
+}
+
+bool FRainOcclusionMap::BuildDirty(UWorld* World, int32 MaxTexels)
+{
+	if (!World || DirtyCells.IsEmpty()) return false;
+
+	if (!bLandscapesCached)
+	{
+		for (TActorIterator<ALandscapeProxy> It(World); It; ++It)
+			Landscapes.Add(*It);
+
+		bLandscapesCached = true;
+	}
+
+	// Take a batch (the dirty cells are queued strip by strip, so the batch is mostly contiguous)
+	TArray<FIntPoint> Batch;
+	Batch.Reserve(MaxTexels);
+
+	int32 Consumed = 0;
+	for (; Consumed < DirtyCells.Num() && Batch.Num() < MaxTexels; ++Consumed)
+		if (IsInWindow(DirtyCells[Consumed])) Batch.Add(DirtyCells[Consumed]);
+
+	DirtyCells.RemoveAt(0, Consumed, false);
+
+	if (Batch.IsEmpty()) return false;
+
+	FIntRect BatchRect(Batch[0], Batch[0] + FIntPoint(1));
+	for (const FIntPoint& Cell : Batch)
+		BatchRect.Union(FIntRect(Cell, Cell + FIntPoint(1)));
+
+	// Landscape height first
+	for (const FIntPoint& Cell : Batch)
+		Heights[ToIndex(Cell)] = SampleLandscape(FVector2D(Cell.X + .5f, Cell.Y + .5f) * CellSize);
+
+	// Then the top of any static geometry bounds (roofs, canopy) over the batch, in a single query
+	const FVector BoxMin(BatchRect.Min.X * CellSize, BatchRect.Min.Y * CellSize, -HALF_WORLD_MAX);
+	const FVector BoxMax(BatchRect.Max.X * CellSize, BatchRect.Max.Y * CellSize,  HALF_WORLD_MAX);
+	const FBox QueryBox(BoxMin, BoxMax);
+
+	TArray<FOverlapResult> Overlaps;
+	World->OverlapMultiByObjectType(
+		Overlaps,
+		QueryBox.GetCenter(),
+		FQuat::Identity,
+		FCollisionObjectQueryParams(ECollisionChannel::ECC_WorldStatic),
+		FCollisionShape::MakeBox(QueryBox.GetExtent())
+	);
+
+	const float MaxOccluderSize = Resolution * CellSize;
+
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		const UPrimitiveComponent* Component = Overlap.GetComponent();
+
+		// Landscape is already covered by its height, and anything as big as the window is not a roof (water, volumes)
+		if (!Component || (Component->GetOwner() && Component->GetOwner()->IsA<ALandscapeProxy>())) continue;
+
+		const FBox Bounds = Component->Bounds.GetBox();
+		const FVector Size = Bounds.GetSize();
+
+		if (Size.X > MaxOccluderSize || Size.Y > MaxOccluderSize) continue;
+
+		const int32 MinX = FMath::FloorToInt32(Bounds.Min.X / CellSize);
+		const int32 MinY = FMath::FloorToInt32(Bounds.Min.Y / CellSize);
+		const int32 MaxX = FMath::FloorToInt32(Bounds.Max.X / CellSize);
+		const int32 MaxY = FMath::FloorToInt32(Bounds.Max.Y / CellSize);
+
+		for (const FIntPoint& Cell : Batch)
+			if (Cell.X >= MinX && Cell.X <= MaxX && Cell.Y >= MinY && Cell.Y <= MaxY)
+			{
+				float& Height = Heights[ToIndex(Cell)];
+				Height = FMath::Max(Height, (float)Bounds.Max.Z);
+			}
+	}
+
+	return true;
+}
+
+// ==================== Queries ==================== //
+
+float FRainOcclusionMap::GetOcclusionHeight(const FVector2D& Location) const
+{
+	if (Resolution == 0) return TNumericLimits<float>::Lowest();
+
+	const FIntPoint Cell(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+
+	if (!IsInWindow(Cell)) return TNumericLimits<float>::Lowest();
+
+	return Heights[ToIndex(Cell)];
+}
+
+// ==================== Helpers ==================== //
+
+void FRainOcclusionMap::MarkDirty(const FIntRect& Cells)
+{
+	for (int32 Y = Cells.Min.Y; Y < Cells.Max.Y; ++Y)
+		for (int32 X = Cells.Min.X; X < Cells.Max.X; ++X)
+		{
+			const FIntPoint Cell(X, Y);
+
+			// Stale data from the cell that left the window must not be sampled
+			Heights[ToIndex(Cell)] = TNumericLimits<float>::Lowest();
+			DirtyCells.Add(Cell);
+		}
+}
+
+float FRainOcclusionMap::SampleLandscape(const FVector2D& Location) const
+{
+	for (const TWeakObjectPtr<ALandscapeProxy>& Landscape : Landscapes)
+	{
+		if (!Landscape.IsValid()) continue;
+
+		if (TOptional<float> Height = Landscape->GetHeightAtLocation(FVector(Location, 0.f)); Height.IsSet())
+			return Height.GetValue();
+	}
+
+	return TNumericLimits<float>::Lowest();
+}
@@ -4,14 +4,19 @@
 #include "Components/AudioComponent.h"
 #include "Components/TimelineComponent.h"
 #include "Engine/PostProcessVolume.h"
+#include "Engine/Texture2D.h"
 #include "Kismet/GameplayStatics.h"
 #include "Kismet/KismetMathLibrary.h"
-#include "Materials/MaterialParameterCollectionInstance.h"
 #include "NiagaraComponent.h"
 #include "NiagaraFunctionLibrary.h"
+#include "OpenWorld.h"
+#include "Subsystems/GroundHeightSubsystem.h"
+#include "Subsystems/SimulationSubsystem.h"
 
 ARainThunder::ARainThunder()
 {
+	LLM_SCOPE_BYTAG(OW_Environment);
+
 	PrimaryActorTick.bCanEverTick = true;
 	PrimaryActorTick.bStartWithTickEnabled = false;
 
@@ -70,10 +75,21 @@ void ARainThunder::DefaultInitializer()
 
 void ARainThunder::BeginPlay()
 {
+	LLM_SCOPE_BYTAG(OW_Environment);
+
 	Super::BeginPlay();
 	
 	CreateMaterial();
 	SetupThunder();
+
+	// Global material params
+	GlobalParams = GetWorld()->GetSubsystem<UGlobalParamSubsystem>();
+
+	if (GlobalParams.IsValid())
+	{
+		RainLevelParam           = GlobalParams->ResolveScalar(TEXT("RainLevel"));
+		RainOcclusionBoundsParam = GlobalParams->ResolveVector(TEXT("RainOcclusionBounds"));
+	}
 }
 
 void ARainThunder::Tick(float DeltaTime)
@@ -81,9 +97,12 @@ void ARainThunder::Tick(float DeltaTime)
 	Super::Tick(DeltaTime);
 
 	UpdateRain(DeltaTime);
+	UpdateOcclusion();
+
+	CSV_CUSTOM_STAT(OpenWorldWeather, Raining, bRaining ? 1 : 0, ECsvCustomStatOp::Set);
 
 	// Watch for any progress, if none disable
-	if (!bRaining) SetActorTickEnabled(false);
+	if (!bRaining && !RainComponent) SetActorTickEnabled(false);
 }
 
 // ==================== Materials ==================== //
@@ -122,14 +141,23 @@ void ARainThunder::UpdateThunderTimeline(float Value)
 
 void ARainThunder::Relocate()
 {
+	FRandomStream& Stream = USimulationSubsystem::GetStream(this, ERandomStream::ERS_Weather);
+
 	FRotator ControllerRotation = PlayerPawn->GetControlRotation();
 
 	// Make the thunder infront of the player
-	const FVector ForwardDirection = FRotationMatrix(ControllerRotation).GetUnitAxis(EAxis::X) * FMath::RandRange(5000.f, 8000.f);
+	const FVector ForwardDirection = FRotationMatrix(ControllerRotation).GetUnitAxis(EAxis::X) * Stream.FRandRange(5000.f, 8000.f);
 	const FVector RightDirection   = FRotationMatrix(ControllerRotation).GetUnitAxis(EAxis::Y);
 	const FVector PlayerLocation   = PlayerPawn->GetActorLocation();
 
-	FVector ThunderLocation = ForwardDirection + PlayerLocation + RightDirection * FMath::RandRange(-8000.f, 8000.f) + FVector(0.f, 0.f, 3000.f);
+	FVector ThunderLocation = ForwardDirection + PlayerLocation + RightDirection * Stream.FRandRange(-8000.f, 8000.f) + FVector(0.f, 0.f, 3000.f);
+
+	// Don't let it end up inside a mountain
+	float GroundHeight;
+	UGroundHeightSubsystem* GroundHeights = GetWorld()->GetSubsystem<UGroundHeightSubsystem>();
+
+	if (GroundHeights && GroundHeights->GetGroundHeight(FVector2D(ThunderLocation), GroundHeight))
+		ThunderLocation.Z = FMath::Max(ThunderLocation.Z, GroundHeight + 3000.f);
 
 	// Make the thunder always facing the player
 	float RotationYaw = UKismetMathLibrary::FindLookAtRotation(ThunderLocation, PlayerLocation).Yaw;
@@ -162,23 +190,87 @@ void ARainThunder::Flashing()
 
 void ARainThunder::UpdateRain(float DeltaTime)
 {
+	OW_SCOPE_CYCLE_COUNTER(UpdateRain);
+
 	if (!bRaining) return;
 
 	// Updating rain weather
 	RainLevel = FMath::Clamp(RainLevel + ChangeRate * DeltaTime, 0.f, .8f);
-	GlobalMatParamIns->SetScalarParameterValue(TEXT("RainLevel"), RainLevel);
+	if (GlobalParams.IsValid()) GlobalParams->SetScalar(RainLevelParam, RainLevel);
 	
 	if (RainLevel == 0.f || RainLevel == .8f) bRaining = false;
 }
 
+void ARainThunder::UpdateOcclusion()
+{
+	if (!RainComponent || !PlayerPawn.IsValid()) return;
+
+	const FVector PlayerLocation = PlayerPawn->GetActorLocation();
+
+	// Only rebuilds the strips that entered the window when the player crossed a cell
+	OcclusionMap.Recenter(PlayerLocation);
+
+	if (OcclusionMap.BuildDirty(GetWorld(), OcclusionTexelsPerFrame))
+		UploadOcclusionTexture();
+
+	// Muffle the rain when there is a roof/canopy above
+	bool bCovered = OcclusionMap.IsOccluded(PlayerLocation);
+
+	if (bCovered != bPlayerCovered)
+	{
+		bPlayerCovered = bCovered;
+
+		if (RainSound) RainSound->SetVolumeMultiplier(bPlayerCovered ? .5f : 1.f);
+	}
+}
+
+void ARainThunder::UploadOcclusionTexture()
+{
+	const int32 Resolution = OcclusionMap.GetResolution();
+
+	if (!OcclusionTexture)
+	{
+		OcclusionTexture = UTexture2D::CreateTransient(Resolution, Resolution, PF_R32_FLOAT);
+		OcclusionTexture->Filter   = TextureFilter::TF_Nearest;
+		OcclusionTexture->AddressX = TextureAddress::TA_Wrap; // Stored toroidally, @see FRainOcclusionMap
+		OcclusionTexture->AddressY = TextureAddress::TA_Wrap;
+		OcclusionTexture->SRGB     = false;
+		OcclusionTexture->UpdateResource();
+
+		if (RainComponent) RainComponent->SetVariableTexture(TEXT("User.RainOcclusionMap"), OcclusionTexture);
+	}
+
+	// The render thread owns the copy until the update is done
+	const TArray<float>& Heights = OcclusionMap.GetHeights();
+	float* Data = new float[Heights.Num()];
+	FMemory::Memcpy(Data, Heights.GetData(), Heights.Num() * sizeof(float));
+
+	FUpdateTextureRegion2D* Region = new FUpdateTextureRegion2D(0, 0, 0, 0, Resolution, Resolution);
+	OcclusionTexture->UpdateTextureRegions(0, 1, Region, Resolution * sizeof(float), sizeof(float), reinterpret_cast<uint8*>(Data),
+		[](uint8* SrcData, const FUpdateTextureRegion2D* Regions)
+		{
+			delete[] reinterpret_cast<float*>(SrcData);
+			delete Regions;
+		}
+	);
+
+	// Window info so the shaders know where the map is
+	const FLinearColor Bounds = OcclusionMap.GetShaderBounds();
+
+	if (RainComponent) RainComponent->SetVariableLinearColor(TEXT("User.RainOcclusionBounds"), Bounds);
+	if (GlobalParams.IsValid()) GlobalParams->SetVector(RainOcclusionBoundsParam, Bounds);
+}
+
 // ==================== Interfaces ==================== //
 
 void ARainThunder::Strike()
 {
+	CSV_CUSTOM_STAT(OpenWorldWeather, ThunderStrikes, 1, ECsvCustomStatOp::Accumulate);
+
 	Relocate();
 
 	// Pick random texture for variation purpose
-	int8 RandomText = FMath::RandRange(0, ThunderTextures.Num() - 1);
+	int8 RandomText = USimulationSubsystem::GetStream(this, ERandomStream::ERS_Weather).RandRange(0, ThunderTextures.Num() - 1);
 	ThunderMaterial->SetTextureParameterValue(TEXT("ThunderTexture"), ThunderTextures[RandomText].LoadSynchronous());
 
 	// Play timeline
@@ -192,7 +284,7 @@ void ARainThunder::ToggleThunder(bool bEnabled)
 {
 	if (bEnabled)
 	{
-		float RandomTimer = FMath::RandRange(ThunderTimerMin, ThunderTimerMax);
+		float RandomTimer = USimulationSubsystem::GetStream(this, ERandomStream::ERS_Weather).FRandRange(ThunderTimerMin, ThunderTimerMax);
 
 		GetWorldTimerManager().SetTimer(ThunderTimerHandle, this, &ThisClass::Strike, RandomTimer, true);
 	}
@@ -202,6 +294,8 @@ void ARainThunder::ToggleThunder(bool bEnabled)
 
 void ARainThunder::ToggleRain(bool bEnabled)
 {
+	LLM_SCOPE_BYTAG(OW_Environment);
+
 	SetActorTickEnabled(true);
 
 	if (bEnabled && PlayerPawn.IsValid())
@@ -218,6 +312,13 @@ void ARainThunder::ToggleRain(bool bEnabled)
 		);
 		
 		RainComponent->Activate();
+		OW_INC_COUNTER(NiagaraSpawns);
+
+		// Occlusion map around the player, built over the next frames @see UpdateOcclusion
+		OcclusionMap.Initialize(OcclusionResolution, OcclusionCellSize);
+		bPlayerCovered = false;
+
+		if (OcclusionTexture) RainComponent->SetVariableTexture(TEXT("User.RainOcclusionMap"), OcclusionTexture);
 
 		// Make everything wet, @see UpdateRain function
 		bRaining   = true;
@@ -234,6 +335,7 @@ void ARainThunder::ToggleRain(bool bEnabled)
 		bRaining   = true;
 		ChangeRate = -.05f;
 		RainComponent->DestroyComponent();
+		RainComponent = nullptr;
 		RainSound->FadeOut(3.f, 1.f);
 		
 		// Stop the rain sound
@@ -242,10 +344,3 @@ void ARainThunder::ToggleRain(bool bEnabled)
 	}
 }
 
-// ==================== Modifiers ==================== //
-
-void ARainThunder::SetGlobalMatParamIns(UMaterialParameterCollectionInstance* InGlobalParam)
-{
-	GlobalMatParamIns = InGlobalParam;
-}
-
@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Environments/WeatherCellGrid.h"
+
+// ==================== Lifecycles ==================== //
+
+void FWeatherCellGrid::Initialize(int32 InDimension, float InCellSize, int32 Seed)
+{
+	Dimension = FMath::Max(InDimension, 1);
+	CellSize  = FMath::Max(InCellSize, 1.f);
+
+	State.Stream.Initialize(Seed);
+	State.Cells.SetNum(Dimension * Dimension);
+
+	// Start mostly clear with a few cloudy regions
+	for (FWeatherCell& Cell : State.Cells)
+	{
+		Cell.Cloudiness       = FMath::Square(State.Stream.GetFraction()) * .5f;
+		Cell.TargetCloudiness = Cell.Cloudiness;
+		Cell.TargetTimer      = State.Stream.FRandRange(0.f, 120.f);
+	}
+}
+
+FWeatherSimulationState FWeatherCellGrid::Step(FWeatherSimulationState State, int32 Dimension, float DeltaSeconds)
+{
+	// Read from the previous step only, so the result doesn't depend on the iteration order
+	const TArray<FWeatherCell> Previous = State.Cells;
+
+	auto GetPrevious = [&](int32 X, int32 Y) -> const FWeatherCell& {
+		return Previous[FMath::Clamp(Y, 0, Dimension - 1) * Dimension + FMath::Clamp(X, 0, Dimension - 1)];
+	};
+
+	for (int32 Y = 0; Y < Dimension; ++Y)
+		for (int32 X = 0; X < Dimension; ++X)
+		{
+			FWeatherCell& Cell = State.Cells[Y * Dimension + X];
+
+			// Pick a new weather once in a while, squared so clear sky is more common than storm
+			Cell.TargetTimer -= DeltaSeconds;
+
+			if (Cell.TargetTimer <= 0.f)
+			{
+				Cell.TargetCloudiness = FMath::Square(State.Stream.GetFraction());
+				Cell.TargetTimer      = State.Stream.FRandRange(60.f, 300.f);
+			}
+
+			// Drift towards the target and let the neighbours bleed in so fronts move across cells
+			const float Neighbours = (GetPrevious(X - 1, Y).Cloudiness + GetPrevious(X + 1, Y).Cloudiness +
+									  GetPrevious(X, Y - 1).Cloudiness + GetPrevious(X, Y + 1).Cloudiness) * .25f;
+
+			Cell.Cloudiness = FMath::FInterpConstantTo(Cell.Cloudiness, Cell.TargetCloudiness, DeltaSeconds, .01f);
+			Cell.Cloudiness = FMath::Lerp(Cell.Cloudiness, Neighbours, FMath::Min(.02f * DeltaSeconds, 1.f));
+
+			// Rain only starts on heavy clouds
+			Cell.Rain = FMath::Clamp((Cell.Cloudiness - .6f) / .3f, 0.f, 1.f);
+		}
+
+	return State;
+}
+
+// ==================== Queries ==================== //
+
+FWeatherCell FWeatherCellGrid::Sample(const FVector& Location) const
+{
+	if (State.Cells.IsEmpty()) return FWeatherCell();
+
+	// Grid space, relative to the cell centers
+	const float GridX = Location.X / CellSize + Dimension * .5f - .5f;
+	const float GridY = Location.Y / CellSize + Dimension * .5f - .5f;
+
+	const int32 X = FMath::FloorToInt32(GridX);
+	const int32 Y = FMath::FloorToInt32(GridY);
+	const float AlphaX = GridX - X;
+	const float AlphaY = GridY - Y;
+
+	auto Blend = [&](auto Member) {
+		const float Top    = FMath::Lerp(GetCell(X, Y).*Member,     GetCell(X + 1, Y).*Member,     AlphaX);
+		const float Bottom = FMath::Lerp(GetCell(X, Y + 1).*Member, GetCell(X + 1, Y + 1).*Member, AlphaX);
+
+		return FMath::Lerp(Top, Bottom, AlphaY);
+	};
+
+	FWeatherCell Result;
+	Result.Cloudiness = Blend(&FWeatherCell::Cloudiness);
+	Result.Rain       = Blend(&FWeatherCell::Rain);
+
+	return Result;
+}
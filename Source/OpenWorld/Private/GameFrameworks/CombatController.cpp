@@ -2,14 +2,19 @@
 
 #include "GameFrameworks/CombatController.h"
 #include "Characters/CombatCharacter.h"
+#include "Components/CooldownComponent.h"
 #include "NavigationSystem.h"
 #include "Navigation/PathFollowingComponent.h"
+#include "OpenWorld.h"
 #include "Perception/AIPerceptionComponent.h"
 #include "Perception/AISenseConfig_Sight.h"
 #include "Perception/AISenseConfig_Hearing.h"
+#include "Subsystems/SimulationSubsystem.h"
 
 ACombatController::ACombatController()
 {
+    LLM_SCOPE_BYTAG(OW_AI);
+
     PrimaryActorTick.bCanEverTick = true;
 
     // Perception
@@ -37,6 +42,9 @@ ACombatController::ACombatController()
     Perception->SetDominantSense(UAISense_Sight::StaticClass());
 
     SetPerceptionComponent(*Perception);
+
+    // Cooldowns
+    Cooldowns = CreateDefaultSubobject<UCooldownComponent>(TEXT("Cooldowns"));
 }
 
 void ACombatController::ReferencesInitializer()
@@ -48,11 +56,22 @@ void ACombatController::ReferencesInitializer()
 
 void ACombatController::BeginPlay()
 {
+    LLM_SCOPE_BYTAG(OW_AI);
+
     Super::BeginPlay();
 
     // Events
     GetPerceptionComponent()->OnTargetPerceptionUpdated.AddDynamic(this, &ThisClass::OnTargetSense);
 
+    // Cooldowns
+    Cooldowns->Bind(ECooldown::EC_Engage, this, &ThisClass::Engage);
+    Cooldowns->Bind(ECooldown::EC_Reaction, this, &ThisClass::FinishedReaction);
+    Cooldowns->Bind(ECooldown::EC_Patrolling, this, &ThisClass::StartPatrolling);
+    /** Disable blocking after certain time */
+    Cooldowns->BindLambda(ECooldown::EC_Blocking, [this]() {
+        CombatCharacter->ToggleBlock(false);
+    });
+
     // ...
     ReferencesInitializer();
     StartPatrolling();
@@ -62,6 +81,9 @@ void ACombatController::Tick(float DeltaTime)
 {
     Super::Tick(DeltaTime);
 
+    OW_INC_COUNTER(ActiveAI);
+    EmitTelemetry();
+
     Strafing();
 }
 
@@ -77,14 +99,9 @@ void ACombatController::OnMoveCompleted(FAIRequestID RequestID, const FPathFollo
     else
     {
         // Investigate then start to patrolling
-        float Timer = FMath::RandRange(PatrollingDelayMin, PatrollingDelayMax);
-
-        GetWorldTimerManager().SetTimer(
-            PatrollingDelayHandler,
-            this,
-            &ThisClass::StartPatrolling,
-            Timer
-        );
+        float Timer = GetAIStream().FRandRange(PatrollingDelayMin, PatrollingDelayMax);
+
+        Cooldowns->Start(ECooldown::EC_Patrolling, Timer);
     }
 }
 
@@ -92,12 +109,7 @@ void ACombatController::ActivateReaction()
 {
     if (!CombatCharacter->bEquipWeapon) CombatCharacter->SwapWeapon();
 
-    GetWorldTimerManager().SetTimer(
-        ReactionDelay,
-        this,
-        &ThisClass::FinishedReaction,
-        .8f
-    );
+    Cooldowns->Start(ECooldown::EC_Reaction, .8f);
 }
 
 void ACombatController::OnTargetSense(AActor* Actor, FAIStimulus Stimulus)
@@ -109,7 +121,7 @@ void ACombatController::OnTargetSense(AActor* Actor, FAIStimulus Stimulus)
                       CombatCharacter->IsOnMontage("Stunned") || // OR
                       !Other        || // OR
                       !CombatCharacter->IsEnemy(Other) || // OR
-                      GetWorldTimerManager().IsTimerActive(ReactionDelay);
+                      Cooldowns->IsActive(ECooldown::EC_Reaction);
 
     if (bCantSense) return;
 
@@ -123,15 +135,17 @@ void ACombatController::OnTargetSense(AActor* Actor, FAIStimulus Stimulus)
 
 void ACombatController::Engage()
 {
+    OW_SCOPE_CYCLE_COUNTER(Engage);
+
     // Reset
     CombatCharacter->ToggleWalk(false);
     bStrafing     = false;
     bDisableSense = true;
-    GetWorldTimerManager().ClearTimer(PatrollingDelayHandler);
+    Cooldowns->Stop(ECooldown::EC_Patrolling);
 
     // Randomize next Engage
-    float NextEngageTimer = FMath::RandRange(EngageDelayMin, EngageDelayMax);
-    GetWorldTimerManager().SetTimer(EngageDelayHandle, this, &ThisClass::Engage, NextEngageTimer);
+    float NextEngageTimer = GetAIStream().FRandRange(EngageDelayMin, EngageDelayMax);
+    Cooldowns->Start(ECooldown::EC_Engage, NextEngageTimer);
 
     // If on doing something, do none
     if (CombatCharacter->IsOnMontage()) return;
@@ -152,9 +166,15 @@ void ACombatController::Engage()
     }
 
     // Get the decision randomly, but we can adjust the aggresivly
-    int8 Decision = FMath::RandRange(0, EngageChances.Num() - 1);
+    int8 Decision = GetAIStream().RandRange(0, EngageChances.Num() - 1);
     Decision = EngageChances[Decision];
-    
+
+    UE_TRACE_LOG(OpenWorld, AIEngage, OpenWorldChannel)
+        << AIEngage.Cycle(FPlatformTime::Cycles64())
+        << AIEngage.Enemy(CombatCharacter->GetUniqueID())
+        << AIEngage.Target(CombatCharacter->TargetCombat->GetUniqueID())
+        << AIEngage.Decision(Decision);
+
     switch (Decision)
     {
     // Attacking
@@ -183,11 +203,17 @@ void ACombatController::Engage()
     }
 }
 
+void ACombatController::ReEngage()
+{
+    Cooldowns->Stop(ECooldown::EC_Engage);
+    Engage();
+}
+
 void ACombatController::StartStrafing()
 {
     bStrafing = true;
-    StrafeDirectionX = FMath::RandRange(0, 1) ? -1.f : 1.f;
-    StrafeDirectionY = FMath::RandRange(-1.f, 1.f);
+    StrafeDirectionX = GetAIStream().RandRange(0, 1) ? -1.f : 1.f;
+    StrafeDirectionY = GetAIStream().FRandRange(-1.f, 1.f);
 }
 
 void ACombatController::Blocking()
@@ -195,13 +221,9 @@ void ACombatController::Blocking()
     CombatCharacter->ToggleBlock(true);
 
     // Disable it after certain time
-    float Timer = FMath::RandRange(1.f, 4.f);
+    float Timer = GetAIStream().FRandRange(1.f, 4.f);
 
-    GetWorldTimerManager().SetTimer(
-        BlockingTimerHandle, [this]()
-        { CombatCharacter->ToggleBlock(false); },
-        Timer, false
-    );
+    Cooldowns->Start(ECooldown::EC_Blocking, Timer);
 }
 
 // ==================== Patrolling ==================== //
@@ -242,7 +264,7 @@ void ACombatController::Attacking()
     // If character is not ready to attack yet AND
     // Only attacking if the enemy's target is self instead, he will just strafing, blocking, etc
     bool bNotForceAttack = CombatCharacter->GetTargetCombat()->GetTargetCombat() /* Enemy's target combat */ != CombatCharacter &&
-                        !FMath::RandBool();
+                        !GetAIStream().RandRange(0, 1);
     if (!CombatCharacter->IsReady() || bNotForceAttack)
     {
         ReEngage();
@@ -263,12 +285,34 @@ void ACombatController::Attacking()
 
     // The distance is close, so we can attack now
     // Try to kick enemy that is on blocking
-    bool bShouldAttack = CombatCharacter->TargetCombat->IsBlocking() ? FMath::RandBool() : true;
+    bool bShouldAttack = CombatCharacter->TargetCombat->IsBlocking() ? GetAIStream().RandRange(0, 1) == 1 : true;
 
     if (bShouldAttack) CombatCharacter->Attack();
     else               CombatCharacter->StartKick();
 }
 
+void ACombatController::EmitTelemetry() const
+{
+#if CSV_PROFILER
+    if (!FCsvProfiler::Get()->IsCapturing()) return;
+
+    // Each controller adds itself to the column of its state
+    if (bStrafing)
+        CSV_CUSTOM_STAT(OpenWorldAI, Strafing, 1, ECsvCustomStatOp::Accumulate);
+    else if (CombatCharacter.IsValid() && CombatCharacter->TargetCombat.IsValid())
+        CSV_CUSTOM_STAT(OpenWorldAI, Attacking, 1, ECsvCustomStatOp::Accumulate);
+    else
+        CSV_CUSTOM_STAT(OpenWorldAI, Patrolling, 1, ECsvCustomStatOp::Accumulate);
+
+    CSV_CUSTOM_STAT(OpenWorldAI, ActiveTimers, Cooldowns->GetActiveCount(), ECsvCustomStatOp::Accumulate);
+#endif
+}
+
+FRandomStream& ACombatController::GetAIStream() const
+{
+    return USimulationSubsystem::GetStream(this, ERandomStream::ERS_AI);
+}
+
 void ACombatController::FinishedReaction()
 {
     CombatCharacter->SetLockOn(CombatCharacter->TargetCombat.Get());
@@ -276,6 +320,8 @@ void ACombatController::FinishedReaction()
 
 void ACombatController::Strafing()
 {
+    OW_SCOPE_CYCLE_COUNTER(Strafing);
+
     if (!bStrafing || !CombatCharacter.IsValid()) return;
 
     FRotator Rotation = GetControlRotation();
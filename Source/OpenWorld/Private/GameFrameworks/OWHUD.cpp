@@ -1,8 +1,56 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "GameFrameworks/OWHUD.h"
+#include "Characters/CombatCharacter.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/Canvas.h"
+#include "EngineUtils.h"
+#include "Kismet/GameplayStatics.h"
+#include "OpenWorld.h"
+#include "Subsystems/GroundHeightSubsystem.h"
+#include "Weapons/MeleeWeapon.h"
 #include "Widgets/TipWidget.h"
 
+#define LOCTEXT_NAMESPACE "OWHUD"
+
+struct FTipDefinition
+{
+    FText Text;
+    int32 Priority;
+};
+
+/** Built once, requests only carry the id */
+static const FTipDefinition& GetTipDefinition(ETipMessage Tip)
+{
+    static const FTipDefinition Definitions[] = {
+        { FText::GetEmpty(), MIN_int32 },
+        { LOCTEXT("PickupWeapon", "[F] - To pickup weapon"), 0 },
+        { LOCTEXT("Takedown", "[LMB] - Perform Takedown"), 10 },
+        { LOCTEXT("DodgeBlock", "[ALT] / [RMB] - To Dodge / Block"), 20 },
+        { LOCTEXT("Dash", "[ALT] + [WASD] - To dash"), 30 }
+    };
+    static_assert(UE_ARRAY_COUNT(Definitions) == (int32)ETipMessage::ETM_Max, "Every tip needs a definition");
+
+    return Definitions[(uint8)Tip];
+}
+
+#undef LOCTEXT_NAMESPACE
+
+static FAutoConsoleCommandWithWorldAndArgs OverlayBenchmarkCommand(
+    TEXT("ow.HUD.OverlayBenchmark"),
+    TEXT("ow.HUD.OverlayBenchmark [Count=200] [Duration=5], spawn enemies in front of the camera and log the combat overlay cost"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+    {
+        const int32 Count    = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 200;
+        const float Duration = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 5.f;
+
+        APlayerController* PlayerController = World ? UGameplayStatics::GetPlayerController(World, 0) : nullptr;
+
+        if (AOWHUD* OWHUD = PlayerController ? Cast<AOWHUD>(PlayerController->GetHUD()) : nullptr)
+            OWHUD->RunOverlayBenchmark(FMath::Max(Count, 1), FMath::Max(Duration, .1f));
+    })
+);
+
 AOWHUD::AOWHUD()
 {
     DefaultInitializer();
@@ -24,24 +72,272 @@ void AOWHUD::BeginPlay()
     Super::BeginPlay();
 
     ConstructWidgets();
+
+    // Whoever began play before us
+    for (TActorIterator<ACombatCharacter> It(GetWorld()); It; ++It)
+        if (!It->IsDead()) AddCombatant(*It, It->GetHealth() / It->GetMaxHealth());
 }
 
 // ==================== Widgets ==================== //
 
 void AOWHUD::ConstructWidgets()
 {
+    LLM_SCOPE_BYTAG(OW_UI);
+
     // TipWidget
     TipWidget = CreateWidget<UTipWidget>(GetOwningPlayerController(), TipWidgetClass, TEXT("Tip Widget"));
     TipWidget->AddToViewport();
     TipWidget->SetVisibility(ESlateVisibility::Collapsed);
 }
 
-void AOWHUD::ShowTip(const FString& Text)
+// ==================== Tips ==================== //
+
+void AOWHUD::ShowTip(ETipMessage Tip, const UObject* Source)
+{
+    const bool bAlreadyAsked = TipRequests.ContainsByPredicate([Tip, Source](const FTipRequest& Request) {
+        return Request.Tip == Tip && Request.Source == Source;
+    });
+
+    if (!bAlreadyAsked) TipRequests.Add({ Tip, Source });
+
+    RefreshTip();
+}
+
+void AOWHUD::HideTip(ETipMessage Tip, const UObject* Source)
+{
+    TipRequests.RemoveAllSwap([Tip, Source](const FTipRequest& Request) {
+        return Request.Tip == Tip && Request.Source == Source;
+    });
+
+    RefreshTip();
+}
+
+void AOWHUD::HideTips(const UObject* Source)
+{
+    TipRequests.RemoveAllSwap([Source](const FTipRequest& Request) {
+        return Request.Source == Source;
+    });
+
+    RefreshTip();
+}
+
+void AOWHUD::RefreshTip()
+{
+    // Sources that went away without hiding their tip
+    TipRequests.RemoveAllSwap([](const FTipRequest& Request) {
+        return !Request.Source.IsValid();
+    });
+
+    ETipMessage Tip = ETipMessage::ETM_None;
+
+    for (const FTipRequest& Request : TipRequests)
+        if (GetTipDefinition(Request.Tip).Priority > GetTipDefinition(Tip).Priority) Tip = Request.Tip;
+
+    if (Tip == VisibleTip || !TipWidget) return;
+
+    VisibleTip = Tip;
+
+    if (Tip == ETipMessage::ETM_None) TipWidget->HideTip();
+    else TipWidget->ShowTip(GetTipDefinition(Tip).Text);
+}
+
+// ==================== Combat Overlay ==================== //
+
+void AOWHUD::AddCombatant(ACombatCharacter* Combatant, float HealthRatio)
+{
+    LLM_SCOPE_BYTAG(OW_UI);
+
+    FCombatant& Entry = Combatants.FindOrAdd(Combatant);
+    Entry.HealthRatio = HealthRatio;
+    Entry.bFriend     = Combatant->GetTeam() == ETeam::T_Friend;
+}
+
+void AOWHUD::RemoveCombatant(ACombatCharacter* Combatant)
+{
+    Combatants.Remove(Combatant);
+}
+
+void AOWHUD::UpdateHealth(ACombatCharacter* Combatant, float HealthRatio)
+{
+    if (FCombatant* Entry = Combatants.Find(Combatant)) Entry->HealthRatio = HealthRatio;
+}
+
+void AOWHUD::SetAttackIndicator(ACombatCharacter* Combatant, bool bVisible)
+{
+    if (FCombatant* Entry = Combatants.Find(Combatant)) Entry->bAttackIndicator = bVisible && !Entry->bFriend;
+}
+
+void AOWHUD::DrawHUD()
 {
-    TipWidget->ShowTip(Text);
+    LLM_SCOPE_BYTAG(OW_UI);
+
+    Super::DrawHUD();
+
+    if (!TipRequests.IsEmpty()) RefreshTip();
+
+    const double StartTime = FPlatformTime::Seconds();
+
+    DrawCombatOverlay();
+
+    if (BenchmarkEndTime > 0.0)
+    {
+        BenchmarkSeconds  += FPlatformTime::Seconds() - StartTime;
+        BenchmarkElements += OverlayElements.Num();
+        ++BenchmarkFrames;
+
+        if (FPlatformTime::Seconds() >= BenchmarkEndTime) FinishOverlayBenchmark();
+    }
 }
 
-void AOWHUD::HideTip()
+void AOWHUD::DrawCombatOverlay()
 {
-    TipWidget->HideTip();
+    OverlayElements.Reset();
+
+    if (Combatants.IsEmpty() || !Canvas || !PlayerOwner || !PlayerOwner->PlayerCameraManager) return;
+
+    const FVector ViewLocation  = PlayerOwner->PlayerCameraManager->GetCameraLocation();
+    const FVector ViewDirection = PlayerOwner->PlayerCameraManager->GetCameraRotation().Vector();
+
+    AOWCharacter* PlayerCharacter    = Cast<AOWCharacter>(GetOwningPawn());
+    const AOWCharacter* PlayerTarget = PlayerCharacter ? PlayerCharacter->GetTargetCombat() : nullptr;
+
+    // Candidates, on screen and recently rendered only
+    for (auto It = Combatants.CreateIterator(); It; ++It)
+    {
+        ACombatCharacter* Combatant = It.Key().Get();
+
+        if (!Combatant)
+        {
+            It.RemoveCurrent();
+            continue;
+        }
+
+        if (Combatant->IsHidden() || !Combatant->GetMesh()->WasRecentlyRendered(.2f)) continue;
+
+        const FVector Head = Combatant->GetActorLocation() + FVector(0.f, 0.f, Combatant->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() + OverlayHeightOffset);
+        const FVector ToHead = Head - ViewLocation;
+        const double DistanceSquared = ToHead.SizeSquared();
+
+        if (DistanceSquared > FMath::Square(OverlayMaxDistance) || (ToHead | ViewDirection) <= 0.0) continue;
+
+        const FVector Screen = Canvas->Project(Head);
+        if (Screen.X < 0.f || Screen.Y < 0.f || Screen.X > Canvas->ClipX || Screen.Y > Canvas->ClipY) continue;
+
+        // Lower draws first and survives the cut
+        const uint8 Group = It.Value().bAttackIndicator ? 0 : Combatant == PlayerTarget ? 1 : 2;
+
+        OverlayElements.Add({ FVector2D(Screen), &It.Value(), Group, DistanceSquared });
+    }
+
+    if (OverlayElements.Num() > MaxOverlayElements)
+    {
+        OverlayElements.Sort();
+        OverlayElements.SetNum(FMath::Max(MaxOverlayElements, 0), false);
+    }
+
+    // One pass per layer, consecutive tiles with the same texture end up in a single batch
+    FCanvasTileItem Tile(FVector2D::ZeroVector, GWhiteTexture, HealthBarSize, FLinearColor(0.f, 0.f, 0.f, .6f));
+    Tile.BlendMode = SE_BLEND_Translucent;
+
+    for (const FOverlayElement& Element : OverlayElements)
+    {
+        Tile.Position = Element.Position - HealthBarSize * .5f;
+        Canvas->DrawItem(Tile);
+    }
+
+    for (const FOverlayElement& Element : OverlayElements)
+    {
+        Tile.Position = Element.Position - HealthBarSize * .5f;
+        Tile.Size     = FVector2D(HealthBarSize.X * FMath::Clamp(Element.Combatant->HealthRatio, 0.f, 1.f), HealthBarSize.Y);
+        Tile.SetColor(Element.Combatant->bFriend ? FriendHealthColor : EnemyHealthColor);
+
+        Canvas->DrawItem(Tile);
+    }
+
+    // Attack indicators, a diamond above the bar
+    const float IndicatorSize = HealthBarSize.Y * 2.f;
+
+    FCanvasTileItem Indicator(FVector2D::ZeroVector, GWhiteTexture, FVector2D(IndicatorSize), AttackIndicatorColor);
+    Indicator.BlendMode  = SE_BLEND_Translucent;
+    Indicator.Rotation   = FRotator(0.f, 45.f, 0.f);
+    Indicator.PivotPoint = FVector2D(.5f);
+
+    for (const FOverlayElement& Element : OverlayElements)
+    {
+        if (!Element.Combatant->bAttackIndicator) continue;
+
+        Indicator.Position = Element.Position - FVector2D(IndicatorSize * .5f, HealthBarSize.Y * .5f + IndicatorSize * 2.f);
+        Canvas->DrawItem(Indicator);
+    }
+}
+
+// ==================== Benchmark ==================== //
+
+void AOWHUD::RunOverlayBenchmark(int32 Count, float Duration)
+{
+    if (BenchmarkEndTime > 0.0 || !PlayerOwner || !PlayerOwner->PlayerCameraManager) return;
+
+    UClass* EnemyClass = LoadClass<ACombatCharacter>(nullptr, TEXT("/Game/Game/Blueprints/Characters/BP_EnemyCharacter.BP_EnemyCharacter_C"));
+    if (!EnemyClass) EnemyClass = ACombatCharacter::StaticClass();
+
+    // A grid facing the camera, close enough to all be on screen
+    const FVector ViewLocation = PlayerOwner->PlayerCameraManager->GetCameraLocation();
+    const FRotator ViewYaw(0.f, PlayerOwner->PlayerCameraManager->GetCameraRotation().Yaw, 0.f);
+    const int32 Columns = FMath::CeilToInt32(FMath::Sqrt((float)Count));
+
+    UGroundHeightSubsystem* GroundHeights = GetWorld()->GetSubsystem<UGroundHeightSubsystem>();
+
+    for (int32 Index = 0; Index < Count; ++Index)
+    {
+        const FVector Offset(1000.f + Index / Columns * 150.f, (Index % Columns - Columns * .5f) * 150.f, 0.f);
+        FVector Location = ViewLocation + ViewYaw.RotateVector(Offset);
+
+        // Standing on the terrain, not floating at camera height
+        float GroundHeight;
+        if (GroundHeights && GroundHeights->GetGroundHeight(FVector2D(Location), GroundHeight)) Location.Z = GroundHeight + 100.f;
+
+        const FTransform Transform(ViewYaw + FRotator(0.f, 180.f, 0.f), Location);
+
+        // No AI, they would all come for the player
+        ACombatCharacter* Enemy = GetWorld()->SpawnActorDeferred<ACombatCharacter>(EnemyClass, Transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+        if (!Enemy) continue;
+
+        Enemy->AutoPossessAI = EAutoPossessAI::Disabled;
+        Enemy->FinishSpawning(Transform);
+
+        // Half of them attacking, so the indicators show up as well
+        if (Index % 2 == 0) SetAttackIndicator(Enemy, true);
+        UpdateHealth(Enemy, (Index % 10 + 1) / 10.f);
+
+        BenchmarkActors.Add(Enemy);
+    }
+
+    BenchmarkSeconds  = 0.0;
+    BenchmarkFrames   = 0;
+    BenchmarkElements = 0;
+    BenchmarkEndTime  = FPlatformTime::Seconds() + Duration;
+}
+
+void AOWHUD::FinishOverlayBenchmark()
+{
+    UE_LOG(LogTemp, Display, TEXT("Overlay benchmark, %d enemies, %d frames: %.3fms per frame, %.1f elements drawn per frame (max %d)"),
+        BenchmarkActors.Num(),
+        BenchmarkFrames,
+        BenchmarkFrames > 0 ? BenchmarkSeconds * 1000.0 / BenchmarkFrames : 0.0,
+        BenchmarkFrames > 0 ? (double)BenchmarkElements / BenchmarkFrames : 0.0,
+        MaxOverlayElements
+    );
+
+    for (const TWeakObjectPtr<AActor>& Actor : BenchmarkActors)
+    {
+        if (!Actor.IsValid()) continue;
+
+        if (ACombatCharacter* Enemy = Cast<ACombatCharacter>(Actor.Get()))
+            if (AActor* Weapon = Enemy->GetCarriedWeapon()) Weapon->Destroy();
+
+        Actor->Destroy();
+    }
+
+    BenchmarkActors.Empty();
+    BenchmarkEndTime = 0.0;
 }
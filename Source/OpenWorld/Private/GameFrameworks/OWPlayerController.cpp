@@ -1,11 +1,14 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "GameFrameworks/OWPlayerController.h"
+#include "Components/InputReplayComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "InputMappingContext.h"
 
 AOWPlayerController::AOWPlayerController()
 {
+    InputReplay = CreateDefaultSubobject<UInputReplayComponent>(TEXT("Input Replay"));
+
     DefaultInitializer();
 }
 
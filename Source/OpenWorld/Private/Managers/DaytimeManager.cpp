@@ -4,10 +4,13 @@
 #include "Components/DirectionalLightComponent.h"
 #include "Engine/DirectionalLight.h"
 #include "Kismet/GameplayStatics.h"
-#include "Kismet/KismetMathLibrary.h"
+#include "OpenWorld.h"
+#include "Subsystems/TimeOfDaySubsystem.h"
 
 ADaytimeManager::ADaytimeManager()
 {
+	LLM_SCOPE_BYTAG(OW_Environment);
+
 	PrimaryActorTick.bCanEverTick = true;
 	PrimaryActorTick.TickInterval = .5f;
 
@@ -45,11 +48,16 @@ void ADaytimeManager::ReferencesInitializer()
 	UGameplayStatics::GetAllActorsOfClass(this, ADirectionalLight::StaticClass(), DirectionalLights);
 
 	// Store it as references
-	if (!DirectionalLights.IsEmpty())
+	if (DirectionalLights.Num() > 1)
 	{
 		Sun  = !Sun.IsValid()  ? Cast<ADirectionalLight>(DirectionalLights[0]) : Sun;
 		Moon = !Moon.IsValid() ? Cast<ADirectionalLight>(DirectionalLights[1]) : Moon;
 	}
+
+	// Cache the light components once instead of looking them up on every update
+	SunLight  = Sun.IsValid()  ? Sun ->GetComponentByClass<UDirectionalLightComponent>() : nullptr;
+	MoonLight = Moon.IsValid() ? Moon->GetComponentByClass<UDirectionalLightComponent>() : nullptr;
+	AppliedNight = -1;
 }
 
 // ==================== Lifecycles ==================== //
@@ -62,8 +70,29 @@ void ADaytimeManager::OnConstruction(const FTransform& Transform)
 
 void ADaytimeManager::BeginPlay()
 {
+	LLM_SCOPE_BYTAG(OW_Environment);
+
 	Super::BeginPlay();
 
+	ReferencesInitializer();
+
+	// Start the world clock from the configured hour
+	TimeOfDay = GetWorld()->GetSubsystem<UTimeOfDaySubsystem>();
+
+	if (TimeOfDay.IsValid())
+	{
+		TimeOfDay->SetClock(Time, HoursPerSecond);
+		TimeOfDay->OnDayNightChanged.AddUObject(this, &ThisClass::ApplyDayNight);
+	}
+
+	UpdateTime();
+}
+
+void ADaytimeManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (TimeOfDay.IsValid()) TimeOfDay->OnDayNightChanged.RemoveAll(this);
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void ADaytimeManager::Tick(float DeltaTime)
@@ -77,34 +106,33 @@ void ADaytimeManager::Tick(float DeltaTime)
 
 void ADaytimeManager::UpdateTime()
 {
-	if (!Sun.IsValid() || !Moon.IsValid()) return;
+	OW_SCOPE_CYCLE_COUNTER(UpdateTime);
 
-	// Update timer
-	Time = Time + TimeRate;
-
-	if (Time > 24.f) Time = 0.f;
+	if (!Sun.IsValid() || !Moon.IsValid()) return;
 
-	// Calculate sun's angle based on the time
-	float Rotation = Time * (360.f / 24.f);
-	float Day	   = Rotation + 90.f;
-	float Night    = Rotation - 270.f;
-	float Angle    = Time > 18.f ? Night : Day;
+	// The clock lives on the subsystem, in the editor we simply preview the configured hour
+	if (TimeOfDay.IsValid()) Time = TimeOfDay->GetTime();
 
 	// Gimble Lock fix
 	FRotator CurrentRotation = GetActorRotation();
-	SetActorRotation(FRotator(0.f, CurrentRotation.Yaw, Angle));
+	SetActorRotation(FRotator(0.f, CurrentRotation.Yaw, UTimeOfDaySubsystem::GetSkyAngle(Time)));
 
-	FRotator NewRotation = UKismetMathLibrary::FindLookAtRotation(
-		SunScene->GetComponentLocation(),
-		GetActorLocation()
-	);
-	Sun->SetActorRotation(NewRotation);
+	Sun->SetActorRotation(UTimeOfDaySubsystem::GetSunRotation(Time, CurrentRotation.Yaw));
 
-	// Adjust moon/sun affecting world
-	bool bShouldAdjust = Time < 5.5f || Time > 17.5f;
+	// In game this is driven by the crossing event, @see BeginPlay
+	if (!TimeOfDay.IsValid()) ApplyDayNight(UTimeOfDaySubsystem::IsNightTime(Time));
+	else if (AppliedNight == -1) ApplyDayNight(TimeOfDay->IsNight());
+}
+
+void ADaytimeManager::ApplyDayNight(bool bNight)
+{
+	if (AppliedNight == (int8)bNight) return;
 
-	Sun ->GetComponentByClass<UDirectionalLightComponent>()->SetVisibility(!bShouldAdjust);
-	Moon->GetComponentByClass<UDirectionalLightComponent>()->SetVisibility(bShouldAdjust);
-	MoonMesh->SetHiddenInGame(!bShouldAdjust);
-	MoonMesh->SetVisibility(bShouldAdjust);
+	AppliedNight = bNight;
+
+	// Adjust moon/sun affecting world
+	if (SunLight.IsValid())  SunLight ->SetVisibility(!bNight);
+	if (MoonLight.IsValid()) MoonLight->SetVisibility(bNight);
+	MoonMesh->SetHiddenInGame(!bNight);
+	MoonMesh->SetVisibility(bNight);
 }
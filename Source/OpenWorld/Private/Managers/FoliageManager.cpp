@@ -0,0 +1,300 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Managers/FoliageManager.h"
+#include "Async/ParallelFor.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/Paths.h"
+#include "OpenWorld.h"
+#include "Subsystems/GroundHeightSubsystem.h"
+#include "Terrain/HeightmapR16.h"
+
+AFoliageManager::AFoliageManager()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	// Root Component
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Default Root Component"));
+	RootComponent->SetMobility(EComponentMobility::Static);
+}
+
+// ==================== Lifecycles ==================== //
+
+void AFoliageManager::BeginPlay()
+{
+	LLM_SCOPE_BYTAG(OW_Environment);
+
+	Super::BeginPlay();
+
+	if (bGenerateOnDemand && CellSize > 0.f)
+		GetWorldTimerManager().SetTimer(StreamingTimerHandle, this, &ThisClass::UpdateStreaming, StreamingInterval, true);
+}
+
+void AFoliageManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	GetWorldTimerManager().ClearTimer(StreamingTimerHandle);
+
+	// The workers must not outlive us
+	for (FPendingCell& Pending : PendingCells)
+		Pending.Task.Wait();
+
+	PendingCells.Empty();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+// ==================== Generating ==================== //
+
+void AFoliageManager::BuildAllCells()
+{
+	ClearCells();
+
+	if (CellSize <= 0.f) return;
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Terrain copies, from the heightmap file or the loaded landscape...
+	TArray<FIntPoint> Cells;
+	TArray<FScatterHeightfield> Heightfields;
+
+	if (!SourceHeightmap.FilePath.IsEmpty())
+	{
+		if (!CaptureFromHeightmap(Cells, Heightfields)) return;
+	}
+	else
+	{
+		UGroundHeightSubsystem* GroundHeights = GetWorld()->GetSubsystem<UGroundHeightSubsystem>();
+		const FBox Bounds = GroundHeights ? GroundHeights->GetLandscapeBounds() : FBox(ForceInit);
+
+		if (!Bounds.IsValid)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s: no landscape to scatter on"), *GetName());
+			return;
+		}
+
+		CaptureFromGround(Bounds, Cells, Heightfields);
+	}
+
+	// ...then the scatter itself on every core
+	TArray<TArray<TArray<FTransform>>> Results;
+	Results.SetNum(Cells.Num());
+
+	ParallelFor(Cells.Num(), [&](int32 Index)
+	{
+		Results[Index] = FFoliageScatter::ScatterCell(Heightfields[Index], Rules, Cells[Index], CellSize, Seed);
+	});
+
+	// Saved with the level
+	Modify();
+
+	int32 Instances = 0;
+
+	for (int32 Index = 0; Index < Cells.Num(); ++Index)
+	{
+		for (UHierarchicalInstancedStaticMeshComponent* Component : CreateCellComponents(Results[Index]))
+		{
+			AddInstanceComponent(Component);
+			BakedComponents.Add(Component);
+
+			Instances += Component->GetInstanceCount();
+		}
+
+		BakedCells.Add(Cells[Index]);
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("%s: baked %d cells, %d instances in %.2fs"), *GetName(), Cells.Num(), Instances, FPlatformTime::Seconds() - StartTime);
+}
+
+void AFoliageManager::ClearCells()
+{
+	Modify();
+
+	for (UHierarchicalInstancedStaticMeshComponent* Component : BakedComponents)
+	{
+		if (!Component) continue;
+
+		RemoveInstanceComponent(Component);
+		Component->DestroyComponent();
+	}
+
+	BakedComponents.Reset();
+	BakedCells.Reset();
+
+	for (const TPair<FIntPoint, TArray<TWeakObjectPtr<UHierarchicalInstancedStaticMeshComponent>>>& Pair : StreamedCells)
+		for (const TWeakObjectPtr<UHierarchicalInstancedStaticMeshComponent>& Component : Pair.Value)
+			if (Component.IsValid()) Component->DestroyComponent();
+
+	StreamedCells.Reset();
+}
+
+// ==================== Streaming ==================== //
+
+void AFoliageManager::UpdateStreaming()
+{
+	LLM_SCOPE_BYTAG(OW_Environment);
+
+	// Apply whatever the workers finished
+	for (int32 Index = PendingCells.Num() - 1; Index >= 0; --Index)
+	{
+		FPendingCell& Pending = PendingCells[Index];
+		if (!Pending.Task.IsCompleted()) continue;
+
+		TArray<TWeakObjectPtr<UHierarchicalInstancedStaticMeshComponent>>& Components = StreamedCells.FindOrAdd(Pending.Cell);
+
+		for (UHierarchicalInstancedStaticMeshComponent* Component : CreateCellComponents(Pending.Task.GetResult()))
+			Components.Add(Component);
+
+		PendingCells.RemoveAtSwap(Index);
+	}
+
+	APlayerCameraManager* CameraManager = UGameplayStatics::GetPlayerCameraManager(this, 0);
+	if (!CameraManager) return;
+
+	const FVector ViewLocation = CameraManager->GetCameraLocation();
+	const FIntPoint Center(FMath::FloorToInt32(ViewLocation.X / CellSize), FMath::FloorToInt32(ViewLocation.Y / CellSize));
+
+	// Drop what went out of range, with one extra ring so walking along a cell border doesn't keep rebuilding it
+	for (auto It = StreamedCells.CreateIterator(); It; ++It)
+	{
+		const FIntPoint Offset = It.Key() - Center;
+		if (FMath::Max(FMath::Abs(Offset.X), FMath::Abs(Offset.Y)) <= StreamingRadius + 1) continue;
+
+		for (const TWeakObjectPtr<UHierarchicalInstancedStaticMeshComponent>& Component : It.Value())
+			if (Component.IsValid()) Component->DestroyComponent();
+
+		It.RemoveCurrent();
+	}
+
+	// Start the nearest missing cell, one per update since the terrain copy is taken on the game thread
+	FIntPoint Nearest;
+	int32 NearestDistance = MAX_int32;
+
+	for (int32 Y = -StreamingRadius; Y <= StreamingRadius; ++Y)
+		for (int32 X = -StreamingRadius; X <= StreamingRadius; ++X)
+		{
+			const FIntPoint Cell = Center + FIntPoint(X, Y);
+			const int32 Distance = X * X + Y * Y;
+
+			if (Distance >= NearestDistance || StreamedCells.Contains(Cell) || BakedCells.Contains(Cell)) continue;
+			if (PendingCells.ContainsByPredicate([&Cell](const FPendingCell& Pending) { return Pending.Cell == Cell; })) continue;
+
+			Nearest = Cell;
+			NearestDistance = Distance;
+		}
+
+	if (NearestDistance == MAX_int32) return;
+
+	FScatterHeightfield Heightfield;
+
+	// Nothing to grow on (yet), try again once it went out of range and came back
+	if (!CaptureHeightfield(Nearest, Heightfield))
+	{
+		StreamedCells.Add(Nearest);
+		return;
+	}
+
+	PendingCells.Add({
+		Nearest,
+		UE::Tasks::Launch(UE_SOURCE_LOCATION, [Heightfield = MoveTemp(Heightfield), CellRules = Rules, Nearest, Size = CellSize, CellSeed = Seed]()
+		{
+			return FFoliageScatter::ScatterCell(Heightfield, CellRules, Nearest, Size, CellSeed);
+		})
+	});
+}
+
+// ==================== Helpers ==================== //
+
+bool AFoliageManager::CaptureHeightfield(const FIntPoint& Cell, FScatterHeightfield& OutHeightfield) const
+{
+	UGroundHeightSubsystem* GroundHeights = GetWorld()->GetSubsystem<UGroundHeightSubsystem>();
+	if (!GroundHeights) return false;
+
+	OutHeightfield.CaptureGround(*GroundHeights, FFoliageScatter::GetCellBounds(Cell, CellSize), HeightSpacing);
+
+	return OutHeightfield.HasGround();
+}
+
+void AFoliageManager::CaptureFromGround(const FBox& Bounds, TArray<FIntPoint>& OutCells, TArray<FScatterHeightfield>& OutHeightfields) const
+{
+	// The ground height cache is game thread only
+	for (int32 Y = FMath::FloorToInt32(Bounds.Min.Y / CellSize); Y <= FMath::FloorToInt32(Bounds.Max.Y / CellSize); ++Y)
+		for (int32 X = FMath::FloorToInt32(Bounds.Min.X / CellSize); X <= FMath::FloorToInt32(Bounds.Max.X / CellSize); ++X)
+		{
+			FScatterHeightfield Heightfield;
+			if (!CaptureHeightfield(FIntPoint(X, Y), Heightfield)) continue;
+
+			OutCells.Add(FIntPoint(X, Y));
+			OutHeightfields.Add(MoveTemp(Heightfield));
+		}
+}
+
+bool AFoliageManager::CaptureFromHeightmap(TArray<FIntPoint>& OutCells, TArray<FScatterHeightfield>& OutHeightfields) const
+{
+	FString Path = SourceHeightmap.FilePath;
+	if (FPaths::IsRelative(Path)) Path = FPaths::Combine(FPaths::ProjectDir(), Path);
+
+	FHeightmapR16 Heightmap;
+
+	if (!Heightmap.Open(Path))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s: can't open %s"), *GetName(), *Path);
+		return false;
+	}
+
+	FBox Bounds(ForceInit);
+	Bounds += HeightmapTransform.TransformPosition(FVector::ZeroVector);
+	Bounds += HeightmapTransform.TransformPosition(FVector(Heightmap.GetWidth() - 1, Heightmap.GetHeight() - 1, 0.f));
+
+	const FIntPoint MinCell(FMath::FloorToInt32(Bounds.Min.X / CellSize), FMath::FloorToInt32(Bounds.Min.Y / CellSize));
+	const FIntPoint MaxCell(FMath::FloorToInt32(Bounds.Max.X / CellSize), FMath::FloorToInt32(Bounds.Max.Y / CellSize));
+	const int32 Columns = MaxCell.X - MinCell.X + 1;
+
+	TArray<FScatterHeightfield> Captured;
+	Captured.SetNum(Columns * (MaxCell.Y - MinCell.Y + 1));
+
+	// Only reads the mapped file, so every cell is captured on the workers
+	ParallelFor(Captured.Num(), [&](int32 Index)
+	{
+		const FIntPoint Cell = MinCell + FIntPoint(Index % Columns, Index / Columns);
+		Captured[Index].CaptureHeightmap(Heightmap, HeightmapTransform, FFoliageScatter::GetCellBounds(Cell, CellSize), HeightSpacing);
+	});
+
+	for (int32 Index = 0; Index < Captured.Num(); ++Index)
+	{
+		if (!Captured[Index].HasGround()) continue;
+
+		OutCells.Add(MinCell + FIntPoint(Index % Columns, Index / Columns));
+		OutHeightfields.Add(MoveTemp(Captured[Index]));
+	}
+
+	return true;
+}
+
+TArray<UHierarchicalInstancedStaticMeshComponent*> AFoliageManager::CreateCellComponents(const TArray<TArray<FTransform>>& Transforms)
+{
+	TArray<UHierarchicalInstancedStaticMeshComponent*> Components;
+
+	for (int32 RuleIndex = 0; RuleIndex < Transforms.Num(); ++RuleIndex)
+	{
+		// Rules may have been edited while the cell was scattering
+		if (Transforms[RuleIndex].IsEmpty() || !Rules.IsValidIndex(RuleIndex) || !Rules[RuleIndex].Mesh) continue;
+
+		const FScatterRule& Rule = Rules[RuleIndex];
+
+		UHierarchicalInstancedStaticMeshComponent* Component = NewObject<UHierarchicalInstancedStaticMeshComponent>(this, NAME_None, RF_Transactional);
+		Component->SetMobility(EComponentMobility::Static);
+		Component->SetStaticMesh(Rule.Mesh);
+		Component->SetCullDistances(0, Rule.CullDistance);
+		Component->SetCollisionEnabled(Rule.bCollision ? ECollisionEnabled::QueryAndPhysics : ECollisionEnabled::NoCollision);
+		Component->SetupAttachment(RootComponent);
+		Component->RegisterComponent();
+
+		// All at once, the cluster tree is built a single time
+		Component->AddInstances(Transforms[RuleIndex], false, true);
+
+		Components.Add(Component);
+	}
+
+	return Components;
+}
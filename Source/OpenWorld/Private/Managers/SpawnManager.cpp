@@ -0,0 +1,258 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Managers/SpawnManager.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Characters/CombatCharacter.h"
+#include "Engine/AssetManager.h"
+#include "EngineUtils.h"
+#include "Kismet/GameplayStatics.h"
+#include "OpenWorld.h"
+#include "Weapons/MeleeWeapon.h"
+
+ASpawnManager::ASpawnManager()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	// Root Component
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Default Root Component"));
+	RootComponent->SetMobility(EComponentMobility::Static);
+}
+
+// ==================== Lifecycles ==================== //
+
+void ASpawnManager::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (CellSize > 0.f)
+		GetWorldTimerManager().SetTimer(StreamingTimerHandle, this, &ThisClass::UpdateStreaming, StreamingInterval, true);
+}
+
+void ASpawnManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	GetWorldTimerManager().ClearTimer(StreamingTimerHandle);
+
+	SpawnQueue.Empty();
+	ActiveActors.Empty();
+	ActiveCells.Empty();
+
+	// Releases the classes
+	ClassLoads.Empty();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+// ==================== Editor ==================== //
+
+void ASpawnManager::CaptureLevelActors()
+{
+#if WITH_EDITOR
+	if (CellSize <= 0.f) return;
+
+	Modify();
+
+	TArray<AActor*> Captured;
+
+	for (TActorIterator<ACombatCharacter> It(GetWorld()); It; ++It)
+		Captured.Add(*It);
+
+	// Weapons lying around, the carried ones come back with their character
+	for (TActorIterator<AMeleeWeapon> It(GetWorld()); It; ++It)
+		if (!It->GetOwner()) Captured.Add(*It);
+
+	for (AActor* Actor : Captured)
+		Demote(Actor, true);
+
+	UE_LOG(LogTemp, Display, TEXT("%s: captured %d actors into %d cells"), *GetName(), Captured.Num(), Cells.Num());
+#endif
+}
+
+void ASpawnManager::ClearCells()
+{
+	Modify();
+
+	Cells.Reset();
+}
+
+// ==================== Streaming ==================== //
+
+void ASpawnManager::UpdateStreaming()
+{
+	APlayerCameraManager* CameraManager = UGameplayStatics::GetPlayerCameraManager(this, 0);
+
+	if (CameraManager)
+	{
+		const FIntPoint Center = ToCell(CameraManager->GetCameraLocation());
+
+		DeactivateCells(Center);
+		ActivateCells(Center);
+	}
+
+	ProcessSpawnQueue();
+}
+
+void ASpawnManager::ActivateCells(const FIntPoint& Center)
+{
+	bool bQueued = false;
+
+	for (int32 Y = -StreamingRadius; Y <= StreamingRadius; ++Y)
+		for (int32 X = -StreamingRadius; X <= StreamingRadius; ++X)
+		{
+			const FIntPoint Cell = Center + FIntPoint(X, Y);
+
+			bool bAlreadyActive;
+			ActiveCells.Add(Cell, &bAlreadyActive);
+
+			if (bAlreadyActive) continue;
+
+			// The descriptors leave the cell while their actors exist
+			FSpawnCell SpawnCell;
+			if (!Cells.RemoveAndCopyValue(Cell, SpawnCell)) continue;
+
+			for (FSpawnDescriptor& Descriptor : SpawnCell.Spawns)
+				SpawnQueue.Add({ Cell, MoveTemp(Descriptor) });
+
+			bQueued = true;
+		}
+
+	if (bQueued)
+		SpawnQueue.StableSort([&Center](const FQueuedSpawn& A, const FQueuedSpawn& B) {
+			return (A.Cell - Center).SizeSquared() < (B.Cell - Center).SizeSquared();
+		});
+}
+
+void ASpawnManager::DeactivateCells(const FIntPoint& Center)
+{
+	for (auto It = ActiveCells.CreateIterator(); It; ++It)
+		if (!IsInRange(*It, Center, StreamingRadius + 1)) It.RemoveCurrent();
+
+	// Spawns that never happened go straight back
+	for (int32 Index = SpawnQueue.Num() - 1; Index >= 0; --Index)
+	{
+		if (ActiveCells.Contains(SpawnQueue[Index].Cell)) continue;
+
+		Cells.FindOrAdd(SpawnQueue[Index].Cell).Spawns.Add(MoveTemp(SpawnQueue[Index].Descriptor));
+		SpawnQueue.RemoveAt(Index, 1, false);
+	}
+
+	// Actors are judged by where they are now, not where they came from
+	for (int32 Index = ActiveActors.Num() - 1; Index >= 0; --Index)
+	{
+		AActor* Actor = ActiveActors[Index].Get();
+
+		if (Actor && IsInRange(ToCell(Actor->GetActorLocation()), Center, StreamingRadius + 1)) continue;
+		if (Actor) Demote(Actor, true);
+
+		ActiveActors.RemoveAtSwap(Index, 1, false);
+	}
+}
+
+void ASpawnManager::ProcessSpawnQueue()
+{
+	const double StartTime = FPlatformTime::Seconds();
+	const double Budget = SpawnBudgetMs / 1000.0;
+
+	int32 Index = 0;
+
+	while (Index < SpawnQueue.Num() && FPlatformTime::Seconds() - StartTime < Budget)
+	{
+		// Still loading, keep its place and try the next one
+		if (!Spawn(SpawnQueue[Index].Descriptor))
+		{
+			++Index;
+			continue;
+		}
+
+		SpawnQueue.RemoveAt(Index, 1, false);
+	}
+}
+
+bool ASpawnManager::Spawn(const FSpawnDescriptor& Descriptor)
+{
+	LLM_SCOPE_BYTAG(OW_Characters);
+
+	const bool bClassReady  = RequestClass(Descriptor.Class.ToSoftObjectPath());
+	const bool bWeaponReady = Descriptor.Weapon.IsNull() || RequestClass(Descriptor.Weapon.ToSoftObjectPath());
+
+	if (!bClassReady || !bWeaponReady) return false;
+
+	// Broken descriptor (class deleted), every load attempt failed
+	UClass* Class = Descriptor.Class.Get();
+	if (!Class) return true;
+
+	AActor* Actor = GetWorld()->SpawnActorDeferred<AActor>(Class, Descriptor.Transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
+	if (!Actor) return true;
+
+	// Before BeginPlay, that's where the weapon and the UI are set up
+	if (ACombatCharacter* CombatCharacter = Cast<ACombatCharacter>(Actor))
+		CombatCharacter->InitializeSpawn(Descriptor.Team, Descriptor.Weapon.Get(), Descriptor.Health);
+
+	Actor->FinishSpawning(Descriptor.Transform);
+
+	ActiveActors.Add(Actor);
+
+	return true;
+}
+
+void ASpawnManager::Demote(AActor* Actor, bool bKeep)
+{
+	AMeleeWeapon* CarriedWeapon = nullptr;
+
+	FSpawnDescriptor Descriptor;
+	Descriptor.Class     = Actor->GetClass();
+	Descriptor.Transform = Actor->GetActorTransform();
+
+	if (ACombatCharacter* CombatCharacter = Cast<ACombatCharacter>(Actor))
+	{
+		CarriedWeapon = CombatCharacter->GetCarriedWeapon();
+
+		// Corpses aren't worth remembering
+		bKeep &= !CombatCharacter->IsDead();
+
+		Descriptor.Team   = CombatCharacter->GetTeam();
+		Descriptor.Weapon = CarriedWeapon ? CarriedWeapon->GetClass() : nullptr;
+		Descriptor.Health = CombatCharacter->GetHealth();
+	}
+
+	if (bKeep) Cells.FindOrAdd(ToCell(Descriptor.Transform.GetLocation())).Spawns.Add(MoveTemp(Descriptor));
+
+#if WITH_EDITOR
+	if (!GetWorld()->IsGameWorld())
+	{
+		if (CarriedWeapon) GetWorld()->EditorDestroyActor(CarriedWeapon, true);
+		GetWorld()->EditorDestroyActor(Actor, true);
+
+		return;
+	}
+#endif
+
+	if (CarriedWeapon) CarriedWeapon->Destroy();
+	Actor->Destroy();
+}
+
+bool ASpawnManager::RequestClass(const FSoftObjectPath& Path)
+{
+	if (Path.IsNull()) return true;
+
+	FClassLoad& Load = ClassLoads.FindOrAdd(Path);
+
+	if (Load.Handle.IsValid())
+	{
+		if (Load.Handle->IsLoadingInProgress()) return false;
+		if (Path.ResolveObject()) return true;
+	}
+
+	// Not requested yet, or done and still not there (e.g. collected before we held it), ask again
+	if (Load.Attempts >= MaxClassLoadAttempts)
+	{
+		// Gone for good, the spawn gives up instead of waiting forever
+		return true;
+	}
+
+	++Load.Attempts;
+
+	// Already loaded classes complete right away, the handle still holds them from now on
+	Load.Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(Path);
+
+	return Load.Handle.IsValid() && !Load.Handle->IsLoadingInProgress() && Path.ResolveObject();
+}
@@ -4,13 +4,25 @@
 #include "Components/SkyAtmosphereComponent.h"
 #include "Components/VolumetricCloudComponent.h"
 #include "Environments/RainThunder.h"
+#include "EngineUtils.h"
 #include "GameFramework/GameModeBase.h"
 #include "Kismet/GameplayStatics.h"
-#include "Materials/MaterialParameterCollection.h"
-#include "Materials/MaterialParameterCollectionInstance.h"
+#include "OpenWorld.h"
+
+static FAutoConsoleCommandWithWorld WeatherStatsCommand(
+	TEXT("ow.Weather.Stats"),
+	TEXT("Print how many render updates the last weather transition cost"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		for (TActorIterator<AWeatherManager> It(World); It; ++It)
+			It->DumpTransitionStats();
+	})
+);
 
 AWeatherManager::AWeatherManager()
 {
+	LLM_SCOPE_BYTAG(OW_Environment);
+
 	// Actor
 	PrimaryActorTick.bCanEverTick 		   = true;
 	PrimaryActorTick.bStartWithTickEnabled = false;
@@ -20,11 +32,6 @@ AWeatherManager::AWeatherManager()
 
 void AWeatherManager::DefaultInitializer()
 {
-	static ConstructorHelpers::FObjectFinder<UMaterialParameterCollection> GlobalParamAsset(
-		TEXT("/Script/Engine.MaterialParameterCollection'/Game/Game/Materials/MP_Global.MP_Global'")
-	);
-	GlobalMatParam = GlobalParamAsset.Object;
-
 	static ConstructorHelpers::FObjectFinder<UMaterialInterface> CloudMatAsset(
 		TEXT("/Script/Engine.MaterialInstanceConstant'/Game/Game/Materials/Skies/MI_Cloud.MI_Cloud'")
 	);
@@ -39,8 +46,8 @@ void AWeatherManager::DefaultInitializer()
 void AWeatherManager::ReferencesInitializer()
 {
 	// Global Params
-	GlobalMatParamIns = GetWorld()->GetParameterCollectionInstance(GlobalMatParam.LoadSynchronous());
-	PlayerPawn 		  = UGameplayStatics::GetPlayerPawn(this, 0);
+	GlobalParams = GetWorld()->GetSubsystem<UGlobalParamSubsystem>();
+	PlayerPawn 	 = UGameplayStatics::GetPlayerPawn(this, 0);
 
 	// Lightings
 	SkyAtmosphere 	  = Cast<ASkyAtmosphere>  (UGameplayStatics::GetActorOfClass(this, ASkyAtmosphere  ::StaticClass()));
@@ -50,32 +57,41 @@ void AWeatherManager::ReferencesInitializer()
 	UVolumetricCloudComponent* CloudComponent = VolumetricCloud->GetComponentByClass<UVolumetricCloudComponent>();
 	CloudMaterial = UMaterialInstanceDynamic::Create(CloudParentMaterial.LoadSynchronous(), this);
 	CloudComponent->SetMaterial(CloudMaterial);
+
+	if (GlobalParams.IsValid())
+	{
+		CloudDensityParam   = GlobalParams->ResolveMaterialScalar(CloudMaterial, TEXT("Cloud Density"), CurrentCloudDensity, CloudDensityQuantization);
+		CloudIntensityParam = GlobalParams->ResolveMaterialScalar(CloudMaterial, TEXT("Erosion Intensity"), CurrentCloudIntensity, CloudIntensityQuantization);
+	}
 }
 
 // ==================== Lifecycles ==================== //
 
 void AWeatherManager::BeginPlay()
 {
+	LLM_SCOPE_BYTAG(OW_Environment);
+
 	Super::BeginPlay();
 
 	ReferencesInitializer();
 	PrepareEnvironments();
 
-	// TESTING PURPOSE!!!
-	// FTimerHandle Handle;
-	// GetWorldTimerManager().SetTimer(
-	// 	Handle, [this]() { SetLightingValues(FLinearColor(.411458f, .411458f, .411458f), 1.f, -1.f); }, 3.f, false
-	// );
-	// FTimerHandle RainHandle;
-	// GetWorldTimerManager().SetTimer(
-	// 	RainHandle, [this]() { RainThunder->ToggleRain(true); RainThunder->ToggleThunder(true); }, 6.f, false
-	// );
-	// FTimerHandle StopHandle;
-	// GetWorldTimerManager().SetTimer(StopHandle, [&] () {
-	// 	RainThunder->ToggleThunder(false);
-	// 	RainThunder->ToggleRain(false);
-	// 	SetLightingValues(FLinearColor(.175287f, .409607f, 1.f), .1f, 1.f); 
-	// }, 66.f, false);
+	// Transitions are slow, no need to evaluate them every frame
+	SetActorTickInterval(LightingUpdateRate > 0.f ? 1.f / LightingUpdateRate : 0.f);
+
+	// Regional weather
+	WeatherGrid.Initialize(WeatherGridDimension, WeatherCellSize, WeatherSeed);
+
+	GetWorldTimerManager().SetTimer(SimulationTimerHandle, this, &ThisClass::SimulateWeather, SimulationInterval, true);
+	GetWorldTimerManager().SetTimer(LocalWeatherTimerHandle, this, &ThisClass::UpdateLocalWeather, LocalWeatherInterval, true);
+}
+
+void AWeatherManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// The background step must not outlive us
+	if (SimulationTask.IsValid()) SimulationTask.Wait();
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AWeatherManager::Tick(float DeltaTime)
@@ -92,6 +108,8 @@ void AWeatherManager::Tick(float DeltaTime)
 
 void AWeatherManager::ChangeLightingValues(float DeltaTime)
 {
+	OW_SCOPE_CYCLE_COUNTER(ChangeLightingValues);
+
 	if (!bChangingLighting) return;
 
 	// Get smooth changing result by using interpolation
@@ -99,14 +117,78 @@ void AWeatherManager::ChangeLightingValues(float DeltaTime)
 	CurrentCloudIntensity  = FMath::FInterpConstantTo(CurrentCloudIntensity, TargetCloudIntensity, DeltaTime, 0.9f);
 	CurrentAtmosphereColor = InterpLinearColor(DeltaTime, .09f);
 
-	// Apply
-	CloudMaterial->SetScalarParameterValue(TEXT("Cloud Density"), CurrentCloudDensity);
-	CloudMaterial->SetScalarParameterValue(TEXT("Erosion Intensity"), CurrentCloudIntensity);
-	SkyAtmosphere->GetComponent()->SetRayleighScattering(CurrentAtmosphereColor);
+	++TransitionStats.Evaluations;
+
+	// Stop changing once everything reached the target
+	bool bFinished = FMath::IsNearlyEqual(CurrentCloudDensity, TargetCloudDensity, .0001f) &&
+					 FMath::IsNearlyEqual(CurrentCloudIntensity, TargetCloudIntensity, .0001f) &&
+					 CurrentAtmosphereColor.Equals(TargetAtmosphereColor, .0001f);
 
-	// Stop changing once its nearly equal
-	if (FMath::IsNearlyEqual(CurrentCloudDensity, TargetCloudDensity, .0001f))
+	ApplyLightingValues(bFinished);
+
+	if (bFinished)
+	{
 		bChangingLighting = false;
+
+		TransitionStats.Frames   = GFrameCounter - TransitionStats.StartFrame;
+		TransitionStats.Duration = GetWorld()->GetTimeSeconds() - TransitionStats.StartTime;
+	}
+}
+
+void AWeatherManager::ApplyLightingValues(bool bForce)
+{
+	int32 Pushed = 0;
+
+	// Clouds, quantized by the param thresholds @see ReferencesInitializer
+	if (GlobalParams.IsValid())
+	{
+		Pushed += GlobalParams->SetScalar(CloudDensityParam, CurrentCloudDensity, bForce);
+		Pushed += GlobalParams->SetScalar(CloudIntensityParam, CurrentCloudIntensity, bForce);
+	}
+
+	// Sky atmosphere, each push invalidates the sky LUTs so only do it when the color visibly changed
+	bool bVisible = !PushedAtmosphereColor.Equals(CurrentAtmosphereColor, AtmosphereQuantization);
+	bool bChanged = PushedAtmosphereColor != CurrentAtmosphereColor;
+
+	if (SkyAtmosphere.IsValid() && (bVisible || (bForce && bChanged)))
+	{
+		SkyAtmosphere->GetComponent()->SetRayleighScattering(CurrentAtmosphereColor);
+		PushedAtmosphereColor = CurrentAtmosphereColor;
+
+		++Pushed;
+	}
+
+	// Unthrottled, every value that changed since the last evaluation would have been pushed on each frame in between
+	int32 Changed = (CurrentCloudDensity != TransitionStats.EvaluatedCloudDensity) +
+					(CurrentCloudIntensity != TransitionStats.EvaluatedCloudIntensity) +
+					(CurrentAtmosphereColor != TransitionStats.EvaluatedAtmosphereColor);
+	int32 Frames  = FMath::Max((int32)(GFrameCounter - TransitionStats.EvaluatedFrame), 1);
+
+	TransitionStats.RenderUpdates 		  += Pushed;
+	TransitionStats.UnthrottledUpdates    += Changed * Frames;
+	TransitionStats.SkippedByQuantization += FMath::Max(Changed - Pushed, 0);
+	TransitionStats.SkippedByInterval 	  += Changed * (Frames - 1);
+
+	TransitionStats.EvaluatedFrame 			 = GFrameCounter;
+	TransitionStats.EvaluatedCloudDensity 	 = CurrentCloudDensity;
+	TransitionStats.EvaluatedCloudIntensity  = CurrentCloudIntensity;
+	TransitionStats.EvaluatedAtmosphereColor = CurrentAtmosphereColor;
+}
+
+void AWeatherManager::DumpTransitionStats() const
+{
+	int32 Frames = bChangingLighting ? (int32)(GFrameCounter - TransitionStats.StartFrame) : TransitionStats.Frames;
+
+	UE_LOG(LogTemp, Display, TEXT("Weather transition%s: %d render updates over %d evaluations (%.1fs, %d frames), %d updates unthrottled, %d skipped by quantization, %d by the tick interval"),
+		bChangingLighting ? TEXT(" (in progress)") : TEXT(""),
+		TransitionStats.RenderUpdates,
+		TransitionStats.Evaluations,
+		bChangingLighting ? GetWorld()->GetTimeSeconds() - TransitionStats.StartTime : TransitionStats.Duration,
+		Frames,
+		TransitionStats.UnthrottledUpdates,
+		TransitionStats.SkippedByQuantization,
+		TransitionStats.SkippedByInterval
+	);
 }
 
 void AWeatherManager::SetLightingValues(const FLinearColor& AtmosphereColor, float CloudDensity, float CloudIntensity)
@@ -115,6 +197,19 @@ void AWeatherManager::SetLightingValues(const FLinearColor& AtmosphereColor, flo
 	TargetCloudDensity 	  = CloudDensity;
 	TargetCloudIntensity  = CloudIntensity;
 
+	// Restart the cost tracking only when starting from rest, retargeting keeps counting the same transition
+	if (!bChangingLighting)
+	{
+		TransitionStats = FTransitionStats();
+		TransitionStats.StartFrame = GFrameCounter;
+		TransitionStats.StartTime  = GetWorld()->GetTimeSeconds();
+
+		TransitionStats.EvaluatedFrame 			 = GFrameCounter;
+		TransitionStats.EvaluatedCloudDensity 	 = CurrentCloudDensity;
+		TransitionStats.EvaluatedCloudIntensity  = CurrentCloudIntensity;
+		TransitionStats.EvaluatedAtmosphereColor = CurrentAtmosphereColor;
+	}
+
 	bChangingLighting = true;
 	SetActorTickEnabled(true);
 }
@@ -137,5 +232,75 @@ void AWeatherManager::PrepareEnvironments()
 {
 	// Thunder
 	RainThunder = GetWorld()->SpawnActor<ARainThunder>(RainThunderClass);
-	RainThunder->SetGlobalMatParamIns(GlobalMatParamIns.Get());
+}
+
+// ==================== Weather Cells ==================== //
+
+void AWeatherManager::SimulateWeather()
+{
+	++PendingSimulationSteps;
+
+	// Still busy, never block the game thread on it. The step is owed, not dropped: the next launch catches up,
+	// so the grid goes through exactly one step per interval however long the background task takes
+	if (SimulationTask.IsValid())
+	{
+		if (!SimulationTask.IsCompleted()) return;
+
+		WeatherGrid.SetState(MoveTemp(SimulationTask.GetResult()));
+	}
+
+	SimulationTask = UE::Tasks::Launch(
+		UE_SOURCE_LOCATION,
+		[State = WeatherGrid.GetState(), Dimension = WeatherGrid.GetDimension(), DeltaSeconds = SimulationInterval, Steps = PendingSimulationSteps]() mutable
+		{
+			for (int32 Step = 0; Step < Steps; ++Step)
+				State = FWeatherCellGrid::Step(MoveTemp(State), Dimension, DeltaSeconds);
+
+			return State;
+		},
+		UE::Tasks::ETaskPriority::BackgroundLow
+	);
+
+	PendingSimulationSteps = 0;
+}
+
+void AWeatherManager::UpdateLocalWeather()
+{
+	if (!PlayerPawn.IsValid()) return;
+
+	const FWeatherCell Local = WeatherGrid.Sample(PlayerPawn->GetActorLocation());
+
+	// Lighting, only retarget when the change is noticeable, @see ChangeLightingValues for the smoothing
+	if (FMath::Abs(Local.Cloudiness - AppliedCloudiness) > .02f)
+	{
+		AppliedCloudiness = Local.Cloudiness;
+
+		SetLightingValues(
+			FMath::Lerp(FLinearColor(.175287f, .409607f, 1.f), FLinearColor(.411458f, .411458f, .411458f), Local.Cloudiness),
+			FMath::Lerp(.1f, 1.f, Local.Cloudiness),
+			FMath::Lerp(1.f, -1.f, Local.Cloudiness)
+		);
+	}
+
+	if (!RainThunder) return;
+
+	// Rain/thunder with a bit of hysteresis so walking along a cell border doesn't toggle it back and forth
+	if (!bLocalRaining && Local.Rain > .5f)
+	{
+		bLocalRaining = true;
+		RainThunder->ToggleRain(true);
+	}
+	else if (bLocalRaining && Local.Rain < .3f)
+	{
+		bLocalRaining = false;
+		RainThunder->ToggleRain(false);
+	}
+
+	bool bShouldThunder = bLocalRaining && Local.Rain > .8f;
+
+	if (bShouldThunder != bLocalThunder)
+	{
+		bLocalThunder = bShouldThunder;
+		RainThunder->ToggleThunder(bLocalThunder);
+	}
 }
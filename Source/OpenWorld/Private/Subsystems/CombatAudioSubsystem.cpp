@@ -0,0 +1,236 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Subsystems/CombatAudioSubsystem.h"
+#include "Components/AudioComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Sound/SoundBase.h"
+
+static int32 GCombatAudioPoolSize = 24;
+static FAutoConsoleVariableRef CVarCombatAudioPoolSize(
+	TEXT("ow.Audio.PoolSize"),
+	GCombatAudioPoolSize,
+	TEXT("Maximum number of pooled audio components used by combat sounds")
+);
+
+static float GCombatAudioCollapseRadius = 200.f;
+static FAutoConsoleVariableRef CVarCombatAudioCollapseRadius(
+	TEXT("ow.Audio.CollapseRadius"),
+	GCombatAudioCollapseRadius,
+	TEXT("Same sound requested within this radius on the same frame is only played once")
+);
+
+static float GCombatAudioCullDistance = 5000.f;
+static FAutoConsoleVariableRef CVarCombatAudioCullDistance(
+	TEXT("ow.Audio.CullDistance"),
+	GCombatAudioCullDistance,
+	TEXT("Combat sounds further than this from the listener are never started")
+);
+
+/** Voice limit per ECombatSoundCategory */
+static const int32 GCombatAudioVoiceLimits[] = { 6, 4, 3, 8, 2 };
+static_assert(UE_ARRAY_COUNT(GCombatAudioVoiceLimits) == (int32)ECombatSoundCategory::ECSC_Max, "Every sound category needs a voice limit");
+
+static FAutoConsoleCommandWithWorld CombatAudioStatsCommand(
+	TEXT("ow.Audio.Stats"),
+	TEXT("Print requested vs played combat sounds since the last reset"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (UCombatAudioSubsystem* Subsystem = World ? World->GetSubsystem<UCombatAudioSubsystem>() : nullptr)
+			Subsystem->DumpStats();
+	})
+);
+
+static FAutoConsoleCommandWithWorld CombatAudioResetStatsCommand(
+	TEXT("ow.Audio.ResetStats"),
+	TEXT("Reset the combat audio counters"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (UCombatAudioSubsystem* Subsystem = World ? World->GetSubsystem<UCombatAudioSubsystem>() : nullptr)
+			Subsystem->ResetStats();
+	})
+);
+
+// ==================== Lifecycles ==================== //
+
+bool UCombatAudioSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatAudioSubsystem::Deinitialize()
+{
+	for (UAudioComponent* Component : Pool)
+		if (Component) Component->DestroyComponent();
+
+	Pool.Empty();
+	PoolCategories.Empty();
+	PendingRequests.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UCombatAudioSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatAudioSubsystem, STATGROUP_Tickables);
+}
+
+void UCombatAudioSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (PendingRequests.IsEmpty()) return;
+
+	// Listener
+	FVector ListenerLocation = FVector::ZeroVector;
+	bool bHasListener = false;
+
+	if (APlayerController* PlayerController = GetWorld()->GetFirstPlayerController())
+	{
+		FVector Front, Right;
+		PlayerController->GetAudioListenerPosition(ListenerLocation, Front, Right);
+		bHasListener = true;
+	}
+
+	// Count what is still playing once, then keep it updated while starting new voices
+	int32 ActiveVoices[(int32)ECombatSoundCategory::ECSC_Max];
+	for (int32 I = 0; I < (int32)ECombatSoundCategory::ECSC_Max; ++I)
+		ActiveVoices[I] = CountActiveVoices((ECombatSoundCategory)I);
+
+	for (const FSoundRequest& Request : PendingRequests)
+	{
+		USoundBase* Sound = Request.Sound.Get();
+
+		if (!Sound || (bHasListener && !IsAudible(Request, ListenerLocation)))
+		{
+			++Stats.Culled;
+			continue;
+		}
+
+		const int32 CategoryIndex = (int32)Request.Category;
+
+		if (ActiveVoices[CategoryIndex] >= GCombatAudioVoiceLimits[CategoryIndex])
+		{
+			++Stats.Limited;
+			continue;
+		}
+
+		UAudioComponent* Component = AcquireComponent(Request.Category);
+
+		if (!Component)
+		{
+			++Stats.Limited;
+			continue;
+		}
+
+		Component->SetSound(Sound);
+		Component->bAllowSpatialization = !Request.b2D;
+		Component->bIsUISound           = Request.b2D;
+		Component->SetWorldLocation(Request.Location);
+		Component->SetVolumeMultiplier(Request.VolumeMultiplier);
+		Component->SetPitchMultiplier(Request.PitchMultiplier);
+		Component->Play();
+
+		++ActiveVoices[CategoryIndex];
+		++Stats.Played;
+	}
+
+	PendingRequests.Reset();
+}
+
+// ==================== Interfaces ==================== //
+
+void UCombatAudioSubsystem::PlaySoundAtLocation(USoundBase* Sound, ECombatSoundCategory Category, const FVector& Location, float VolumeMultiplier, float PitchMultiplier)
+{
+	QueueRequest({ Sound, Category, Location, VolumeMultiplier, PitchMultiplier, false });
+}
+
+void UCombatAudioSubsystem::PlaySound2D(USoundBase* Sound, ECombatSoundCategory Category)
+{
+	QueueRequest({ Sound, Category, FVector::ZeroVector, 1.f, 1.f, true });
+}
+
+// ==================== Requests ==================== //
+
+void UCombatAudioSubsystem::QueueRequest(const FSoundRequest& Request)
+{
+	if (!Request.Sound.IsValid()) return;
+
+	++Stats.Requested;
+
+	// Collapse the same sound on the same area into one, keeping the loudest
+	const float CollapseRadiusSq = FMath::Square(GCombatAudioCollapseRadius);
+
+	for (FSoundRequest& Pending : PendingRequests)
+	{
+		if (Pending.Sound != Request.Sound || Pending.b2D != Request.b2D) continue;
+		if (!Request.b2D && FVector::DistSquared(Pending.Location, Request.Location) > CollapseRadiusSq) continue;
+
+		Pending.VolumeMultiplier = FMath::Max(Pending.VolumeMultiplier, Request.VolumeMultiplier);
+		++Stats.Collapsed;
+
+		return;
+	}
+
+	PendingRequests.Add(Request);
+}
+
+bool UCombatAudioSubsystem::IsAudible(const FSoundRequest& Request, const FVector& ListenerLocation) const
+{
+	if (Request.b2D) return true;
+
+	const float MaxDistance = FMath::Min(GCombatAudioCullDistance, Request.Sound->GetMaxDistance());
+
+	return FVector::DistSquared(ListenerLocation, Request.Location) <= FMath::Square(MaxDistance);
+}
+
+// ==================== Pool ==================== //
+
+UAudioComponent* UCombatAudioSubsystem::AcquireComponent(ECombatSoundCategory Category)
+{
+	// Reuse the finished one first
+	for (int32 I = 0; I < Pool.Num(); ++I)
+		if (Pool[I] && !Pool[I]->IsPlaying())
+		{
+			PoolCategories[I] = Category;
+
+			return Pool[I];
+		}
+
+	if (Pool.Num() >= GCombatAudioPoolSize) return nullptr;
+
+	UAudioComponent* Component = NewObject<UAudioComponent>(this);
+	Component->bAutoActivate = false;
+	Component->bAutoDestroy  = false;
+	Component->bStopWhenOwnerDestroyed = false;
+	Component->RegisterComponentWithWorld(GetWorld());
+
+	Pool.Add(Component);
+	PoolCategories.Add(Category);
+
+	return Component;
+}
+
+int32 UCombatAudioSubsystem::CountActiveVoices(ECombatSoundCategory Category) const
+{
+	int32 Count = 0;
+
+	for (int32 I = 0; I < Pool.Num(); ++I)
+		if (PoolCategories[I] == Category && Pool[I] && Pool[I]->IsPlaying()) ++Count;
+
+	return Count;
+}
+
+// ==================== Stats ==================== //
+
+void UCombatAudioSubsystem::ResetStats()
+{
+	Stats = FAudioStats();
+}
+
+void UCombatAudioSubsystem::DumpStats() const
+{
+	UE_LOG(LogTemp, Display, TEXT("Combat Audio: Requested %d | Played %d | Collapsed %d | Culled %d | Limited %d | Pool %d"),
+		Stats.Requested, Stats.Played, Stats.Collapsed, Stats.Culled, Stats.Limited, Pool.Num()
+	);
+}
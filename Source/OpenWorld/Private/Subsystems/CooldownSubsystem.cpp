@@ -0,0 +1,111 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Subsystems/CooldownSubsystem.h"
+#include "Components/CooldownComponent.h"
+#include "Engine/World.h"
+
+// ==================== Lifecycles ==================== //
+
+bool UCooldownSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCooldownSubsystem::Deinitialize()
+{
+	ExpireTimes.Empty();
+	ActiveMasks.Empty();
+	Owners.Empty();
+	FreeHandles.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UCooldownSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCooldownSubsystem, STATGROUP_Tickables);
+}
+
+void UCooldownSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	// Handlers may start, stop or register anything, so nothing is cached across calls
+	for (int32 Handle = 0; Handle < ActiveMasks.Num(); ++Handle)
+	{
+		uint16 Pending = ActiveMasks[Handle];
+
+		while (Pending)
+		{
+			const uint8 Slot = FMath::CountTrailingZeros(Pending);
+			Pending &= Pending - 1;
+
+			const uint16 Bit = 1 << Slot;
+
+			// Stopped by an earlier handler, or not yet
+			if (!(ActiveMasks[Handle] & Bit) || ExpireTimes[Handle * Stride + Slot] > Now) continue;
+
+			ActiveMasks[Handle] &= ~Bit;
+
+			if (UCooldownComponent* Owner = Owners[Handle]) Owner->OnExpired((ECooldown)Slot);
+		}
+	}
+}
+
+// ==================== Owners ==================== //
+
+int32 UCooldownSubsystem::Register(UCooldownComponent* Component)
+{
+	int32 Handle;
+
+	if (FreeHandles.IsEmpty())
+	{
+		Handle = Owners.Add(Component);
+		ActiveMasks.Add(0);
+		ExpireTimes.AddZeroed(Stride);
+	}
+	else
+	{
+		Handle = FreeHandles.Pop(false);
+		Owners[Handle] = Component;
+	}
+
+	return Handle;
+}
+
+void UCooldownSubsystem::Unregister(int32 Handle)
+{
+	if (!Owners.IsValidIndex(Handle)) return;
+
+	Owners[Handle]      = nullptr;
+	ActiveMasks[Handle] = 0;
+
+	FreeHandles.Add(Handle);
+}
+
+// ==================== Cooldowns ==================== //
+
+void UCooldownSubsystem::Start(int32 Handle, ECooldown Cooldown, float Duration)
+{
+	ExpireTimes[Handle * Stride + (uint8)Cooldown] = GetWorld()->GetTimeSeconds() + FMath::Max(Duration, 0.f);
+	ActiveMasks[Handle] |= GetBit(Cooldown);
+}
+
+void UCooldownSubsystem::Stop(int32 Handle, ECooldown Cooldown)
+{
+	ActiveMasks[Handle] &= ~GetBit(Cooldown);
+}
+
+void UCooldownSubsystem::StopAll(int32 Handle)
+{
+	ActiveMasks[Handle] = 0;
+}
+
+float UCooldownSubsystem::GetRemaining(int32 Handle, ECooldown Cooldown) const
+{
+	if (!IsActive(Handle, Cooldown)) return 0.f;
+
+	return FMath::Max(ExpireTimes[Handle * Stride + (uint8)Cooldown] - GetWorld()->GetTimeSeconds(), 0.0);
+}
@@ -0,0 +1,219 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Subsystems/DecalSubsystem.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Components/DecalComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "OpenWorld.h"
+
+static int32 GDecalCapacity = 48;
+static FAutoConsoleVariableRef CVarDecalCapacity(
+	TEXT("ow.Decal.Capacity"),
+	GDecalCapacity,
+	TEXT("Maximum number of pooled decal components (only read while the pool is growing)")
+);
+
+static int32 GDecalMaxSpawnsPerFrame = 4;
+static FAutoConsoleVariableRef CVarDecalMaxSpawnsPerFrame(
+	TEXT("ow.Decal.MaxSpawnsPerFrame"),
+	GDecalMaxSpawnsPerFrame,
+	TEXT("Maximum number of new decals placed per frame, the rest are dropped")
+);
+
+static float GDecalCullDistance = 4000.f;
+static FAutoConsoleVariableRef CVarDecalCullDistance(
+	TEXT("ow.Decal.CullDistance"),
+	GDecalCullDistance,
+	TEXT("Decal requests further than this from the camera are dropped")
+);
+
+static float GDecalMergeRadius = 30.f;
+static FAutoConsoleVariableRef CVarDecalMergeRadius(
+	TEXT("ow.Decal.MergeRadius"),
+	GDecalMergeRadius,
+	TEXT("Splatters landing within this radius of an active one are merged into it")
+);
+
+// ==================== Lifecycles ==================== //
+
+bool UDecalSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UDecalSubsystem::Deinitialize()
+{
+	for (UDecalComponent* Decal : Pool)
+		if (Decal) Decal->DestroyComponent();
+
+	Pool.Empty();
+	Slots.Empty();
+	FreeSlots.Empty();
+	ActiveCount = 0;
+
+	Super::Deinitialize();
+}
+
+TStatId UDecalSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDecalSubsystem, STATGROUP_Tickables);
+}
+
+void UDecalSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	CSV_CUSTOM_STAT(OpenWorldPopulation, Decals, ActiveCount, ECsvCustomStatOp::Set);
+
+	if (ActiveCount == 0) return;
+
+	// Hide the expired ones so they stop costing anything on the render side
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	for (int32 I = 0; I < Slots.Num(); ++I)
+		if (Slots[I].bActive && Slots[I].ExpireTime <= Now)
+			ReleaseSlot(I);
+}
+
+// ==================== Interfaces ==================== //
+
+bool UDecalSubsystem::SpawnDecal(UMaterialInterface* Material, const FVector& Size, const FVector& Location, const FRotator& Rotation, float LifeSpan)
+{
+	if (!Material || !IsInCullDistance(Location)) return false;
+
+	if (TryMerge(Material, Location)) return true;
+
+	// Per frame budget
+	if (LastSpawnFrame != GFrameCounter)
+	{
+		LastSpawnFrame   = GFrameCounter;
+		SpawnedThisFrame = 0;
+	}
+
+	if (SpawnedThisFrame >= GDecalMaxSpawnsPerFrame) return false;
+
+	int32 Slot;
+	UDecalComponent* Decal = AcquireSlot(Slot);
+
+	if (!Decal) return false;
+
+	++SpawnedThisFrame;
+	OW_INC_COUNTER(DecalSpawns);
+
+	// Recycle
+	Decal->SetDecalMaterial(Material);
+	Decal->DecalSize = Size;
+	Decal->SetWorldLocationAndRotation(Location, Rotation);
+	Decal->SetWorldScale3D(FVector::OneVector);
+	Decal->SetFadeOut(LifeSpan * .8f, LifeSpan * .2f, false);
+	Decal->SetVisibility(true);
+
+	// SetFadeOut also arms a life span that destroys the component, the pool hides it in Tick instead
+	Decal->SetLifeSpan(0.f);
+	Decal->MarkRenderStateDirty();
+
+	FDecalSlot& DecalSlot = Slots[Slot];
+	DecalSlot.Location   = Location;
+	DecalSlot.SpawnTime  = GetWorld()->GetTimeSeconds();
+	DecalSlot.ExpireTime = DecalSlot.SpawnTime + LifeSpan;
+	DecalSlot.Scale      = 1.f;
+
+	return true;
+}
+
+// ==================== Pool ==================== //
+
+UDecalComponent* UDecalSubsystem::AcquireSlot(int32& OutSlot)
+{
+	LLM_SCOPE_BYTAG(OW_CombatFX);
+
+	// Reuse an expired one first
+	if (!FreeSlots.IsEmpty())
+	{
+		OutSlot = FreeSlots.Pop(false);
+	}
+	// Then grow the pool lazily until we hit the capacity
+	else if (Pool.Num() < FMath::Max(GDecalCapacity, 1))
+	{
+		OutSlot = Pool.Add(CreateDecal());
+		Slots.AddDefaulted();
+	}
+	// Otherwise every slot is visible, recycle the oldest one
+	else
+	{
+		OutSlot = 0;
+
+		for (int32 I = 1; I < Slots.Num(); ++I)
+			if (Slots[I].SpawnTime < Slots[OutSlot].SpawnTime)
+				OutSlot = I;
+	}
+
+	if (!Slots[OutSlot].bActive)
+	{
+		Slots[OutSlot].bActive = true;
+		++ActiveCount;
+	}
+
+	// Destroyed behind our back (e.g. level streaming), put a new one in its place
+	if (!IsValid(Pool[OutSlot])) Pool[OutSlot] = CreateDecal();
+
+	return Pool[OutSlot];
+}
+
+UDecalComponent* UDecalSubsystem::CreateDecal()
+{
+	UDecalComponent* Decal = NewObject<UDecalComponent>(this);
+	Decal->bAllowAnyoneToDestroyMe = true;
+	Decal->SetVisibility(false);
+	Decal->RegisterComponentWithWorld(GetWorld());
+
+	return Decal;
+}
+
+void UDecalSubsystem::ReleaseSlot(int32 Slot)
+{
+	Slots[Slot].bActive = false;
+	--ActiveCount;
+
+	FreeSlots.Add(Slot);
+
+	if (IsValid(Pool[Slot])) Pool[Slot]->SetVisibility(false);
+}
+
+bool UDecalSubsystem::TryMerge(UMaterialInterface* Material, const FVector& Location)
+{
+	const float MergeRadiusSq = FMath::Square(GDecalMergeRadius);
+
+	for (int32 I = 0; I < Slots.Num(); ++I)
+	{
+		FDecalSlot& Slot = Slots[I];
+
+		if (!Slot.bActive || FVector::DistSquared(Slot.Location, Location) > MergeRadiusSq) continue;
+		if (!IsValid(Pool[I]) || Pool[I]->GetDecalMaterial() != Material) continue;
+
+		// Grow the existing splatter a bit instead, its lifetime is left alone since the fade is already on the render side
+		if (Slot.Scale < 1.5f)
+		{
+			Slot.Scale = FMath::Min(Slot.Scale + .1f, 1.5f);
+			Pool[I]->SetWorldScale3D(FVector(1.f, Slot.Scale, Slot.Scale));
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
+// ==================== Budget ==================== //
+
+bool UDecalSubsystem::IsInCullDistance(const FVector& Location) const
+{
+	APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+
+	if (!PlayerController || !PlayerController->PlayerCameraManager) return true;
+
+	const FVector CameraLocation = PlayerController->PlayerCameraManager->GetCameraLocation();
+
+	return FVector::DistSquared(CameraLocation, Location) <= FMath::Square(GDecalCullDistance);
+}
@@ -0,0 +1,173 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Subsystems/GlobalParamSubsystem.h"
+#include "Engine/World.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "Materials/MaterialParameterCollection.h"
+#include "Materials/MaterialParameterCollectionInstance.h"
+
+static const TCHAR* GlobalMatParamPath = TEXT("/Script/Engine.MaterialParameterCollection'/Game/Game/Materials/MP_Global.MP_Global'");
+
+// ==================== Lifecycles ==================== //
+
+bool UGlobalParamSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UGlobalParamSubsystem::Deinitialize()
+{
+	Params.Empty();
+	DirtyParams.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UGlobalParamSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGlobalParamSubsystem, STATGROUP_Tickables);
+}
+
+void UGlobalParamSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Tickables run after every actor tick group, so this is the end of the gameplay frame
+	Flush();
+}
+
+// ==================== References ==================== //
+
+UMaterialParameterCollectionInstance* UGlobalParamSubsystem::GetGlobalMatParamIns()
+{
+	if (!GlobalMatParamIns.IsValid())
+	{
+		if (!GlobalMatParam) GlobalMatParam = LoadObject<UMaterialParameterCollection>(nullptr, GlobalMatParamPath);
+		if (GlobalMatParam)  GlobalMatParamIns = GetWorld()->GetParameterCollectionInstance(GlobalMatParam);
+	}
+
+	return GlobalMatParamIns.Get();
+}
+
+// ==================== Resolving ==================== //
+
+FGlobalParamHandle UGlobalParamSubsystem::ResolveScalar(FName Name, float Threshold)
+{
+	if (int32 Existing = FindParam(Name, EParamType::Scalar); Existing != INDEX_NONE) return { Existing };
+
+	FParamEntry Entry;
+	Entry.Name      = Name;
+	Entry.Type      = EParamType::Scalar;
+	Entry.Threshold = Threshold;
+
+	if (UMaterialParameterCollectionInstance* Instance = GetGlobalMatParamIns())
+		Instance->GetScalarParameterValue(Name, Entry.Flushed.R);
+
+	Entry.Pending = Entry.Flushed;
+
+	return { Params.Add(Entry) };
+}
+
+FGlobalParamHandle UGlobalParamSubsystem::ResolveVector(FName Name, float Threshold)
+{
+	if (int32 Existing = FindParam(Name, EParamType::Vector); Existing != INDEX_NONE) return { Existing };
+
+	FParamEntry Entry;
+	Entry.Name      = Name;
+	Entry.Type      = EParamType::Vector;
+	Entry.Threshold = Threshold;
+
+	if (UMaterialParameterCollectionInstance* Instance = GetGlobalMatParamIns())
+		Instance->GetVectorParameterValue(Name, Entry.Flushed);
+
+	Entry.Pending = Entry.Flushed;
+
+	return { Params.Add(Entry) };
+}
+
+FGlobalParamHandle UGlobalParamSubsystem::ResolveMaterialScalar(UMaterialInstanceDynamic* Material, FName Name, float InitialValue, float Threshold)
+{
+	if (!Material) return {};
+
+	if (int32 Existing = FindParam(Name, EParamType::MaterialScalar, Material); Existing != INDEX_NONE) return { Existing };
+
+	FParamEntry Entry;
+	Entry.Name      = Name;
+	Entry.Type      = EParamType::MaterialScalar;
+	Entry.Threshold = Threshold;
+	Entry.Material  = Material;
+	Entry.Flushed.R = Entry.Pending.R = InitialValue;
+
+	if (!Material->InitializeScalarParameterAndGetIndex(Name, InitialValue, Entry.MaterialIndex)) return {};
+
+	return { Params.Add(Entry) };
+}
+
+int32 UGlobalParamSubsystem::FindParam(FName Name, EParamType Type, const UMaterialInstanceDynamic* Material) const
+{
+	return Params.IndexOfByPredicate([&](const FParamEntry& Entry) {
+		return Entry.Name == Name && Entry.Type == Type && Entry.Material.Get() == Material;
+	});
+}
+
+// ==================== Writing ==================== //
+
+bool UGlobalParamSubsystem::SetScalar(FGlobalParamHandle Handle, float Value, bool bForce)
+{
+	return Write(Handle, FLinearColor(Value, 0.f, 0.f, 0.f), bForce);
+}
+
+bool UGlobalParamSubsystem::SetVector(FGlobalParamHandle Handle, const FLinearColor& Value, bool bForce)
+{
+	return Write(Handle, Value, bForce);
+}
+
+bool UGlobalParamSubsystem::Write(FGlobalParamHandle Handle, const FLinearColor& Value, bool bForce)
+{
+	if (!Params.IsValidIndex(Handle.Index)) return false;
+
+	FParamEntry& Entry = Params[Handle.Index];
+	Entry.Pending = Value;
+
+	if (Entry.bDirty) return true;
+
+	// Skip anything too small to be seen compared to what the render side already has
+	if (Entry.Flushed == Value || (!bForce && Entry.Flushed.Equals(Value, Entry.Threshold))) return false;
+
+	Entry.bDirty = true;
+	DirtyParams.Add(Handle.Index);
+
+	return true;
+}
+
+void UGlobalParamSubsystem::Flush()
+{
+	if (DirtyParams.IsEmpty()) return;
+
+	UMaterialParameterCollectionInstance* Instance = GetGlobalMatParamIns();
+
+	for (int32 Index : DirtyParams)
+	{
+		FParamEntry& Entry = Params[Index];
+		Entry.bDirty  = false;
+		Entry.Flushed = Entry.Pending;
+
+		// The collection instance has no indexed setter, @see UGlobalParamSubsystem
+		switch (Entry.Type)
+		{
+		case EParamType::Scalar:
+			if (Instance) Instance->SetScalarParameterValue(Entry.Name, Entry.Pending.R);
+			break;
+
+		case EParamType::Vector:
+			if (Instance) Instance->SetVectorParameterValue(Entry.Name, Entry.Pending);
+			break;
+
+		case EParamType::MaterialScalar:
+			if (Entry.Material.IsValid()) Entry.Material->SetScalarParameterByIndex(Entry.MaterialIndex, Entry.Pending.R);
+			break;
+		}
+	}
+
+	DirtyParams.Reset();
+}
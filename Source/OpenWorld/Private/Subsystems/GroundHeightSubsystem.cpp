@@ -0,0 +1,599 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Subsystems/GroundHeightSubsystem.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "LandscapeHeightfieldCollisionComponent.h"
+#include "LandscapeProxy.h"
+#include "OpenWorld.h"
+
+static int32 GGroundMaxTiles = 512;
+static FAutoConsoleVariableRef CVarGroundMaxTiles(
+	TEXT("ow.Ground.MaxTiles"),
+	GGroundMaxTiles,
+	TEXT("Maximum number of cached ground height tiles (65x65 floats each) before the least recently used ones are dropped")
+);
+
+static FAutoConsoleCommandWithWorldAndArgs GroundBenchmarkCommand(
+	TEXT("ow.Ground.Benchmark"),
+	TEXT("ow.Ground.Benchmark [Count=1000000], compare cached ground height queries against line traces"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const int32 Count = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 1000000;
+
+		if (UGroundHeightSubsystem* Subsystem = World ? World->GetSubsystem<UGroundHeightSubsystem>() : nullptr)
+			Subsystem->RunBenchmark(FMath::Max(Count, 1));
+	})
+);
+
+static FAutoConsoleCommandWithWorldAndArgs GroundRayBenchmarkCommand(
+	TEXT("ow.Ground.RayBenchmark"),
+	TEXT("ow.Ground.RayBenchmark [Count=100000] [MaxLength=20000], compare terrain ray casts against line traces"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const int32 Count     = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 100000;
+		const float MaxLength = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 20000.f;
+
+		if (UGroundHeightSubsystem* Subsystem = World ? World->GetSubsystem<UGroundHeightSubsystem>() : nullptr)
+			Subsystem->RunRayBenchmark(FMath::Max(Count, 1), FMath::Max(MaxLength, 100.f));
+	})
+);
+
+/** Marks a sample that had no landscape under it */
+static constexpr float NoGround = TNumericLimits<float>::Lowest();
+
+// ==================== Lifecycles ==================== //
+
+bool UGroundHeightSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	// Editor too, development utils place things on the ground
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE || WorldType == EWorldType::Editor;
+}
+
+void UGroundHeightSubsystem::Deinitialize()
+{
+	ResetTiles();
+	Landscapes.Empty();
+	Quadtree.Reset();
+
+	Super::Deinitialize();
+}
+
+// ==================== Queries ==================== //
+
+bool UGroundHeightSubsystem::GetGround(const FVector2D& Location, FGroundSample& OutSample)
+{
+	OutSample = FGroundSample();
+
+	if (Landscapes.IsEmpty()) CacheLandscapes();
+
+	const FVector2D Grid = ToGrid(Location);
+	const FIntPoint TileCoord = ToTileCoord(Grid);
+
+	const FGroundTile* Tile = FindOrBuildTile(TileCoord);
+
+	return Tile && Sample(*Tile, Grid - FVector2D(TileCoord * TileQuads), OutSample);
+}
+
+bool UGroundHeightSubsystem::GetGroundHeight(const FVector2D& Location, float& OutHeight)
+{
+	FGroundSample GroundSample;
+	if (!GetGround(Location, GroundSample)) return false;
+
+	OutHeight = GroundSample.Height;
+
+	return true;
+}
+
+int32 UGroundHeightSubsystem::GetGroundBatch(TConstArrayView<FVector2D> Locations, TArrayView<FGroundSample> OutSamples)
+{
+	check(Locations.Num() == OutSamples.Num());
+
+	if (Landscapes.IsEmpty()) CacheLandscapes();
+
+	int32 Hits = 0;
+
+	// Nearby queries usually come in order, so keep the last tile around
+	FIntPoint LastCoord(MAX_int32, MAX_int32);
+	const FGroundTile* LastTile = nullptr;
+
+	for (int32 Index = 0; Index < Locations.Num(); ++Index)
+	{
+		const FVector2D Grid = ToGrid(Locations[Index]);
+		const FIntPoint TileCoord = ToTileCoord(Grid);
+
+		if (TileCoord != LastCoord)
+		{
+			LastTile  = FindOrBuildTile(TileCoord);
+			LastCoord = TileCoord;
+		}
+
+		OutSamples[Index] = FGroundSample();
+
+		if (LastTile && Sample(*LastTile, Grid - FVector2D(TileCoord * TileQuads), OutSamples[Index])) ++Hits;
+	}
+
+	return Hits;
+}
+
+bool UGroundHeightSubsystem::TraceGround(const FVector2D& Location, FGroundSample& OutSample, ECollisionChannel Channel, float MaxAbove)
+{
+	FGroundSample Terrain;
+	const bool bTerrain = GetGround(Location, Terrain);
+
+	// Knowing the terrain height keeps the trace down to the range where something can actually stand on it
+	const float Top    = (bTerrain ? Terrain.Height : 0.f) + MaxAbove;
+	const float Bottom = bTerrain ? Terrain.Height - 10.f : -MaxAbove;
+
+	FHitResult HitResult;
+	if (GetWorld()->LineTraceSingleByChannel(HitResult, FVector(Location, Top), FVector(Location, Bottom), Channel))
+	{
+		OutSample.Height = HitResult.ImpactPoint.Z;
+		OutSample.Normal = HitResult.ImpactNormal;
+		OutSample.Slope  = FMath::RadiansToDegrees(FMath::Acos(FMath::Clamp(HitResult.ImpactNormal.Z, -1.f, 1.f)));
+		OutSample.bValid = true;
+
+		return true;
+	}
+
+	OutSample = Terrain;
+
+	return bTerrain;
+}
+
+bool UGroundHeightSubsystem::Sample(const FGroundTile& Tile, const FVector2D& TileSpace, FGroundSample& OutSample) const
+{
+	const int32 X = FMath::Clamp(FMath::FloorToInt32(TileSpace.X), 0, TileQuads - 1);
+	const int32 Y = FMath::Clamp(FMath::FloorToInt32(TileSpace.Y), 0, TileQuads - 1);
+	const float AlphaX = TileSpace.X - X;
+	const float AlphaY = TileSpace.Y - Y;
+
+	const float* Row = Tile.Heights.GetData() + Y * TileSamples + X;
+	const float H00 = Row[0];
+	const float H10 = Row[1];
+	const float H01 = Row[TileSamples];
+	const float H11 = Row[TileSamples + 1];
+
+	if (H00 == NoGround || H10 == NoGround || H01 == NoGround || H11 == NoGround) return false;
+
+	OutSample.Height = FMath::Lerp(FMath::Lerp(H00, H10, AlphaX), FMath::Lerp(H01, H11, AlphaX), AlphaY);
+
+	// Gradient of the same bilinear patch (the landscape is assumed not to be rotated)
+	const float SlopeX = FMath::Lerp(H10 - H00, H11 - H01, AlphaY) / SampleSpacing;
+	const float SlopeY = FMath::Lerp(H01 - H00, H11 - H10, AlphaX) / SampleSpacing;
+
+	OutSample.Normal = FVector(-SlopeX, -SlopeY, 1.f).GetSafeNormal();
+	OutSample.Slope  = FMath::RadiansToDegrees(FMath::Acos(OutSample.Normal.Z));
+	OutSample.bValid = true;
+
+	return true;
+}
+
+// ==================== Ray Casts ==================== //
+
+bool UGroundHeightSubsystem::RayCastTerrain(const FVector& Start, const FVector& End, FHeightfieldHit& OutHit)
+{
+	if (!Quadtree.IsValid()) BuildQuadtree();
+
+	return Quadtree.RayCast(Start, End, OutHit);
+}
+
+bool UGroundHeightSubsystem::IsTerrainVisible(const FVector& From, const FVector& To)
+{
+	if (!Quadtree.IsValid()) BuildQuadtree();
+
+	return Quadtree.IsVisible(From, To);
+}
+
+void UGroundHeightSubsystem::BuildQuadtree()
+{
+	LLM_SCOPE_BYTAG(OW_Terrain);
+
+	const FBox Bounds = GetLandscapeBounds();
+	if (!Bounds.IsValid) return;
+
+	// Every landscape vertex, straight from the collision heightfields. Going through the tiles would build
+	// (and evict) the whole landscape's worth of them, throwing away what the queries around the player cached
+	const FVector2D MinGrid = ToGrid(FVector2D(Bounds.Min));
+	const FVector2D MaxGrid = ToGrid(FVector2D(Bounds.Max));
+	const FIntPoint MinSample(FMath::FloorToInt32(MinGrid.X), FMath::FloorToInt32(MinGrid.Y));
+	const FIntPoint Size = FIntPoint(FMath::CeilToInt32(MaxGrid.X), FMath::CeilToInt32(MaxGrid.Y)) - MinSample + FIntPoint(1);
+
+	TArray<float> Heights;
+	Heights.Init(NoGround, Size.X * Size.Y);
+
+	for (const TWeakObjectPtr<ALandscapeProxy>& Landscape : Landscapes)
+	{
+		if (!Landscape.IsValid()) continue;
+
+		for (ULandscapeHeightfieldCollisionComponent* Component : Landscape->CollisionComponents)
+		{
+			if (!Component) continue;
+
+			// Only the vertices this component covers, the ones on its border are shared with the next and written twice
+			const FBox ComponentBounds = Component->Bounds.GetBox();
+			const FVector2D ComponentMin = ToGrid(FVector2D(ComponentBounds.Min));
+			const FVector2D ComponentMax = ToGrid(FVector2D(ComponentBounds.Max));
+
+			const FIntPoint First(FMath::Max(FMath::CeilToInt32(ComponentMin.X) - MinSample.X, 0), FMath::Max(FMath::CeilToInt32(ComponentMin.Y) - MinSample.Y, 0));
+			const FIntPoint Last(FMath::Min(FMath::FloorToInt32(ComponentMax.X) - MinSample.X, Size.X - 1), FMath::Min(FMath::FloorToInt32(ComponentMax.Y) - MinSample.Y, Size.Y - 1));
+
+			const FTransform& ComponentToWorld = Component->GetComponentTransform();
+
+			for (int32 Y = First.Y; Y <= Last.Y; ++Y)
+				for (int32 X = First.X; X <= Last.X; ++X)
+				{
+					const FVector2D Location = GridOrigin + FVector2D(MinSample + FIntPoint(X, Y)) * SampleSpacing;
+					const FVector Local = ComponentToWorld.InverseTransformPosition(FVector(Location, 0.f));
+
+					if (const TOptional<float> LocalHeight = Component->GetHeight(Local.X, Local.Y, EHeightfieldSource::Complex); LocalHeight.IsSet())
+						Heights[Y * Size.X + X] = ComponentToWorld.TransformPositionNoScale(FVector(0.f, 0.f, LocalHeight.GetValue())).Z;
+				}
+		}
+	}
+
+	Quadtree.Build(MoveTemp(Heights), Size, GridOrigin + FVector2D(MinSample) * SampleSpacing, SampleSpacing);
+}
+
+// ==================== Cache ==================== //
+
+void UGroundHeightSubsystem::Precache(const FBox2D& Area)
+{
+	if (!Area.bIsValid) return;
+
+	CacheLandscapes();
+
+	const FIntPoint MinCoord = ToTileCoord(ToGrid(Area.Min));
+	const FIntPoint MaxCoord = ToTileCoord(ToGrid(Area.Max));
+
+	for (int32 Y = MinCoord.Y; Y <= MaxCoord.Y; ++Y)
+		for (int32 X = MinCoord.X; X <= MaxCoord.X; ++X)
+			FindOrBuildTile(FIntPoint(X, Y));
+}
+
+void UGroundHeightSubsystem::Invalidate(const FBox2D& Area)
+{
+	// The landscape list may be stale as well
+	LandscapesCachedTime = -1.0;
+
+	Quadtree.Reset();
+
+	if (!Area.bIsValid)
+	{
+		ResetTiles();
+		return;
+	}
+
+	const FIntPoint MinCoord = ToTileCoord(ToGrid(Area.Min));
+	const FIntPoint MaxCoord = ToTileCoord(ToGrid(Area.Max));
+
+	for (auto It = Tiles.CreateIterator(); It; ++It)
+	{
+		const FIntPoint& Coord = It.Key();
+
+		if (Coord.X >= MinCoord.X && Coord.Y >= MinCoord.Y && Coord.X <= MaxCoord.X && Coord.Y <= MaxCoord.Y)
+		{
+			TileUseList.RemoveNode(It.Value().UseNode);
+			It.RemoveCurrent();
+		}
+	}
+}
+
+FBox UGroundHeightSubsystem::GetLandscapeBounds()
+{
+	CacheLandscapes();
+
+	FBox Bounds(ForceInit);
+	for (const TWeakObjectPtr<ALandscapeProxy>& Landscape : Landscapes)
+		if (Landscape.IsValid()) Bounds += Landscape->GetComponentsBoundingBox();
+
+	return Bounds;
+}
+
+void UGroundHeightSubsystem::CacheLandscapes()
+{
+	// Proxies stream in and out, look again once in a while
+	const double Now = FPlatformTime::Seconds();
+	if (LandscapesCachedTime >= 0.0 && Now - LandscapesCachedTime < 1.0) return;
+
+	LandscapesCachedTime = Now;
+
+	Landscapes.Reset();
+	for (TActorIterator<ALandscapeProxy> It(GetWorld()); It; ++It)
+		Landscapes.Add(*It);
+
+	if (Landscapes.IsEmpty()) return;
+
+	// Every proxy of a landscape sits on the same grid, only keep the offset within a quad so any proxy gives the same origin
+	const float NewSpacing = FMath::Max((float)Landscapes[0]->GetActorScale3D().X, 1.f);
+	const FVector ProxyLocation = Landscapes[0]->GetActorLocation();
+	const FVector2D NewOrigin(FMath::Fmod(ProxyLocation.X, NewSpacing), FMath::Fmod(ProxyLocation.Y, NewSpacing));
+
+	if (!NewOrigin.Equals(GridOrigin) || NewSpacing != SampleSpacing)
+	{
+		GridOrigin    = NewOrigin;
+		SampleSpacing = NewSpacing;
+
+		ResetTiles();
+		Quadtree.Reset();
+	}
+}
+
+const UGroundHeightSubsystem::FGroundTile* UGroundHeightSubsystem::FindOrBuildTile(const FIntPoint& TileCoord)
+{
+	FGroundTile* Tile = Tiles.Find(TileCoord);
+
+	if (Tile && (!Tile->bIncomplete || FPlatformTime::Seconds() - Tile->BuiltTime < 1.0))
+	{
+		TouchTile(*Tile);
+		return Tile;
+	}
+
+	// About to build, refresh the landscapes first (which drops every tile if the grid moved)
+	CacheLandscapes();
+
+	Tile = Tiles.Find(TileCoord);
+
+	if (!Tile)
+	{
+		EvictTiles();
+		Tile = &Tiles.Add(TileCoord);
+
+		TileUseList.AddHead(TileCoord);
+		Tile->UseNode = TileUseList.GetHead();
+	}
+
+	BuildTile(TileCoord, *Tile);
+	TouchTile(*Tile);
+
+	return Tile;
+}
+
+void UGroundHeightSubsystem::BuildTile(const FIntPoint& TileCoord, FGroundTile& Tile)
+{
+	LLM_SCOPE_BYTAG(OW_Terrain);
+
+	Tile.Heights.Init(NoGround, TileSamples * TileSamples);
+	Tile.BuiltTime   = FPlatformTime::Seconds();
+	Tile.bIncomplete = false;
+
+	const FVector2D TileMin = GridOrigin + FVector2D(TileCoord * TileQuads) * SampleSpacing;
+	const FVector2D TileMax = TileMin + FVector2D(TileQuads * SampleSpacing);
+	const FBox TileBox(FVector(TileMin, -HALF_WORLD_MAX), FVector(TileMax, HALF_WORLD_MAX));
+
+	// Only ask the proxies that cover this tile
+	TArray<ALandscapeProxy*, TInlineAllocator<4>> Overlapping;
+	for (const TWeakObjectPtr<ALandscapeProxy>& Landscape : Landscapes)
+		if (Landscape.IsValid() && Landscape->GetComponentsBoundingBox().Intersect(TileBox))
+			Overlapping.Add(Landscape.Get());
+
+	if (Overlapping.IsEmpty())
+	{
+		Tile.bIncomplete = true;
+		return;
+	}
+
+	for (int32 Y = 0; Y < TileSamples; ++Y)
+		for (int32 X = 0; X < TileSamples; ++X)
+		{
+			const FVector Location(TileMin + FVector2D(X, Y) * SampleSpacing, 0.f);
+			float& Height = Tile.Heights[Y * TileSamples + X];
+
+			for (ALandscapeProxy* Landscape : Overlapping)
+				if (TOptional<float> LandscapeHeight = Landscape->GetHeightAtLocation(Location); LandscapeHeight.IsSet())
+				{
+					Height = LandscapeHeight.GetValue();
+					break;
+				}
+
+			Tile.bIncomplete |= Height == NoGround;
+		}
+}
+
+void UGroundHeightSubsystem::TouchTile(FGroundTile& Tile)
+{
+	// Nearby queries hit the same tiles many times per frame, reordering once is enough
+	if (Tile.LastUsedFrame == GFrameCounter) return;
+
+	Tile.LastUsedFrame = GFrameCounter;
+
+	if (Tile.UseNode == TileUseList.GetHead()) return;
+
+	TileUseList.RemoveNode(Tile.UseNode, false);
+	TileUseList.AddHead(Tile.UseNode);
+}
+
+void UGroundHeightSubsystem::RemoveTile(FIntPoint TileCoord)
+{
+	if (const FGroundTile* Tile = Tiles.Find(TileCoord))
+	{
+		TileUseList.RemoveNode(Tile->UseNode);
+		Tiles.Remove(TileCoord);
+	}
+}
+
+void UGroundHeightSubsystem::ResetTiles()
+{
+	Tiles.Reset();
+	TileUseList.Empty();
+}
+
+void UGroundHeightSubsystem::EvictTiles()
+{
+	// The least recently used one is always at the tail. Copied, removing the tile frees the node
+	while (Tiles.Num() >= FMath::Max(GGroundMaxTiles, 1) && TileUseList.GetTail())
+	{
+		const FIntPoint TileCoord = TileUseList.GetTail()->GetValue();
+		RemoveTile(TileCoord);
+	}
+}
+
+// ==================== Benchmark ==================== //
+
+void UGroundHeightSubsystem::RunBenchmark(int32 Count)
+{
+	const FBox Bounds = GetLandscapeBounds();
+
+	if (!Bounds.IsValid)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Ground benchmark: no landscape loaded"));
+		return;
+	}
+
+	// Same locations for both sides
+	FRandomStream Stream(1337);
+
+	TArray<FVector2D> Locations;
+	Locations.SetNumUninitialized(Count);
+
+	for (FVector2D& Location : Locations)
+		Location = FVector2D(Stream.FRandRange(Bounds.Min.X, Bounds.Max.X), Stream.FRandRange(Bounds.Min.Y, Bounds.Max.Y));
+
+	TArray<FGroundSample> Samples;
+	Samples.SetNum(Count);
+
+	// Cached, first with the tiles being built then with everything resident
+	Invalidate();
+
+	double StartTime = FPlatformTime::Seconds();
+	GetGroundBatch(Locations, Samples);
+	const double ColdTime = FPlatformTime::Seconds() - StartTime;
+
+	StartTime = FPlatformTime::Seconds();
+	const int32 Hits = GetGroundBatch(Locations, Samples);
+	const double WarmTime = FPlatformTime::Seconds() - StartTime;
+
+	// Line traces, the way ground was found so far
+	int32 TraceHits = 0;
+	int32 Compared = 0;
+	double HeightError = 0.0;
+
+	StartTime = FPlatformTime::Seconds();
+
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		FHitResult HitResult;
+
+		if (GetWorld()->LineTraceSingleByChannel(HitResult, FVector(Locations[Index], Bounds.Max.Z + 100.f), FVector(Locations[Index], Bounds.Min.Z - 100.f), ECC_Visibility))
+		{
+			++TraceHits;
+
+			if (Samples[Index].bValid)
+			{
+				HeightError += FMath::Abs(HitResult.ImpactPoint.Z - Samples[Index].Height);
+				++Compared;
+			}
+		}
+	}
+
+	const double TraceTime = FPlatformTime::Seconds() - StartTime;
+
+	UE_LOG(LogTemp, Display, TEXT("Ground benchmark, %d queries: cached %.1fms cold / %.1fms warm (%d hits, %d tiles), line traces %.1fms (%d hits), mean difference %.2f"),
+		Count,
+		ColdTime * 1000.0,
+		WarmTime * 1000.0,
+		Hits,
+		Tiles.Num(),
+		TraceTime * 1000.0,
+		TraceHits,
+		Compared > 0 ? HeightError / Compared : 0.0
+	);
+}
+
+void UGroundHeightSubsystem::RunRayBenchmark(int32 Count, float MaxLength)
+{
+	const FBox Bounds = GetLandscapeBounds();
+
+	if (!Bounds.IsValid)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Ground ray benchmark: no landscape loaded"));
+		return;
+	}
+
+	Quadtree.Reset();
+
+	double StartTime = FPlatformTime::Seconds();
+	BuildQuadtree();
+	const double BuildTime = FPlatformTime::Seconds() - StartTime;
+
+	// Line of sight like segments, both ends some way above the terrain
+	FRandomStream Stream(1337);
+
+	TArray<FVector> Starts, Ends;
+	Starts.SetNumUninitialized(Count);
+	Ends.SetNumUninitialized(Count);
+
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		const FVector2D Start(Stream.FRandRange(Bounds.Min.X, Bounds.Max.X), Stream.FRandRange(Bounds.Min.Y, Bounds.Max.Y));
+		const float Angle = Stream.FRandRange(0.f, UE_TWO_PI);
+		const FVector2D End = Start + FVector2D(FMath::Cos(Angle), FMath::Sin(Angle)) * Stream.FRandRange(100.f, MaxLength);
+
+		float StartHeight = Bounds.Min.Z, EndHeight = Bounds.Min.Z;
+		GetGroundHeight(Start, StartHeight);
+		GetGroundHeight(End, EndHeight);
+
+		Starts[Index] = FVector(Start, StartHeight + Stream.FRandRange(50.f, 2000.f));
+		Ends[Index]   = FVector(End, EndHeight + Stream.FRandRange(50.f, 2000.f));
+	}
+
+	TArray<FHeightfieldHit> Hits;
+	Hits.SetNum(Count);
+
+	TBitArray<> bHits(false, Count);
+
+	StartTime = FPlatformTime::Seconds();
+
+	for (int32 Index = 0; Index < Count; ++Index)
+		bHits[Index] = Quadtree.RayCast(Starts[Index], Ends[Index], Hits[Index]);
+
+	const double RayCastTime = FPlatformTime::Seconds() - StartTime;
+
+	int32 Blocked = 0;
+	StartTime = FPlatformTime::Seconds();
+
+	for (int32 Index = 0; Index < Count; ++Index)
+		Blocked += Quadtree.IsVisible(Starts[Index], Ends[Index]) ? 0 : 1;
+
+	const double VisibilityTime = FPlatformTime::Seconds() - StartTime;
+
+	// Line traces, the way terrain occlusion was checked so far
+	int32 TraceHits = 0;
+	int32 Agreed = 0;
+	int32 Compared = 0;
+	double DistanceError = 0.0;
+
+	StartTime = FPlatformTime::Seconds();
+
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		FHitResult HitResult;
+		const bool bTraceHit = GetWorld()->LineTraceSingleByChannel(HitResult, Starts[Index], Ends[Index], ECC_Visibility);
+
+		TraceHits += bTraceHit ? 1 : 0;
+		Agreed    += bTraceHit == bHits[Index] ? 1 : 0;
+
+		if (bTraceHit && bHits[Index])
+		{
+			DistanceError += FVector::Dist(HitResult.ImpactPoint, Hits[Index].Location);
+			++Compared;
+		}
+	}
+
+	const double TraceTime = FPlatformTime::Seconds() - StartTime;
+
+	UE_LOG(LogTemp, Display, TEXT("Ground ray benchmark, %d segments up to %.0f: pyramid built in %.1fms (%.1fMB), ray casts %.1fms (%d hits), visibility %.1fms (%d blocked), line traces %.1fms (%d hits), %.2f%% agree, mean hit distance %.2f"),
+		Count,
+		MaxLength,
+		BuildTime * 1000.0,
+		Quadtree.GetAllocatedSize() / (1024.0 * 1024.0),
+		RayCastTime * 1000.0,
+		bHits.CountSetBits(),
+		VisibilityTime * 1000.0,
+		Blocked,
+		TraceTime * 1000.0,
+		TraceHits,
+		100.0 * Agreed / Count,
+		Compared > 0 ? DistanceError / Compared : 0.0
+	);
+}
@@ -0,0 +1,232 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Subsystems/HitchWatchdogSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/PlatformStackWalk.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+
+static bool GWatchdogEnabled = true;
+static FAutoConsoleVariableRef CVarWatchdogEnabled(
+	TEXT("ow.Watchdog.Enabled"),
+	GWatchdogEnabled,
+	TEXT("Record synchronous loads and long frames on the game thread")
+);
+
+static float GWatchdogLongFrameMs = 50.f;
+static FAutoConsoleVariableRef CVarWatchdogLongFrameMs(
+	TEXT("ow.Watchdog.LongFrameMs"),
+	GWatchdogLongFrameMs,
+	TEXT("Frames taking longer than this are recorded")
+);
+
+static int32 GWatchdogCapacity = 256;
+static FAutoConsoleVariableRef CVarWatchdogCapacity(
+	TEXT("ow.Watchdog.Capacity"),
+	GWatchdogCapacity,
+	TEXT("Records kept, the oldest are overwritten (only read when the world starts)")
+);
+
+static UHitchWatchdogSubsystem* FindWatchdog(UWorld* World)
+{
+	return World ? World->GetSubsystem<UHitchWatchdogSubsystem>() : nullptr;
+}
+
+static FAutoConsoleCommandWithWorld WatchdogDumpCommand(
+	TEXT("ow.Watchdog.Dump"),
+	TEXT("Log the recorded sync loads and long frames with their call stacks"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (UHitchWatchdogSubsystem* Watchdog = FindWatchdog(World)) Watchdog->DumpReport();
+	})
+);
+
+static FAutoConsoleCommandWithWorld WatchdogClearCommand(
+	TEXT("ow.Watchdog.Clear"),
+	TEXT("Forget every recorded sync load and long frame"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (UHitchWatchdogSubsystem* Watchdog = FindWatchdog(World)) Watchdog->ClearRecords();
+	})
+);
+
+// ==================== Lifecycles ==================== //
+
+bool UHitchWatchdogSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UHitchWatchdogSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Records.SetNum(FMath::Max(GWatchdogCapacity, 1));
+
+	SyncLoadHandle = FCoreUObjectDelegates::OnSyncLoadPackage.AddUObject(this, &ThisClass::OnSyncLoadPackage);
+	EndLoadHandle  = FCoreUObjectDelegates::OnEndLoadPackage.AddUObject(this, &ThisClass::OnEndLoadPackage);
+}
+
+void UHitchWatchdogSubsystem::Deinitialize()
+{
+	FCoreUObjectDelegates::OnSyncLoadPackage.Remove(SyncLoadHandle);
+	FCoreUObjectDelegates::OnEndLoadPackage.Remove(EndLoadHandle);
+
+	// End of the level
+	if (RecordCount > 0) DumpReport();
+
+	Records.Empty();
+	PendingLoads.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UHitchWatchdogSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHitchWatchdogSubsystem, STATGROUP_Tickables);
+}
+
+void UHitchWatchdogSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const double Now = FPlatformTime::Seconds();
+
+	// Loads that never reported their end, count them up to now
+	for (const TPair<uint32, FPendingLoad>& Pending : PendingLoads)
+	{
+		FHitchRecord& Record = Records[Pending.Value.Record];
+		Record.DurationMs    = (Now - Record.StartTime) * 1000.0;
+	}
+	PendingLoads.Reset();
+
+	const float FrameMs = LastFrameTime > 0.0 ? (Now - LastFrameTime) * 1000.0 : 0.f;
+
+	if (GWatchdogEnabled && FrameMs > GWatchdogLongFrameMs)
+	{
+		FHitchRecord& Record = AddRecord(EHitchType::LongFrame);
+		Record.StartTime     = LastFrameTime;
+		Record.DurationMs    = FrameMs;
+		Record.SyncLoads     = FrameSyncLoads;
+		Record.bFinished     = true;
+
+		// Only where the frame ended, the culprit is usually one of the sync loads
+		Record.StackDepth = 0;
+	}
+
+	LastFrameTime  = Now;
+	FrameSyncLoads = 0;
+}
+
+// ==================== Watching ==================== //
+
+UHitchWatchdogSubsystem::FHitchRecord& UHitchWatchdogSubsystem::AddRecord(EHitchType Type)
+{
+	// Overwriting one still waiting for its end
+	for (auto It = PendingLoads.CreateIterator(); It; ++It)
+		if (It->Value.Record == NextRecord) It.RemoveCurrent();
+
+	FHitchRecord& Record = Records[NextRecord];
+	Record               = FHitchRecord();
+	Record.Type          = Type;
+	Record.Frame         = GFrameCounter;
+
+	NextRecord  = (NextRecord + 1) % Records.Num();
+	RecordCount = FMath::Min(RecordCount + 1, Records.Num());
+
+	return Record;
+}
+
+void UHitchWatchdogSubsystem::OnSyncLoadPackage(const FString& PackageName)
+{
+	if (!GWatchdogEnabled || !IsInGameThread() || Records.IsEmpty()) return;
+
+	++FrameSyncLoads;
+
+	const int32 Index    = NextRecord;
+	FHitchRecord& Record = AddRecord(EHitchType::SyncLoad);
+	Record.Name          = FName(PackageName);
+	Record.StartTime     = FPlatformTime::Seconds();
+
+	// Program counters only, symbolicated when reporting
+	Record.StackDepth = FPlatformStackWalk::CaptureStackBackTrace(Record.BackTrace, MaxStackDepth);
+
+	PendingLoads.Add(NextRequestId++, { Record.Name, Index });
+}
+
+void UHitchWatchdogSubsystem::OnEndLoadPackage(const FEndLoadPackageContext& Context)
+{
+	if (PendingLoads.IsEmpty() || !IsInGameThread()) return;
+
+	const double Now = FPlatformTime::Seconds();
+
+	// Every request waiting on one of those packages is done
+	for (auto It = PendingLoads.CreateIterator(); It; ++It)
+	{
+		const FName Package = It->Value.Package;
+		if (!Context.LoadedPackages.ContainsByPredicate([Package](const UPackage* Loaded) { return Loaded && Loaded->GetFName() == Package; })) continue;
+
+		FHitchRecord& Record = Records[It->Value.Record];
+		Record.DurationMs    = (Now - Record.StartTime) * 1000.0;
+		Record.bFinished     = true;
+
+		It.RemoveCurrent();
+	}
+}
+
+// ==================== Reporting ==================== //
+
+void UHitchWatchdogSubsystem::DumpReport()
+{
+	FPlatformStackWalk::InitStackWalking();
+
+	FString Report = FString::Printf(TEXT("Hitch watchdog, %d records (long frame > %.0fms)\n"), RecordCount, GWatchdogLongFrameMs);
+
+	float SyncLoadTotalMs = 0.f;
+
+	// Oldest first
+	for (int32 Offset = 0; Offset < RecordCount; ++Offset)
+	{
+		const FHitchRecord& Record = Records[(NextRecord - RecordCount + Offset + Records.Num()) % Records.Num()];
+
+		if (Record.Type == EHitchType::SyncLoad)
+		{
+			SyncLoadTotalMs += Record.DurationMs;
+
+			Report += FString::Printf(TEXT("[Frame %llu] Sync load %s: %.2fms%s\n"),
+				Record.Frame, *Record.Name.ToString(), Record.DurationMs, Record.bFinished ? TEXT("") : TEXT(" (up to the end of the frame)"));
+		}
+		else
+			Report += FString::Printf(TEXT("[Frame %llu] Long frame: %.2fms, %d sync loads\n"), Record.Frame, Record.DurationMs, Record.SyncLoads);
+
+		for (uint32 Depth = 0; Depth < Record.StackDepth; ++Depth)
+		{
+			ANSICHAR Symbol[512];
+			Symbol[0] = 0;
+
+			FPlatformStackWalk::ProgramCounterToHumanReadableString(Depth, Record.BackTrace[Depth], Symbol, sizeof(Symbol));
+			Report += FString::Printf(TEXT("    %s\n"), ANSI_TO_TCHAR(Symbol));
+		}
+	}
+
+	Report += FString::Printf(TEXT("%.2fms spent in sync loads\n"), SyncLoadTotalMs);
+
+	TArray<FString> Lines;
+	Report.ParseIntoArrayLines(Lines);
+
+	for (const FString& Line : Lines) UE_LOG(LogTemp, Display, TEXT("%s"), *Line);
+
+	const FString Path = FPaths::ProjectLogDir() / TEXT("HitchReport.txt");
+
+	if (!FFileHelper::SaveStringToFile(Report, *Path))
+		UE_LOG(LogTemp, Error, TEXT("Hitch watchdog: Failed to write %s"), *Path);
+}
+
+void UHitchWatchdogSubsystem::ClearRecords()
+{
+	NextRecord  = 0;
+	RecordCount = 0;
+	PendingLoads.Reset();
+}
@@ -0,0 +1,113 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Subsystems/SimulationSubsystem.h"
+#include "Engine/World.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+
+static FAutoConsoleCommandWithWorldAndArgs SimulationStartCommand(
+	TEXT("ow.Simulation.Start"),
+	TEXT("ow.Simulation.Start [Seed=1] [FixedRate=30], reseed every gameplay random stream and run a fixed timestep"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const int32 Seed      = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 1;
+		const float FixedRate = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 30.f;
+
+		if (USimulationSubsystem* Simulation = World ? World->GetSubsystem<USimulationSubsystem>() : nullptr)
+			Simulation->StartSimulation(Seed, FixedRate);
+	})
+);
+
+static FAutoConsoleCommandWithWorld SimulationStopCommand(
+	TEXT("ow.Simulation.Stop"),
+	TEXT("Back to a variable timestep, the streams keep going from where they are"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (USimulationSubsystem* Simulation = World ? World->GetSubsystem<USimulationSubsystem>() : nullptr)
+			Simulation->StopSimulation();
+	})
+);
+
+// ==================== Lifecycles ==================== //
+
+void USimulationSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	int32 CommandLineSeed;
+
+	if (FParse::Value(FCommandLine::Get(), TEXT("OWSeed="), CommandLineSeed) && GetWorld()->IsGameWorld())
+	{
+		float FixedRate = 30.f;
+		FParse::Value(FCommandLine::Get(), TEXT("OWFixedRate="), FixedRate);
+
+		StartSimulation(CommandLineSeed, FixedRate);
+	}
+	else
+		SeedStreams(FPlatformTime::Cycles());
+}
+
+void USimulationSubsystem::Deinitialize()
+{
+	StopSimulation();
+
+	Super::Deinitialize();
+}
+
+// ==================== Simulation ==================== //
+
+void USimulationSubsystem::StartSimulation(int32 InSeed, float FixedRate)
+{
+	if (!bSimulating)
+	{
+		bPreviousUseFixedTimeStep = FApp::UseFixedTimeStep();
+		PreviousFixedDeltaTime    = FApp::GetFixedDeltaTime();
+	}
+
+	bSimulating = true;
+	SeedStreams(InSeed);
+
+	// Also whatever still calls FMath::Rand, e.g. engine code
+	FMath::RandInit(InSeed);
+	FMath::SRandInit(InSeed);
+
+	// Simulated time no longer depends on how fast the machine is
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(1.0 / FMath::Max(FixedRate, 1.f));
+
+	UE_LOG(LogTemp, Display, TEXT("Simulation: Seed %d, %.0f Hz"), InSeed, FMath::Max(FixedRate, 1.f));
+}
+
+void USimulationSubsystem::StopSimulation()
+{
+	if (!bSimulating) return;
+
+	bSimulating = false;
+
+	FApp::SetUseFixedTimeStep(bPreviousUseFixedTimeStep);
+	FApp::SetFixedDeltaTime(PreviousFixedDeltaTime);
+}
+
+// ==================== Random ==================== //
+
+FRandomStream& USimulationSubsystem::GetStream(const UObject* WorldContextObject, ERandomStream Stream)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+
+	if (USimulationSubsystem* Simulation = World ? World->GetSubsystem<USimulationSubsystem>() : nullptr)
+		return Simulation->GetStream(Stream);
+
+	// e.g. a CDO, there's nothing to replay
+	static FRandomStream Fallback(FPlatformTime::Cycles());
+
+	return Fallback;
+}
+
+void USimulationSubsystem::SeedStreams(int32 InSeed)
+{
+	Seed = InSeed;
+
+	// Different but still derived from the one seed
+	for (uint8 Index = 0; Index < (uint8)ERandomStream::ERS_Max; ++Index)
+		Streams[Index].Initialize((int32)HashCombine(GetTypeHash(InSeed), GetTypeHash(Index)));
+}
@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Subsystems/TelemetrySubsystem.h"
+#include "Characters/OWCharacter.h"
+#include "EngineUtils.h"
+#include "NiagaraComponent.h"
+#include "OpenWorld.h"
+#include "UObject/UObjectIterator.h"
+#include "Weapons/MeleeWeapon.h"
+
+// ==================== Lifecycles ==================== //
+
+bool UTelemetrySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UTelemetrySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTelemetrySubsystem, STATGROUP_Tickables);
+}
+
+void UTelemetrySubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+#if CSV_PROFILER
+	if (!FCsvProfiler::Get()->IsCapturing()) return;
+
+	const UWorld* World = GetWorld();
+
+	int32 NiagaraSystems = 0;
+
+	for (TObjectIterator<UNiagaraComponent> It; It; ++It)
+		if (It->GetWorld() == World && It->IsActive()) ++NiagaraSystems;
+
+	int32 Characters = 0;
+	int32 Ragdolls   = 0;
+
+	for (TActorIterator<AOWCharacter> It(GetWorld()); It; ++It)
+	{
+		++Characters;
+
+		if (It->IsDead() && It->GetMesh()->IsSimulatingPhysics()) ++Ragdolls;
+	}
+
+	int32 DroppedWeapons = 0;
+
+	for (TActorIterator<AMeleeWeapon> It(GetWorld()); It; ++It)
+		if (!It->GetOwner()) ++DroppedWeapons;
+
+	CSV_CUSTOM_STAT(OpenWorldPopulation, NiagaraSystems, NiagaraSystems, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(OpenWorldPopulation, Characters, Characters, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(OpenWorldPopulation, Ragdolls, Ragdolls, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(OpenWorldPopulation, DroppedWeapons, DroppedWeapons, ECsvCustomStatOp::Set);
+#endif
+}
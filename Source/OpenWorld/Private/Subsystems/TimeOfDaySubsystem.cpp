@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Subsystems/TimeOfDaySubsystem.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+
+// ==================== Lifecycles ==================== //
+
+void UTimeOfDaySubsystem::Deinitialize()
+{
+	if (UWorld* World = GetWorld())
+		World->GetTimerManager().ClearTimer(CrossingTimerHandle);
+
+	OnDayNightChanged.Clear();
+
+	Super::Deinitialize();
+}
+
+// ==================== Clock ==================== //
+
+void UTimeOfDaySubsystem::SetClock(float InTime, float InHoursPerSecond)
+{
+	StartTime      = FMath::Fmod(FMath::Max(InTime, 0.f), 24.f);
+	StartWorldTime = GetWorld()->GetTimeSeconds();
+	HoursPerSecond = InHoursPerSecond;
+
+	// Let listeners know if restarting the clock moved us across dawn/dusk
+	bool bWasNight = bNight;
+	bNight = IsNightTime(StartTime);
+
+	if (bWasNight != bNight) OnDayNightChanged.Broadcast(bNight);
+
+	ScheduleNextCrossing();
+}
+
+float UTimeOfDaySubsystem::GetTime() const
+{
+	const float Elapsed = GetWorld()->GetTimeSeconds() - StartWorldTime;
+
+	return FMath::Fmod(StartTime + Elapsed * HoursPerSecond, 24.f);
+}
+
+void UTimeOfDaySubsystem::ScheduleNextCrossing()
+{
+	FTimerManager& TimerManager = GetWorld()->GetTimerManager();
+	TimerManager.ClearTimer(CrossingTimerHandle);
+
+	if (HoursPerSecond <= 0.f) return;
+
+	// Hours until the next dawn (at night) or dusk (at day)
+	float Target = bNight ? Dawn : Dusk;
+	float Hours  = FMath::Fmod(Target - GetTime() + 24.f, 24.f);
+
+	TimerManager.SetTimer(CrossingTimerHandle, this, &ThisClass::OnCrossing, FMath::Max(Hours / HoursPerSecond, KINDA_SMALL_NUMBER));
+}
+
+void UTimeOfDaySubsystem::OnCrossing()
+{
+	bNight = !bNight;
+	OnDayNightChanged.Broadcast(bNight);
+
+	ScheduleNextCrossing();
+}
+
+// ==================== Orientation ==================== //
+
+float UTimeOfDaySubsystem::GetSkyAngle(float InTime)
+{
+	// A full turn every day, starting at the horizon on midnight
+	return FRotator::NormalizeAxis(InTime * (360.f / 24.f) + 90.f);
+}
+
+FRotator UTimeOfDaySubsystem::GetSunRotation(float InTime, float Yaw)
+{
+	// The sun is looking at the pivot from the side of the rolled sky, @see ADaytimeManager::SunScene
+	const FVector SunOffset = FRotator(0.f, Yaw, GetSkyAngle(InTime)).RotateVector(FVector(0.f, 1.f, 0.f));
+
+	return (-SunOffset).Rotation();
+}
@@ -0,0 +1,141 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Terrain/FoliageScatter.h"
+#include "Terrain/HeightmapR16.h"
+
+static constexpr float NoGround = TNumericLimits<float>::Lowest();
+
+// ==================== Heightfield ==================== //
+
+void FScatterHeightfield::CaptureGround(UGroundHeightSubsystem& GroundHeights, const FBox2D& Area, float InSpacing)
+{
+	Spacing = FMath::Max(InSpacing, 1.f);
+	Origin  = Area.Min;
+	Size    = FIntPoint(FMath::CeilToInt32(Area.GetSize().X / Spacing), FMath::CeilToInt32(Area.GetSize().Y / Spacing)) + FIntPoint(1);
+
+	TArray<FVector2D> Locations;
+	Locations.SetNumUninitialized(Size.X * Size.Y);
+
+	for (int32 Y = 0; Y < Size.Y; ++Y)
+		for (int32 X = 0; X < Size.X; ++X)
+			Locations[Y * Size.X + X] = Origin + FVector2D(X, Y) * Spacing;
+
+	TArray<FGroundSample> Samples;
+	Samples.SetNum(Locations.Num());
+	GroundHeights.GetGroundBatch(Locations, Samples);
+
+	Heights.SetNumUninitialized(Samples.Num());
+	for (int32 Index = 0; Index < Samples.Num(); ++Index)
+		Heights[Index] = Samples[Index].bValid ? Samples[Index].Height : NoGround;
+}
+
+void FScatterHeightfield::CaptureHeightmap(const FHeightmapR16& Heightmap, const FTransform& LandscapeTransform, const FBox2D& Area, float InSpacing)
+{
+	Spacing = FMath::Max(InSpacing, 1.f);
+	Origin  = Area.Min;
+	Size    = FIntPoint(FMath::CeilToInt32(Area.GetSize().X / Spacing), FMath::CeilToInt32(Area.GetSize().Y / Spacing)) + FIntPoint(1);
+
+	Heights.SetNumUninitialized(Size.X * Size.Y);
+
+	for (int32 Y = 0; Y < Size.Y; ++Y)
+		for (int32 X = 0; X < Size.X; ++X)
+		{
+			// Landscape local space is one unit per heightmap sample
+			const FVector Local = LandscapeTransform.InverseTransformPosition(FVector(Origin + FVector2D(X, Y) * Spacing, 0.f));
+			float& Height = Heights[Y * Size.X + X];
+
+			if (!Heightmap.IsValid() || Local.X < 0.f || Local.Y < 0.f || Local.X > Heightmap.GetWidth() - 1 || Local.Y > Heightmap.GetHeight() - 1)
+			{
+				Height = NoGround;
+				continue;
+			}
+
+			const float Raw = Heightmap.SampleBilinear(FVector2D(Local.X, Local.Y));
+			Height = LandscapeTransform.TransformPosition(FVector(Local.X, Local.Y, FHeightmapR16::ToLocalHeight(Raw))).Z;
+		}
+}
+
+bool FScatterHeightfield::Sample(const FVector2D& Location, FGroundSample& OutSample) const
+{
+	if (Size.X < 2 || Size.Y < 2) return false;
+
+	const FVector2D Grid = (Location - Origin) / Spacing;
+
+	const int32 X = FMath::Clamp(FMath::FloorToInt32(Grid.X), 0, Size.X - 2);
+	const int32 Y = FMath::Clamp(FMath::FloorToInt32(Grid.Y), 0, Size.Y - 2);
+	const float AlphaX = FMath::Clamp(Grid.X - X, 0.f, 1.f);
+	const float AlphaY = FMath::Clamp(Grid.Y - Y, 0.f, 1.f);
+
+	const float* Row = Heights.GetData() + Y * Size.X + X;
+	const float H00 = Row[0];
+	const float H10 = Row[1];
+	const float H01 = Row[Size.X];
+	const float H11 = Row[Size.X + 1];
+
+	if (H00 == NoGround || H10 == NoGround || H01 == NoGround || H11 == NoGround) return false;
+
+	const float SlopeX = FMath::Lerp(H10 - H00, H11 - H01, AlphaY) / Spacing;
+	const float SlopeY = FMath::Lerp(H01 - H00, H11 - H10, AlphaX) / Spacing;
+
+	OutSample.Height = FMath::Lerp(FMath::Lerp(H00, H10, AlphaX), FMath::Lerp(H01, H11, AlphaX), AlphaY);
+	OutSample.Normal = FVector(-SlopeX, -SlopeY, 1.f).GetSafeNormal();
+	OutSample.Slope  = FMath::RadiansToDegrees(FMath::Acos(OutSample.Normal.Z));
+	OutSample.bValid = true;
+
+	return true;
+}
+
+bool FScatterHeightfield::HasGround() const
+{
+	return Heights.ContainsByPredicate([](float Height) { return Height != NoGround; });
+}
+
+// ==================== Scatter ==================== //
+
+TArray<TArray<FTransform>> FFoliageScatter::ScatterCell(const FScatterHeightfield& Heightfield, TConstArrayView<FScatterRule> Rules, const FIntPoint& Cell, float CellSize, int32 Seed)
+{
+	TArray<TArray<FTransform>> Result;
+	Result.SetNum(Rules.Num());
+
+	const FVector2D CellMin = FVector2D(Cell) * CellSize;
+
+	for (int32 RuleIndex = 0; RuleIndex < Rules.Num(); ++RuleIndex)
+	{
+		const FScatterRule& Rule = Rules[RuleIndex];
+		if (!Rule.Mesh || Rule.Density <= 0.f) continue;
+
+		FRandomStream Stream(HashCombineFast(HashCombineFast(GetTypeHash(Seed), GetTypeHash(Cell)), GetTypeHash(RuleIndex)));
+
+		// Jittered grid, one instance per slot at most so nothing ends up inside each other
+		const int32 Slots = FMath::Max(FMath::RoundToInt32(CellSize * FMath::Sqrt(Rule.Density) / 1000.f), 1);
+		const float SlotSize = CellSize / Slots;
+
+		TArray<FTransform>& Transforms = Result[RuleIndex];
+		Transforms.Reserve(Slots * Slots);
+
+		for (int32 Y = 0; Y < Slots; ++Y)
+			for (int32 X = 0; X < Slots; ++X)
+			{
+				// Always draw the same numbers per slot, so a rejected slot doesn't reshuffle the ones after it
+				const FVector2D Jitter(Stream.GetFraction(), Stream.GetFraction());
+				const float Yaw   = Stream.FRandRange(0.f, 360.f);
+				const float Scale = Stream.FRandRange(Rule.ScaleRange.X, Rule.ScaleRange.Y);
+
+				const FVector2D Location = CellMin + (FVector2D(X, Y) + Jitter) * SlotSize;
+
+				// Masks
+				FGroundSample Ground;
+				if (!Heightfield.Sample(Location, Ground)) continue;
+
+				if (Ground.Height < Rule.MinHeight || Ground.Height > Rule.MaxHeight) continue;
+				if (Ground.Slope < Rule.MinSlope || Ground.Slope > Rule.MaxSlope) continue;
+
+				FQuat Rotation(FVector::UpVector, FMath::DegreesToRadians(Yaw));
+				if (Rule.bAlignToNormal) Rotation = FQuat::FindBetweenNormals(FVector::UpVector, Ground.Normal) * Rotation;
+
+				Transforms.Emplace(Rotation, FVector(Location, Ground.Height + Rule.ZOffset), FVector(Scale));
+			}
+	}
+
+	return Result;
+}
@@ -0,0 +1,275 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Terrain/HeightfieldQuadtree.h"
+#include "Algo/Sort.h"
+#include "Async/ParallelFor.h"
+#include "Terrain/HeightmapR16.h"
+
+static constexpr float NoGround = TNumericLimits<float>::Lowest();
+
+// ==================== Lifecycles ==================== //
+
+void FHeightfieldQuadtree::Build(TArray<float>&& InHeights, const FIntPoint& InSize, const FVector2D& InOrigin, float InSpacing)
+{
+	Reset();
+
+	if (InSize.X < 2 || InSize.Y < 2 || InHeights.Num() != InSize.X * InSize.Y) return;
+
+	Size    = InSize;
+	Origin  = InOrigin;
+	Spacing = FMath::Max(InSpacing, 1.f);
+	Heights = MoveTemp(InHeights);
+
+	// Quads, holes are left out of the range so they never get hit
+	FIntPoint LevelSize = Size - FIntPoint(1);
+
+	TArray<FVector2f>& Quads = Levels.AddDefaulted_GetRef();
+	Quads.SetNumUninitialized(LevelSize.X * LevelSize.Y);
+	LevelSizes.Add(LevelSize);
+
+	ParallelFor(LevelSize.Y, [&](int32 Y)
+	{
+		for (int32 X = 0; X < LevelSize.X; ++X)
+		{
+			FVector2f Range(TNumericLimits<float>::Max(), NoGround);
+
+			for (const int32 Corner : { Y * Size.X + X, Y * Size.X + X + 1, (Y + 1) * Size.X + X, (Y + 1) * Size.X + X + 1 })
+				if (Heights[Corner] != NoGround)
+				{
+					Range.X = FMath::Min(Range.X, Heights[Corner]);
+					Range.Y = FMath::Max(Range.Y, Heights[Corner]);
+				}
+
+			Quads[Y * LevelSize.X + X] = Range;
+		}
+	});
+
+	// Halve until a single node covers everything
+	while (LevelSize.X > 1 || LevelSize.Y > 1)
+	{
+		const FIntPoint ChildSize = LevelSize;
+		LevelSize = FIntPoint(FMath::DivideAndRoundUp(ChildSize.X, 2), FMath::DivideAndRoundUp(ChildSize.Y, 2));
+
+		const TArray<FVector2f>& Children = Levels.Last();
+
+		TArray<FVector2f> Parents;
+		Parents.SetNumUninitialized(LevelSize.X * LevelSize.Y);
+
+		for (int32 Y = 0; Y < LevelSize.Y; ++Y)
+			for (int32 X = 0; X < LevelSize.X; ++X)
+			{
+				FVector2f Range(TNumericLimits<float>::Max(), NoGround);
+
+				for (int32 ChildY = Y * 2; ChildY < FMath::Min(Y * 2 + 2, ChildSize.Y); ++ChildY)
+					for (int32 ChildX = X * 2; ChildX < FMath::Min(X * 2 + 2, ChildSize.X); ++ChildX)
+					{
+						const FVector2f& Child = Children[ChildY * ChildSize.X + ChildX];
+
+						Range.X = FMath::Min(Range.X, Child.X);
+						Range.Y = FMath::Max(Range.Y, Child.Y);
+					}
+
+				Parents[Y * LevelSize.X + X] = Range;
+			}
+
+		Levels.Add(MoveTemp(Parents));
+		LevelSizes.Add(LevelSize);
+	}
+}
+
+void FHeightfieldQuadtree::BuildFromHeightmap(const FHeightmapR16& Heightmap, const FTransform& LandscapeTransform)
+{
+	if (!Heightmap.IsValid())
+	{
+		Reset();
+		return;
+	}
+
+	const FVector Location = LandscapeTransform.GetLocation();
+	const FVector Scale    = LandscapeTransform.GetScale3D();
+	const int32 Num = Heightmap.GetWidth() * Heightmap.GetHeight();
+
+	TArray<float> WorldHeights;
+	WorldHeights.SetNumUninitialized(Num);
+
+	for (int32 Index = 0; Index < Num; ++Index)
+		WorldHeights[Index] = Location.Z + FHeightmapR16::ToLocalHeight(Heightmap.GetData()[Index]) * Scale.Z;
+
+	Build(MoveTemp(WorldHeights), FIntPoint(Heightmap.GetWidth(), Heightmap.GetHeight()), FVector2D(Location), Scale.X);
+}
+
+void FHeightfieldQuadtree::Reset()
+{
+	Size = FIntPoint::ZeroValue;
+
+	Heights.Empty();
+	Levels.Empty();
+	LevelSizes.Empty();
+}
+
+// ==================== Queries ==================== //
+
+bool FHeightfieldQuadtree::RayCast(const FVector& Start, const FVector& End, FHeightfieldHit& OutHit) const
+{
+	return Trace<false>(Start, End, &OutHit);
+}
+
+bool FHeightfieldQuadtree::IsVisible(const FVector& From, const FVector& To) const
+{
+	return !Trace<true>(From, To, nullptr);
+}
+
+template <bool bAnyHit>
+bool FHeightfieldQuadtree::Trace(const FVector& Start, const FVector& End, FHeightfieldHit* OutHit) const
+{
+	if (!IsValid()) return false;
+
+	const FVector2D GridStart = (FVector2D(Start) - Origin) / Spacing;
+	const FVector2D GridDelta = (FVector2D(End) - FVector2D(Start)) / Spacing;
+	const float DeltaZ = End.Z - Start.Z;
+
+	struct FNode
+	{
+		int32 Level;
+		int32 X;
+		int32 Y;
+		float Enter;
+		float Exit;
+	};
+
+	TArray<FNode, TInlineAllocator<64>> Stack;
+
+	const int32 TopLevel = Levels.Num() - 1;
+	float Enter, Exit;
+
+	if (!ClipToNode(TopLevel, 0, 0, GridStart, GridDelta, Enter, Exit)) return false;
+	Stack.Add({ TopLevel, 0, 0, Enter, Exit });
+
+	FHeightfieldHit Best;
+	bool bHit = false;
+
+	while (!Stack.IsEmpty())
+	{
+		const FNode Node = Stack.Pop(false);
+
+		// Something closer was already found
+		if (Node.Enter > Best.Time) continue;
+
+		// Segment entirely above or entirely below everything in the node
+		const float ExitTime = FMath::Min(Node.Exit, Best.Time);
+		const float EnterZ = Start.Z + DeltaZ * Node.Enter;
+		const float ExitZ  = Start.Z + DeltaZ * ExitTime;
+
+		const FVector2f& Range = Levels[Node.Level][Node.Y * LevelSizes[Node.Level].X + Node.X];
+
+		if (FMath::Min(EnterZ, ExitZ) > Range.Y || FMath::Max(EnterZ, ExitZ) < Range.X) continue;
+
+		if (Node.Level == 0)
+		{
+			FHeightfieldHit Hit;
+
+			if (IntersectQuad(Node.X, Node.Y, Start, End, Hit) && Hit.Time < Best.Time)
+			{
+				Best = Hit;
+				bHit = true;
+
+				if (bAnyHit) return true;
+			}
+
+			continue;
+		}
+
+		// Children, pushed far to near so the nearest gets popped first
+		const int32 ChildLevel = Node.Level - 1;
+		const FIntPoint& ChildSize = LevelSizes[ChildLevel];
+
+		FNode Children[4];
+		int32 ChildCount = 0;
+
+		for (int32 ChildY = Node.Y * 2; ChildY < FMath::Min(Node.Y * 2 + 2, ChildSize.Y); ++ChildY)
+			for (int32 ChildX = Node.X * 2; ChildX < FMath::Min(Node.X * 2 + 2, ChildSize.X); ++ChildX)
+				if (ClipToNode(ChildLevel, ChildX, ChildY, GridStart, GridDelta, Enter, Exit))
+					Children[ChildCount++] = { ChildLevel, ChildX, ChildY, Enter, Exit };
+
+		Algo::Sort(MakeArrayView(Children, ChildCount), [](const FNode& A, const FNode& B) { return A.Enter > B.Enter; });
+
+		for (int32 Index = 0; Index < ChildCount; ++Index)
+			Stack.Add(Children[Index]);
+	}
+
+	if (bHit && OutHit) *OutHit = Best;
+
+	return bHit;
+}
+
+bool FHeightfieldQuadtree::ClipToNode(int32 Level, int32 X, int32 Y, const FVector2D& GridStart, const FVector2D& GridDelta, float& OutEnter, float& OutExit) const
+{
+	// Node bounds in quads, the last node of a row may be cut short
+	const int32 NodeSize = 1 << Level;
+	const FVector2D Min(X * NodeSize, Y * NodeSize);
+	const FVector2D Max(FMath::Min((X + 1) * NodeSize, Size.X - 1), FMath::Min((Y + 1) * NodeSize, Size.Y - 1));
+
+	OutEnter = 0.f;
+	OutExit  = 1.f;
+
+	// Slabs
+	for (int32 Axis = 0; Axis < 2; ++Axis)
+	{
+		if (FMath::Abs(GridDelta[Axis]) < UE_KINDA_SMALL_NUMBER)
+		{
+			if (GridStart[Axis] < Min[Axis] || GridStart[Axis] > Max[Axis]) return false;
+			continue;
+		}
+
+		float Near = (Min[Axis] - GridStart[Axis]) / GridDelta[Axis];
+		float Far  = (Max[Axis] - GridStart[Axis]) / GridDelta[Axis];
+		if (Near > Far) Swap(Near, Far);
+
+		OutEnter = FMath::Max(OutEnter, Near);
+		OutExit  = FMath::Min(OutExit, Far);
+	}
+
+	return OutEnter <= OutExit;
+}
+
+bool FHeightfieldQuadtree::IntersectQuad(int32 X, int32 Y, const FVector& Start, const FVector& End, FHeightfieldHit& OutHit) const
+{
+	const float H00 = Heights[Y * Size.X + X];
+	const float H10 = Heights[Y * Size.X + X + 1];
+	const float H01 = Heights[(Y + 1) * Size.X + X];
+	const float H11 = Heights[(Y + 1) * Size.X + X + 1];
+
+	if (H00 == NoGround || H10 == NoGround || H01 == NoGround || H11 == NoGround) return false;
+
+	const FVector2D Corner = Origin + FVector2D(X, Y) * Spacing;
+	const FVector P00(Corner,                               H00);
+	const FVector P10(Corner + FVector2D(Spacing, 0.f),     H10);
+	const FVector P01(Corner + FVector2D(0.f, Spacing),     H01);
+	const FVector P11(Corner + FVector2D(Spacing, Spacing), H11);
+
+	const float Length = (End - Start).Size();
+	if (Length < UE_KINDA_SMALL_NUMBER) return false;
+
+	// Split along the same diagonal as the landscape
+	const FVector Triangles[2][3] = { { P00, P11, P10 }, { P00, P01, P11 } };
+
+	bool bHit = false;
+	FVector Point, Normal;
+
+	for (const FVector (&Triangle)[3] : Triangles)
+		if (FMath::SegmentTriangleIntersection(Start, End, Triangle[0], Triangle[1], Triangle[2], Point, Normal))
+		{
+			const float Time = (Point - Start).Size() / Length;
+
+			if (!bHit || Time < OutHit.Time)
+			{
+				OutHit.Location = Point;
+				OutHit.Normal   = Normal.Z < 0.f ? -Normal : Normal;
+				OutHit.Time     = Time;
+
+				bHit = true;
+			}
+		}
+
+	return bHit;
+}
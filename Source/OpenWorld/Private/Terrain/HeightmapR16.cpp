@@ -0,0 +1,218 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Terrain/HeightmapR16.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "OpenWorld.h"
+
+static_assert(PLATFORM_LITTLE_ENDIAN, "R16 samples are little endian and read in place");
+
+/** Catmull-Rom through P1 and P2 */
+static FORCEINLINE float CubicInterp(float P0, float P1, float P2, float P3, float Alpha)
+{
+	const float A = -.5f * P0 + 1.5f * P1 - 1.5f * P2 + .5f * P3;
+	const float B = P0 - 2.5f * P1 + 2.f * P2 - .5f * P3;
+	const float C = -.5f * P0 + .5f * P2;
+
+	return ((A * Alpha + B) * Alpha + C) * Alpha + P1;
+}
+
+/** Get returns a raw sample, clamped to the edges */
+template <typename GetterType>
+static float Bilinear(const FVector2D& Pixel, GetterType&& Get)
+{
+	const int32 X = FMath::FloorToInt32(Pixel.X);
+	const int32 Y = FMath::FloorToInt32(Pixel.Y);
+	const float AlphaX = Pixel.X - X;
+	const float AlphaY = Pixel.Y - Y;
+
+	const float Top    = FMath::Lerp((float)Get(X, Y),     (float)Get(X + 1, Y),     AlphaX);
+	const float Bottom = FMath::Lerp((float)Get(X, Y + 1), (float)Get(X + 1, Y + 1), AlphaX);
+
+	return FMath::Lerp(Top, Bottom, AlphaY);
+}
+
+template <typename GetterType>
+static float Bicubic(const FVector2D& Pixel, GetterType&& Get)
+{
+	const int32 X = FMath::FloorToInt32(Pixel.X);
+	const int32 Y = FMath::FloorToInt32(Pixel.Y);
+	const float AlphaX = Pixel.X - X;
+	const float AlphaY = Pixel.Y - Y;
+
+	float Rows[4];
+	for (int32 Row = 0; Row < 4; ++Row)
+	{
+		const int32 SampleY = Y + Row - 1;
+
+		Rows[Row] = CubicInterp(Get(X - 1, SampleY), Get(X, SampleY), Get(X + 1, SampleY), Get(X + 2, SampleY), AlphaX);
+	}
+
+	// Overshoot is clamped so cliffs don't ring outside of the 16 bit range
+	return FMath::Clamp(CubicInterp(Rows[0], Rows[1], Rows[2], Rows[3], AlphaY), 0.f, (float)MAX_uint16);
+}
+
+// ==================== Lifecycles ==================== //
+
+FHeightmapR16::~FHeightmapR16()
+{
+	Close();
+}
+
+bool FHeightmapR16::Open(const FString& Path, int32 InWidth)
+{
+	LLM_SCOPE_BYTAG(OW_Terrain);
+
+	Close();
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+	const int64 FileSize = PlatformFile.FileSize(*Path);
+	const int64 Samples  = FileSize / sizeof(uint16);
+
+	if (FileSize <= 0 || FileSize % sizeof(uint16) != 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Heightmap %s is missing or not a 16 bit raw file"), *Path);
+		return false;
+	}
+
+	// Dimension
+	const int64 DerivedWidth = InWidth > 0 ? InWidth : FMath::RoundToInt64(FMath::Sqrt((double)Samples));
+
+	if (DerivedWidth <= 0 || Samples % DerivedWidth != 0 || (InWidth <= 0 && DerivedWidth * DerivedWidth != Samples))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Heightmap %s has %lld samples, which doesn't match the width %lld"), *Path, Samples, DerivedWidth);
+		return false;
+	}
+
+	if (Samples / DerivedWidth > MAX_int32)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Heightmap %s is too tall"), *Path);
+		return false;
+	}
+
+	// Map it
+	FOpenMappedResult MappedResult = PlatformFile.OpenMappedEx(*Path);
+
+	if (!MappedResult.HasError())
+	{
+		MappedFile   = MappedResult.StealValue();
+		MappedRegion = TUniquePtr<IMappedFileRegion>(MappedFile->MapRegion(0, FileSize));
+	}
+
+	if (MappedRegion.IsValid())
+		Data = reinterpret_cast<const uint16*>(MappedRegion->GetMappedPtr());
+	else
+	{
+		MappedFile.Reset();
+
+		if (!FFileHelper::LoadFileToArray(FallbackData, *Path))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Failed to read heightmap %s"), *Path);
+			return false;
+		}
+
+		Data = reinterpret_cast<const uint16*>(FallbackData.GetData());
+	}
+
+	Width  = (int32)DerivedWidth;
+	Height = (int32)(Samples / DerivedWidth);
+
+	return true;
+}
+
+void FHeightmapR16::Close()
+{
+	// The region must go before the file it maps
+	MappedRegion.Reset();
+	MappedFile.Reset();
+	FallbackData.Empty();
+
+	Data   = nullptr;
+	Width  = 0;
+	Height = 0;
+}
+
+// ==================== Sampling ==================== //
+
+float FHeightmapR16::SampleBilinear(const FVector2D& Pixel) const
+{
+	if (!IsValid()) return 0.f;
+
+	return Bilinear(Pixel, [this](int32 X, int32 Y) { return GetRaw(X, Y); });
+}
+
+float FHeightmapR16::SampleBicubic(const FVector2D& Pixel) const
+{
+	if (!IsValid()) return 0.f;
+
+	return Bicubic(Pixel, [this](int32 X, int32 Y) { return (float)GetRaw(X, Y); });
+}
+
+FHeightmapView FHeightmapR16::GetView(const FIntRect& Rect) const
+{
+	FHeightmapView View;
+	View.Source = this;
+	View.Rect   = FIntRect(
+		FIntPoint(FMath::Clamp(Rect.Min.X, 0, Width), FMath::Clamp(Rect.Min.Y, 0, Height)),
+		FIntPoint(FMath::Clamp(Rect.Max.X, 0, Width), FMath::Clamp(Rect.Max.Y, 0, Height))
+	);
+
+	return View;
+}
+
+TArray<FHeightmapView> FHeightmapR16::GetTiles(int32 TileSize) const
+{
+	TArray<FHeightmapView> Tiles;
+	if (!IsValid() || TileSize < 2) return Tiles;
+
+	// Neighbours share their border, so tiles advance by one less than their size
+	const int32 Step   = TileSize - 1;
+	const int32 TilesX = FMath::Max(FMath::DivideAndRoundUp(Width - 1, Step), 1);
+	const int32 TilesY = FMath::Max(FMath::DivideAndRoundUp(Height - 1, Step), 1);
+
+	Tiles.Reserve(TilesX * TilesY);
+
+	for (int32 Y = 0; Y < TilesY; ++Y)
+		for (int32 X = 0; X < TilesX; ++X)
+		{
+			const FIntPoint Min(X * Step, Y * Step);
+
+			Tiles.Add(GetView(FIntRect(Min, Min + FIntPoint(TileSize))));
+		}
+
+	return Tiles;
+}
+
+// ==================== Views ==================== //
+
+uint16 FHeightmapView::GetRaw(int32 X, int32 Y) const
+{
+	return Source ? Source->GetRaw(Rect.Min.X + X, Rect.Min.Y + Y) : 0;
+}
+
+float FHeightmapView::SampleBilinear(const FVector2D& Pixel) const
+{
+	return Source ? Source->SampleBilinear(Pixel + FVector2D(Rect.Min)) : 0.f;
+}
+
+float FHeightmapView::SampleBicubic(const FVector2D& Pixel) const
+{
+	return Source ? Source->SampleBicubic(Pixel + FVector2D(Rect.Min)) : 0.f;
+}
+
+void FHeightmapView::CopyTo(TArray<uint16>& OutHeights) const
+{
+	OutHeights.SetNumUninitialized(IsValid() ? Rect.Area() : 0);
+	if (!IsValid()) return;
+
+	const int32 RowWidth = Rect.Width();
+
+	for (int32 Y = 0; Y < Rect.Height(); ++Y)
+	{
+		const uint16* Row = Source->GetData() + (int64)(Rect.Min.Y + Y) * Source->GetWidth() + Rect.Min.X;
+
+		FMemory::Memcpy(OutHeights.GetData() + Y * RowWidth, Row, RowWidth * sizeof(uint16));
+	}
+}
@@ -0,0 +1,417 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Terrain/HeightmapTiled.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "Misc/Compression.h"
+#include "OpenWorld.h"
+#include "Terrain/HeightmapR16.h"
+
+FArchive& operator<<(FArchive& Ar, FHeightmapTileEntry& Entry)
+{
+	uint8 bCompressed = Entry.bCompressed;
+
+	Ar << Entry.Offset << Entry.Size << Entry.RawSize << Entry.Min << Entry.Max << Entry.Step << bCompressed;
+
+	Entry.bCompressed = bCompressed != 0;
+
+	return Ar;
+}
+
+/** Left + top - top left, the plane through the three decoded neighbours */
+static FORCEINLINE int32 Predict(const uint16* Samples, int32 X, int32 Y, int32 TileWidth, int32 MaxValue)
+{
+	if (X == 0 && Y == 0) return 0;
+	if (Y == 0) return Samples[X - 1];
+	if (X == 0) return Samples[(Y - 1) * TileWidth];
+
+	const int32 Left    = Samples[Y * TileWidth + X - 1];
+	const int32 Top     = Samples[(Y - 1) * TileWidth + X];
+	const int32 TopLeft = Samples[(Y - 1) * TileWidth + X - 1];
+
+	return FMath::Clamp(Left + Top - TopLeft, 0, MaxValue);
+}
+
+// ==================== Encoding ==================== //
+
+bool FHeightmapTiled::Encode(const FHeightmapR16& Source, const FString& Path, int32 InTileSize, int32 MaxError, FHeightmapEncodeStats* OutStats)
+{
+	if (!Source.IsValid() || InTileSize < 2) return false;
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	const FIntPoint Tiles(FMath::DivideAndRoundUp(Source.GetWidth(), InTileSize), FMath::DivideAndRoundUp(Source.GetHeight(), InTileSize));
+
+	TArray<FHeightmapTileEntry> TileEntries;
+	TileEntries.SetNum(Tiles.X * Tiles.Y);
+
+	TArray<TArray<uint8>> Payloads;
+	Payloads.SetNum(TileEntries.Num());
+
+	// Tiles are independent
+	ParallelFor(TileEntries.Num(), [&](int32 Index)
+	{
+		const FHeightmapView View = Source.GetView(FIntRect(
+			FIntPoint(Index % Tiles.X, Index / Tiles.X) * InTileSize,
+			FIntPoint(Index % Tiles.X + 1, Index / Tiles.X + 1) * InTileSize
+		));
+
+		TArray<uint16> Samples;
+		View.CopyTo(Samples);
+
+		EncodeTile(Samples, View.GetWidth(), MaxError, TileEntries[Index], Payloads[Index]);
+	});
+
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*Path));
+
+	if (!Writer)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to create %s"), *Path);
+		return false;
+	}
+
+	// Header, then the index (written twice, the offsets are only known after the payloads), then the payloads
+	uint32 FileMagic = Magic, FileVersion = Version;
+	int32 SourceWidth = Source.GetWidth(), SourceHeight = Source.GetHeight();
+
+	*Writer << FileMagic << FileVersion << SourceWidth << SourceHeight << InTileSize;
+
+	const int64 IndexOffset = Writer->Tell();
+	for (FHeightmapTileEntry& Entry : TileEntries) *Writer << Entry;
+
+	for (int32 Index = 0; Index < TileEntries.Num(); ++Index)
+	{
+		TileEntries[Index].Offset = Writer->Tell();
+		Writer->Serialize(Payloads[Index].GetData(), Payloads[Index].Num());
+	}
+
+	const int64 FileSize = Writer->Tell();
+
+	Writer->Seek(IndexOffset);
+	for (FHeightmapTileEntry& Entry : TileEntries) *Writer << Entry;
+
+	const bool bSuccess = Writer->Close() && !Writer->IsError();
+
+	if (OutStats)
+	{
+		OutStats->RawBytes     = (int64)SourceWidth * SourceHeight * sizeof(uint16);
+		OutStats->EncodedBytes = FileSize;
+		OutStats->Seconds      = FPlatformTime::Seconds() - StartTime;
+	}
+
+	return bSuccess;
+}
+
+void FHeightmapTiled::EncodeTile(TConstArrayView<uint16> Samples, int32 TileWidth, int32 MaxError, FHeightmapTileEntry& OutEntry, TArray<uint8>& OutPayload)
+{
+	OutPayload.Reset();
+	OutEntry = FHeightmapTileEntry();
+
+	if (Samples.IsEmpty() || TileWidth <= 0) return;
+
+	// Steps have to fit in 16 bits
+	MaxError = FMath::Clamp(MaxError, 0, MAX_int16);
+
+	// Range
+	uint16 Min = MAX_uint16, Max = 0;
+	for (const uint16 Sample : Samples)
+	{
+		Min = FMath::Min(Min, Sample);
+		Max = FMath::Max(Max, Sample);
+	}
+
+	// Any value within MaxError of a multiple of Step snaps to it, flat tiles need no steps at all
+	const int32 Range = Max - Min;
+	const int32 Step  = FMath::Clamp(MaxError * 2 + 1, 1, Range + 1);
+	const int32 MaxValue = Range / Step + (Range % Step != 0 ? 1 : 0);
+
+	OutEntry.Min  = Min;
+	OutEntry.Max  = Max;
+	OutEntry.Step = (uint16)Step;
+
+	// Quantized tile, predictions run on it so the decoder sees exactly the same neighbours
+	TArray<uint16> Quantized;
+	Quantized.SetNumUninitialized(Samples.Num());
+
+	for (int32 Index = 0; Index < Samples.Num(); ++Index)
+		Quantized[Index] = (uint16)FMath::Min((Samples[Index] - Min + Step / 2) / Step, MaxValue);
+
+	// Residuals as zigzag varints, most of them fit in one byte on smooth terrain
+	TArray<uint8> Residuals;
+	Residuals.Reserve(Samples.Num() + Samples.Num() / 4);
+
+	const int32 TileHeight = Samples.Num() / TileWidth;
+
+	for (int32 Y = 0; Y < TileHeight; ++Y)
+		for (int32 X = 0; X < TileWidth; ++X)
+		{
+			const int32 Residual = Quantized[Y * TileWidth + X] - Predict(Quantized.GetData(), X, Y, TileWidth, MaxValue);
+			uint32 Zigzag = ((uint32)Residual << 1) ^ (uint32)(Residual >> 31);
+
+			while (Zigzag >= 0x80)
+			{
+				Residuals.Add((uint8)(Zigzag | 0x80));
+				Zigzag >>= 7;
+			}
+
+			Residuals.Add((uint8)Zigzag);
+		}
+
+	OutEntry.RawSize = Residuals.Num();
+
+	// Compress on top, kept only when it pays off
+	int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, Residuals.Num());
+	OutPayload.SetNumUninitialized(CompressedSize);
+
+	if (FCompression::CompressMemory(NAME_Zlib, OutPayload.GetData(), CompressedSize, Residuals.GetData(), Residuals.Num()) && CompressedSize < Residuals.Num())
+	{
+		OutPayload.SetNum(CompressedSize);
+		OutEntry.bCompressed = true;
+	}
+	else
+		OutPayload = MoveTemp(Residuals);
+
+	OutEntry.Size = OutPayload.Num();
+}
+
+bool FHeightmapTiled::DecodeTile(TConstArrayView<uint8> Payload, const FHeightmapTileEntry& Entry, int32 TileWidth, int32 TileHeight, TArray<uint16>& OutSamples)
+{
+	TArray<uint8> Uncompressed;
+	TConstArrayView<uint8> Residuals = Payload;
+
+	if (Entry.bCompressed)
+	{
+		Uncompressed.SetNumUninitialized(Entry.RawSize);
+
+		if (!FCompression::UncompressMemory(NAME_Zlib, Uncompressed.GetData(), Entry.RawSize, Payload.GetData(), Payload.Num())) return false;
+
+		Residuals = Uncompressed;
+	}
+
+	const int32 Step = FMath::Max<int32>(Entry.Step, 1);
+	const int32 Range = Entry.Max - Entry.Min;
+	const int32 MaxValue = Range / Step + (Range % Step != 0 ? 1 : 0);
+
+	OutSamples.SetNumUninitialized(TileWidth * TileHeight);
+
+	// Quantized values first, in place, predictions need the decoded neighbours
+	int32 Cursor = 0;
+
+	for (int32 Y = 0; Y < TileHeight; ++Y)
+		for (int32 X = 0; X < TileWidth; ++X)
+		{
+			uint32 Zigzag = 0;
+
+			for (int32 Shift = 0; ; Shift += 7)
+			{
+				if (Cursor >= Residuals.Num() || Shift > 28) return false;
+
+				const uint8 Byte = Residuals[Cursor++];
+				Zigzag |= (uint32)(Byte & 0x7F) << Shift;
+
+				if (!(Byte & 0x80)) break;
+			}
+
+			const int32 Residual = (int32)(Zigzag >> 1) ^ -(int32)(Zigzag & 1);
+
+			OutSamples[Y * TileWidth + X] = (uint16)FMath::Clamp(Predict(OutSamples.GetData(), X, Y, TileWidth, MaxValue) + Residual, 0, MaxValue);
+		}
+
+	// Back to raw
+	for (uint16& Sample : OutSamples)
+		Sample = (uint16)FMath::Min(Entry.Min + Sample * Step, (int32)Entry.Max);
+
+	return true;
+}
+
+// ==================== Lifecycles ==================== //
+
+FHeightmapTiled::~FHeightmapTiled()
+{
+	Close();
+}
+
+bool FHeightmapTiled::Open(const FString& Path)
+{
+	LLM_SCOPE_BYTAG(OW_Terrain);
+
+	Close();
+
+	Reader = TUniquePtr<FArchive>(IFileManager::Get().CreateFileReader(*Path));
+
+	if (!Reader)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Tiled heightmap %s is missing"), *Path);
+		return false;
+	}
+
+	uint32 FileMagic = 0, FileVersion = 0;
+	*Reader << FileMagic << FileVersion << Width << Height << TileSize;
+
+	if (FileMagic != Magic || FileVersion != Version || Width <= 0 || Height <= 0 || TileSize < 2)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s is not a tiled heightmap (or an older version of one)"), *Path);
+
+		Close();
+		return false;
+	}
+
+	TileCount = FIntPoint(FMath::DivideAndRoundUp(Width, TileSize), FMath::DivideAndRoundUp(Height, TileSize));
+
+	Entries.SetNum(TileCount.X * TileCount.Y);
+	for (FHeightmapTileEntry& Entry : Entries) *Reader << Entry;
+
+	if (Reader->IsError())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Tiled heightmap %s is truncated"), *Path);
+
+		Close();
+		return false;
+	}
+
+	// The tiles are sized from these, so a damaged index must not get as far as an allocation.
+	// Varints take at most 5 bytes per sample
+	const int64 PayloadStart = Reader->Tell();
+	const int64 FileSize     = Reader->TotalSize();
+	const int64 MaxRawSize   = (int64)TileSize * TileSize * 5;
+
+	for (const FHeightmapTileEntry& Entry : Entries)
+	{
+		if (Entry.Size < 0 || Entry.RawSize < 0 || Entry.RawSize > MaxRawSize || Entry.Offset < PayloadStart || Entry.Offset + Entry.Size > FileSize)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Tiled heightmap %s has a corrupted index"), *Path);
+
+			Close();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void FHeightmapTiled::Close()
+{
+	Reader.Reset();
+	Entries.Empty();
+	LoadedTiles.Empty();
+
+	Width     = 0;
+	Height    = 0;
+	TileSize  = 0;
+	TileCount = FIntPoint::ZeroValue;
+}
+
+// ==================== Streaming ==================== //
+
+int32 FHeightmapTiled::Stream(const FIntRect& Region, int32 Margin)
+{
+	LLM_SCOPE_BYTAG(OW_Terrain);
+
+	if (!IsValid()) return 0;
+
+	const FIntPoint MinTile(FMath::Clamp(Region.Min.X / TileSize, 0, TileCount.X - 1), FMath::Clamp(Region.Min.Y / TileSize, 0, TileCount.Y - 1));
+	const FIntPoint MaxTile(FMath::Clamp((Region.Max.X - 1) / TileSize, 0, TileCount.X - 1), FMath::Clamp((Region.Max.Y - 1) / TileSize, 0, TileCount.Y - 1));
+
+	// Drop what's too far, the margin keeps moving back and forth over a tile border from reloading it
+	for (auto It = LoadedTiles.CreateIterator(); It; ++It)
+	{
+		const FIntPoint& Tile = It.Key();
+
+		if (Tile.X < MinTile.X - Margin || Tile.Y < MinTile.Y - Margin || Tile.X > MaxTile.X + Margin || Tile.Y > MaxTile.Y + Margin)
+			It.RemoveCurrent();
+	}
+
+	int32 Loaded = 0;
+
+	for (int32 Y = MinTile.Y; Y <= MaxTile.Y; ++Y)
+		for (int32 X = MinTile.X; X <= MaxTile.X; ++X)
+		{
+			const FIntPoint Tile(X, Y);
+			if (LoadedTiles.Contains(Tile)) continue;
+
+			TArray<uint16> Samples;
+			if (!LoadTile(Tile, Samples)) continue;
+
+			LoadedTiles.Add(Tile, MoveTemp(Samples));
+			++Loaded;
+		}
+
+	return Loaded;
+}
+
+bool FHeightmapTiled::DecodeAll(TArray<uint16>& OutHeights)
+{
+	LLM_SCOPE_BYTAG(OW_Terrain);
+
+	if (!IsValid()) return false;
+
+	OutHeights.SetNumUninitialized(Width * Height);
+
+	TArray<uint16> Samples;
+
+	for (int32 Y = 0; Y < TileCount.Y; ++Y)
+		for (int32 X = 0; X < TileCount.X; ++X)
+		{
+			if (!LoadTile(FIntPoint(X, Y), Samples)) return false;
+
+			const FIntPoint Dimension = GetTileDimension(FIntPoint(X, Y));
+
+			for (int32 Row = 0; Row < Dimension.Y; ++Row)
+				FMemory::Memcpy(&OutHeights[(Y * TileSize + Row) * Width + X * TileSize], &Samples[Row * Dimension.X], Dimension.X * sizeof(uint16));
+		}
+
+	return true;
+}
+
+bool FHeightmapTiled::LoadTile(const FIntPoint& Tile, TArray<uint16>& OutSamples)
+{
+	const FHeightmapTileEntry& Entry = Entries[Tile.Y * TileCount.X + Tile.X];
+
+	TArray<uint8> Payload;
+	Payload.SetNumUninitialized(Entry.Size);
+
+	Reader->Seek(Entry.Offset);
+	Reader->Serialize(Payload.GetData(), Payload.Num());
+
+	const FIntPoint Dimension = GetTileDimension(Tile);
+
+	if (Reader->IsError() || !DecodeTile(Payload, Entry, Dimension.X, Dimension.Y, OutSamples))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Tiled heightmap tile %s is corrupted"), *Tile.ToString());
+		return false;
+	}
+
+	return true;
+}
+
+// ==================== Sampling ==================== //
+
+bool FHeightmapTiled::GetRaw(int32 X, int32 Y, uint16& OutRaw) const
+{
+	X = FMath::Clamp(X, 0, Width - 1);
+	Y = FMath::Clamp(Y, 0, Height - 1);
+
+	const FIntPoint Tile(X / TileSize, Y / TileSize);
+	const TArray<uint16>* Samples = LoadedTiles.Find(Tile);
+
+	if (!Samples) return false;
+
+	OutRaw = (*Samples)[(Y - Tile.Y * TileSize) * GetTileDimension(Tile).X + X - Tile.X * TileSize];
+
+	return true;
+}
+
+bool FHeightmapTiled::SampleBilinear(const FVector2D& Pixel, float& OutRaw) const
+{
+	const int32 X = FMath::FloorToInt32(Pixel.X);
+	const int32 Y = FMath::FloorToInt32(Pixel.Y);
+	const float AlphaX = Pixel.X - X;
+	const float AlphaY = Pixel.Y - Y;
+
+	uint16 H00, H10, H01, H11;
+	if (!GetRaw(X, Y, H00) || !GetRaw(X + 1, Y, H10) || !GetRaw(X, Y + 1, H01) || !GetRaw(X + 1, Y + 1, H11)) return false;
+
+	OutRaw = FMath::Lerp(FMath::Lerp((float)H00, (float)H10, AlphaX), FMath::Lerp((float)H01, (float)H11, AlphaX), AlphaY);
+
+	return true;
+}
@@ -0,0 +1,546 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Terrain/TerrainGenerator.h"
+#include "Async/ParallelFor.h"
+#include "Misc/FileHelper.h"
+
+/** Water simulation step and gravity, the pipes are one sample long with a unit cross section */
+static constexpr float HydraulicTimeStep = .02f;
+static constexpr float Gravity = 9.81f;
+
+// ==================== Noise ==================== //
+
+/** Integer lattice hash, plain integer math so every platform produces the same terrain */
+static FORCEINLINE uint32 HashLattice(int32 X, int32 Y, uint32 Seed)
+{
+	uint32 Hash = Seed ^ ((uint32)X * 0x27d4eb2du) ^ ((uint32)Y * 0x165667b1u);
+	Hash = (Hash ^ (Hash >> 15)) * 0x85ebca6bu;
+	Hash = (Hash ^ (Hash >> 13)) * 0xc2b2ae35u;
+
+	return Hash ^ (Hash >> 16);
+}
+
+static FORCEINLINE float LatticeGradient(uint32 Hash, float X, float Y)
+{
+	// 8 directions are enough once a few octaves are stacked
+	switch (Hash & 7)
+	{
+	case 0:  return  X + Y;
+	case 1:  return  X - Y;
+	case 2:  return -X + Y;
+	case 3:  return -X - Y;
+	case 4:  return  X;
+	case 5:  return -X;
+	case 6:  return  Y;
+	default: return -Y;
+	}
+}
+
+/** Gradient noise, roughly -1 to 1 */
+static float GradientNoise(float X, float Y, uint32 Seed)
+{
+	const int32 CellX = FMath::FloorToInt32(X);
+	const int32 CellY = FMath::FloorToInt32(Y);
+	const float FracX = X - CellX;
+	const float FracY = Y - CellY;
+
+	// Quintic fade, continuous second derivative so erosion doesn't pick up the lattice
+	const float FadeX = FracX * FracX * FracX * (FracX * (FracX * 6.f - 15.f) + 10.f);
+	const float FadeY = FracY * FracY * FracY * (FracY * (FracY * 6.f - 15.f) + 10.f);
+
+	const float N00 = LatticeGradient(HashLattice(CellX,     CellY,     Seed), FracX,       FracY);
+	const float N10 = LatticeGradient(HashLattice(CellX + 1, CellY,     Seed), FracX - 1.f, FracY);
+	const float N01 = LatticeGradient(HashLattice(CellX,     CellY + 1, Seed), FracX,       FracY - 1.f);
+	const float N11 = LatticeGradient(HashLattice(CellX + 1, CellY + 1, Seed), FracX - 1.f, FracY - 1.f);
+
+	return FMath::Lerp(FMath::Lerp(N00, N10, FadeX), FMath::Lerp(N01, N11, FadeX), FadeY);
+}
+
+// ==================== Lifecycles ==================== //
+
+FTerrainGenerator::FTerrainGenerator(const FTerrainSettings& InSettings)
+	: Settings(InSettings)
+{
+	Settings.Resolution = FMath::Max(Settings.Resolution, 2);
+}
+
+template <typename BodyType>
+void FTerrainGenerator::ForEachRow(BodyType&& Body) const
+{
+	ParallelFor(Settings.Resolution, [&Body](int32 Y) { Body(Y); });
+}
+
+template <typename VectorBodyType, typename ScalarBodyType>
+void FTerrainGenerator::ForEachSample(VectorBodyType&& VectorBody, ScalarBodyType&& ScalarBody) const
+{
+	// Blocks are a multiple of 4, so only the very last one has a scalar tail
+	constexpr int32 BlockSize = 16384;
+	const int32 Num = Settings.Resolution * Settings.Resolution;
+
+	ParallelFor(FMath::DivideAndRoundUp(Num, BlockSize), [&](int32 Block)
+	{
+		const int32 End = FMath::Min((Block + 1) * BlockSize, Num);
+		int32 Index = Block * BlockSize;
+
+		for (; Index + 4 <= End; Index += 4) VectorBody(Index);
+		for (; Index < End; ++Index) ScalarBody(Index);
+	});
+}
+
+// ==================== Stages ==================== //
+
+void FTerrainGenerator::Generate()
+{
+	auto RunStage = [](const TCHAR* Name, auto&& Stage) {
+		const double StartTime = FPlatformTime::Seconds();
+		Stage();
+
+		UE_LOG(LogTemp, Display, TEXT("Terrain %s: %.2fs"), Name, FPlatformTime::Seconds() - StartTime);
+	};
+
+	RunStage(TEXT("Mountain"),  [this] { GenerateMountain(); });
+	RunStage(TEXT("Transform"), [this] { ApplyTransform(); });
+	RunStage(TEXT("Hydraulic"), [this] { ApplyHydraulicErosion(); });
+	RunStage(TEXT("Thermal"),   [this] { ApplyThermalErosion(); });
+	RunStage(TEXT("Sea"),       [this] { Normalize(); ApplySeaLevel(); });
+}
+
+void FTerrainGenerator::GenerateMountain()
+{
+	const int32 Res = Settings.Resolution;
+	Heights.SetNumUninitialized(Res * Res);
+
+	// Every octave gets its own offset so they don't line up at the origin
+	FRandomStream Stream(Settings.Seed);
+
+	TArray<FVector2f> Offsets;
+	for (int32 Octave = 0; Octave < Settings.Octaves; ++Octave)
+		Offsets.Add(FVector2f(Stream.FRandRange(-1000.f, 1000.f), Stream.FRandRange(-1000.f, 1000.f)));
+
+	const float InvSize = 1.f / (Res - 1);
+	float* Data = Heights.GetData();
+
+	ForEachRow([&](int32 Y)
+	{
+		for (int32 X = 0; X < Res; ++X)
+		{
+			const float U = X * InvSize;
+			const float V = Y * InvSize;
+
+			float Sum = 0.f;
+			float Norm = 0.f;
+			float Amplitude = 1.f;
+			float Frequency = Settings.Frequency;
+
+			for (int32 Octave = 0; Octave < Settings.Octaves; ++Octave)
+			{
+				const float Noise = GradientNoise(U * Frequency + Offsets[Octave].X, V * Frequency + Offsets[Octave].Y, Settings.Seed + Octave);
+
+				float Ridge = 1.f - FMath::Abs(Noise);
+				Ridge *= Ridge;
+
+				Sum  += FMath::Lerp(Noise * .5f + .5f, Ridge, Settings.Ridged) * Amplitude;
+				Norm += Amplitude;
+
+				Amplitude *= Settings.Gain;
+				Frequency *= Settings.Lacunarity;
+			}
+
+			// Radial falloff towards the edges
+			const float Distance = FVector2f(U - .5f, V - .5f).Size() * 2.f;
+			const float Mask = 1.f - FMath::SmoothStep(.4f, 1.2f, Distance);
+
+			Data[Y * Res + X] = (Norm > 0.f ? Sum / Norm : 0.f) * FMath::Lerp(1.f, Mask, Settings.Falloff);
+		}
+	});
+}
+
+void FTerrainGenerator::ApplyTransform()
+{
+	float* Data = Heights.GetData();
+
+	const VectorRegister4Float Scale    = VectorSetFloat1(Settings.HeightScale);
+	const VectorRegister4Float Offset   = VectorSetFloat1(Settings.HeightOffset);
+	const VectorRegister4Float Exponent = VectorSetFloat1(Settings.Exponent);
+	const VectorRegister4Float Lowest   = VectorSetFloat1(KINDA_SMALL_NUMBER);
+	const VectorRegister4Float One      = VectorOneFloat();
+
+	ForEachSample(
+		[&](int32 Index)
+		{
+			VectorRegister4Float Height = VectorMultiplyAdd(VectorLoad(Data + Index), Scale, Offset);
+			Height = VectorMin(VectorMax(Height, Lowest), One);
+
+			VectorStore(VectorPow(Height, Exponent), Data + Index);
+		},
+		[&](int32 Index)
+		{
+			const float Height = FMath::Clamp(Data[Index] * Settings.HeightScale + Settings.HeightOffset, KINDA_SMALL_NUMBER, 1.f);
+
+			Data[Index] = FMath::Pow(Height, Settings.Exponent);
+		}
+	);
+}
+
+void FTerrainGenerator::ApplyHydraulicErosion()
+{
+	const int32 Res = Settings.Resolution;
+	const int32 Num = Res * Res;
+
+	// Simulate in sample units so slopes are real slopes
+	const float ToSamples = Res * Settings.HeightRatio;
+
+	TArray<float> Bedrock;
+	Bedrock.SetNumUninitialized(Num);
+
+	TArray<float> Water, Sediment, Transported, FluxL, FluxR, FluxT, FluxB, VelocityX, VelocityY, Tilt;
+	for (TArray<float>* Buffer : { &Water, &Sediment, &Transported, &FluxL, &FluxR, &FluxT, &FluxB, &VelocityX, &VelocityY, &Tilt })
+		Buffer->SetNumZeroed(Num);
+
+	float* B  = Bedrock.GetData();
+	float* D  = Water.GetData();
+	float* FL = FluxL.GetData();
+	float* FR = FluxR.GetData();
+	float* FT = FluxT.GetData();
+	float* FB = FluxB.GetData();
+	float* VX = VelocityX.GetData();
+	float* VY = VelocityY.GetData();
+	float* TL = Tilt.GetData();
+	float* H  = Heights.GetData();
+
+	const VectorRegister4Float Zero     = VectorZeroFloat();
+	const VectorRegister4Float One      = VectorOneFloat();
+	const VectorRegister4Float Epsilon  = VectorSetFloat1(SMALL_NUMBER);
+	const VectorRegister4Float TimeStep = VectorSetFloat1(HydraulicTimeStep);
+	const VectorRegister4Float Pipe     = VectorSetFloat1(HydraulicTimeStep * Gravity);
+	const VectorRegister4Float Rain     = VectorSetFloat1(Settings.RainRate);
+	const VectorRegister4Float Capacity = VectorSetFloat1(Settings.SedimentCapacity);
+	const VectorRegister4Float Dissolve = VectorSetFloat1(Settings.Dissolving);
+	const VectorRegister4Float Deposit  = VectorSetFloat1(Settings.Deposition);
+	const VectorRegister4Float Evaporate = VectorSetFloat1(1.f - Settings.Evaporation * HydraulicTimeStep);
+	const VectorRegister4Float ToSamplesVector = VectorSetFloat1(ToSamples);
+
+	ForEachSample(
+		[&](int32 Index) { VectorStore(VectorMultiply(VectorLoad(H + Index), ToSamplesVector), B + Index); },
+		[&](int32 Index) { B[Index] = H[Index] * ToSamples; }
+	);
+
+	for (int32 Iteration = 0; Iteration < Settings.HydraulicIterations; ++Iteration)
+	{
+		// Rain
+		ForEachSample(
+			[&](int32 Index) { VectorStore(VectorAdd(VectorLoad(D + Index), Rain), D + Index); },
+			[&](int32 Index) { D[Index] += Settings.RainRate; }
+		);
+
+		// Outflow through the 4 pipes, scaled down so a sample never gives more water than it has
+		ForEachRow([&](int32 Y)
+		{
+			const int32 Row  = Y * Res;
+			const int32 Up   = FMath::Max(Y - 1, 0) * Res;
+			const int32 Down = FMath::Min(Y + 1, Res - 1) * Res;
+
+			// Clamped neighbours on the borders have no height difference, so nothing flows out of the map
+			auto FluxScalar = [&](int32 X)
+			{
+				const int32 Index = Row + X;
+				const int32 Left  = Row + FMath::Max(X - 1, 0);
+				const int32 Right = Row + FMath::Min(X + 1, Res - 1);
+				const float Surface = B[Index] + D[Index];
+
+				const float L = FMath::Max(0.f, FL[Index] + HydraulicTimeStep * Gravity * (Surface - B[Left]     - D[Left]));
+				const float R = FMath::Max(0.f, FR[Index] + HydraulicTimeStep * Gravity * (Surface - B[Right]    - D[Right]));
+				const float T = FMath::Max(0.f, FT[Index] + HydraulicTimeStep * Gravity * (Surface - B[Up + X]   - D[Up + X]));
+				const float Bo = FMath::Max(0.f, FB[Index] + HydraulicTimeStep * Gravity * (Surface - B[Down + X] - D[Down + X]));
+
+				const float Scale = FMath::Min(1.f, D[Index] / FMath::Max((L + R + T + Bo) * HydraulicTimeStep, SMALL_NUMBER));
+
+				FL[Index] = L * Scale;
+				FR[Index] = R * Scale;
+				FT[Index] = T * Scale;
+				FB[Index] = Bo * Scale;
+			};
+
+			FluxScalar(0);
+
+			int32 X = 1;
+			for (; X + 4 <= Res - 1; X += 4)
+			{
+				const int32 Index = Row + X;
+				const VectorRegister4Float Surface = VectorAdd(VectorLoad(B + Index), VectorLoad(D + Index));
+
+				auto Outflow = [&](const float* Flux, int32 Neighbour)
+				{
+					const VectorRegister4Float Difference = VectorSubtract(Surface, VectorAdd(VectorLoad(B + Neighbour), VectorLoad(D + Neighbour)));
+
+					return VectorMax(Zero, VectorMultiplyAdd(Pipe, Difference, VectorLoad(Flux + Index)));
+				};
+
+				const VectorRegister4Float L  = Outflow(FL, Index - 1);
+				const VectorRegister4Float R  = Outflow(FR, Index + 1);
+				const VectorRegister4Float T  = Outflow(FT, Up + X);
+				const VectorRegister4Float Bo = Outflow(FB, Down + X);
+
+				const VectorRegister4Float Total = VectorMultiply(VectorAdd(VectorAdd(L, R), VectorAdd(T, Bo)), TimeStep);
+				const VectorRegister4Float Scale = VectorMin(One, VectorDivide(VectorLoad(D + Index), VectorMax(Total, Epsilon)));
+
+				VectorStore(VectorMultiply(L, Scale),  FL + Index);
+				VectorStore(VectorMultiply(R, Scale),  FR + Index);
+				VectorStore(VectorMultiply(T, Scale),  FT + Index);
+				VectorStore(VectorMultiply(Bo, Scale), FB + Index);
+			}
+
+			for (; X < Res; ++X) FluxScalar(X);
+		});
+
+		// Water level, velocity and tilt from the new flux
+		ForEachRow([&](int32 Y)
+		{
+			for (int32 X = 0; X < Res; ++X)
+			{
+				const int32 Index = Y * Res + X;
+
+				// Nothing flows in from outside the map
+				const float FromLeft   = X > 0       ? FR[Index - 1]   : 0.f;
+				const float FromRight  = X < Res - 1 ? FL[Index + 1]   : 0.f;
+				const float FromTop    = Y > 0       ? FB[Index - Res] : 0.f;
+				const float FromBottom = Y < Res - 1 ? FT[Index + Res] : 0.f;
+
+				const float Inflow  = FromLeft + FromRight + FromTop + FromBottom;
+				const float Outflow = FL[Index] + FR[Index] + FT[Index] + FB[Index];
+
+				const float OldWater = D[Index];
+				const float NewWater = FMath::Max(0.f, OldWater + HydraulicTimeStep * (Inflow - Outflow));
+				const float Depth    = FMath::Max((OldWater + NewWater) * .5f, 1e-3f);
+
+				D[Index]  = NewWater;
+				VX[Index] = (FromLeft - FL[Index] + FR[Index] - FromRight) * .5f / Depth;
+				VY[Index] = (FromTop - FT[Index] + FB[Index] - FromBottom) * .5f / Depth;
+
+				const float GradientX = (B[Y * Res + FMath::Min(X + 1, Res - 1)] - B[Y * Res + FMath::Max(X - 1, 0)]) * .5f;
+				const float GradientY = (B[FMath::Min(Y + 1, Res - 1) * Res + X] - B[FMath::Max(Y - 1, 0) * Res + X]) * .5f;
+				const float Gradient  = GradientX * GradientX + GradientY * GradientY;
+
+				// Keep a little capacity on flat ground, otherwise lakes never fill with sediment
+				TL[Index] = FMath::Max(FMath::Sqrt(Gradient / (1.f + Gradient)), .05f);
+			}
+		});
+
+		// Dissolve where the water can carry more than it does, deposit where it carries too much
+		float* S = Sediment.GetData();
+
+		ForEachSample(
+			[&](int32 Index)
+			{
+				const VectorRegister4Float VelX  = VectorLoad(VX + Index);
+				const VectorRegister4Float VelY  = VectorLoad(VY + Index);
+				const VectorRegister4Float Speed = VectorSqrt(VectorMultiplyAdd(VelX, VelX, VectorMultiply(VelY, VelY)));
+
+				const VectorRegister4Float Carried    = VectorLoad(S + Index);
+				const VectorRegister4Float Difference = VectorSubtract(VectorMultiply(VectorMultiply(Capacity, VectorLoad(TL + Index)), Speed), Carried);
+				const VectorRegister4Float Rate       = VectorSelect(VectorCompareGT(Difference, Zero), Dissolve, Deposit);
+				const VectorRegister4Float Amount     = VectorMultiply(Rate, Difference);
+
+				VectorStore(VectorSubtract(VectorLoad(B + Index), Amount), B + Index);
+				VectorStore(VectorAdd(Carried, Amount), S + Index);
+			},
+			[&](int32 Index)
+			{
+				const float Speed      = FMath::Sqrt(VX[Index] * VX[Index] + VY[Index] * VY[Index]);
+				const float Difference = Settings.SedimentCapacity * TL[Index] * Speed - S[Index];
+				const float Amount     = (Difference > 0.f ? Settings.Dissolving : Settings.Deposition) * Difference;
+
+				B[Index] -= Amount;
+				S[Index] += Amount;
+			}
+		);
+
+		// Carry the sediment along the velocity (backwards lookup so every sample writes only itself)
+		float* Out = Transported.GetData();
+
+		ForEachRow([&](int32 Y)
+		{
+			for (int32 X = 0; X < Res; ++X)
+			{
+				const int32 Index = Y * Res + X;
+
+				const float SourceX = FMath::Clamp(X - VX[Index] * HydraulicTimeStep, 0.f, (float)(Res - 1));
+				const float SourceY = FMath::Clamp(Y - VY[Index] * HydraulicTimeStep, 0.f, (float)(Res - 1));
+
+				const int32 X0 = FMath::Min((int32)SourceX, Res - 2);
+				const int32 Y0 = FMath::Min((int32)SourceY, Res - 2);
+				const float AlphaX = SourceX - X0;
+				const float AlphaY = SourceY - Y0;
+
+				const float* Source = S + Y0 * Res + X0;
+
+				Out[Index] = FMath::Lerp(FMath::Lerp(Source[0], Source[1], AlphaX), FMath::Lerp(Source[Res], Source[Res + 1], AlphaX), AlphaY);
+			}
+		});
+
+		Swap(Sediment, Transported);
+
+		// Evaporation
+		ForEachSample(
+			[&](int32 Index) { VectorStore(VectorMultiply(VectorLoad(D + Index), Evaporate), D + Index); },
+			[&](int32 Index) { D[Index] *= 1.f - Settings.Evaporation * HydraulicTimeStep; }
+		);
+	}
+
+	// Whatever is still suspended settles where it is
+	const float* S = Sediment.GetData();
+	const VectorRegister4Float ToNormalized = VectorSetFloat1(1.f / ToSamples);
+
+	ForEachSample(
+		[&](int32 Index) { VectorStore(VectorMultiply(VectorAdd(VectorLoad(B + Index), VectorLoad(S + Index)), ToNormalized), H + Index); },
+		[&](int32 Index) { H[Index] = (B[Index] + S[Index]) / ToSamples; }
+	);
+}
+
+void FTerrainGenerator::ApplyThermalErosion()
+{
+	const int32 Res = Settings.Resolution;
+	const int32 Num = Res * Res;
+
+	// Talus as a height difference between neighbours, in normalized height
+	const float Talus = FMath::Tan(FMath::DegreesToRadians(Settings.TalusAngle)) / (Res * Settings.HeightRatio);
+
+	TArray<float> OutL, OutR, OutT, OutB;
+	for (TArray<float>* Buffer : { &OutL, &OutR, &OutT, &OutB })
+		Buffer->SetNumZeroed(Num);
+
+	float* H = Heights.GetData();
+
+	for (int32 Iteration = 0; Iteration < Settings.ThermalIterations; ++Iteration)
+	{
+		// How much each sample gives to each lower neighbour
+		ForEachRow([&](int32 Y)
+		{
+			for (int32 X = 0; X < Res; ++X)
+			{
+				const int32 Index = Y * Res + X;
+				const float Height = H[Index];
+
+				const float Drops[4] = {
+					Height - H[Y * Res + FMath::Max(X - 1, 0)],
+					Height - H[Y * Res + FMath::Min(X + 1, Res - 1)],
+					Height - H[FMath::Max(Y - 1, 0) * Res + X],
+					Height - H[FMath::Min(Y + 1, Res - 1) * Res + X]
+				};
+
+				float MaxDrop = 0.f;
+				float SteepDrops = 0.f;
+
+				for (float Drop : Drops)
+				{
+					MaxDrop = FMath::Max(MaxDrop, Drop);
+					if (Drop > Talus) SteepDrops += Drop;
+				}
+
+				// Half the excess keeps neighbours from swapping heights back and forth
+				const float Moved = MaxDrop > Talus ? (MaxDrop - Talus) * .5f / SteepDrops : 0.f;
+
+				OutL[Index] = Drops[0] > Talus ? Drops[0] * Moved : 0.f;
+				OutR[Index] = Drops[1] > Talus ? Drops[1] * Moved : 0.f;
+				OutT[Index] = Drops[2] > Talus ? Drops[2] * Moved : 0.f;
+				OutB[Index] = Drops[3] > Talus ? Drops[3] * Moved : 0.f;
+			}
+		});
+
+		// Give and take
+		ForEachRow([&](int32 Y)
+		{
+			for (int32 X = 0; X < Res; ++X)
+			{
+				const int32 Index = Y * Res + X;
+
+				const float Given    = OutL[Index] + OutR[Index] + OutT[Index] + OutB[Index];
+				const float Received = (X > 0       ? OutR[Index - 1]   : 0.f) +
+									   (X < Res - 1 ? OutL[Index + 1]   : 0.f) +
+									   (Y > 0       ? OutB[Index - Res] : 0.f) +
+									   (Y < Res - 1 ? OutT[Index + Res] : 0.f);
+
+				H[Index] += Received - Given;
+			}
+		});
+	}
+}
+
+void FTerrainGenerator::Normalize()
+{
+	const int32 Res = Settings.Resolution;
+
+	// Per row first, then across rows, so the result doesn't depend on the scheduling
+	TArray<FVector2f> RowRanges;
+	RowRanges.SetNumUninitialized(Res);
+
+	const float* Data = Heights.GetData();
+
+	ForEachRow([&](int32 Y)
+	{
+		FVector2f Range(TNumericLimits<float>::Max(), TNumericLimits<float>::Lowest());
+
+		for (int32 X = 0; X < Res; ++X)
+		{
+			Range.X = FMath::Min(Range.X, Data[Y * Res + X]);
+			Range.Y = FMath::Max(Range.Y, Data[Y * Res + X]);
+		}
+
+		RowRanges[Y] = Range;
+	});
+
+	FVector2f Range(TNumericLimits<float>::Max(), TNumericLimits<float>::Lowest());
+	for (const FVector2f& RowRange : RowRanges)
+	{
+		Range.X = FMath::Min(Range.X, RowRange.X);
+		Range.Y = FMath::Max(Range.Y, RowRange.Y);
+	}
+
+	const float Scale = Range.Y > Range.X ? 1.f / (Range.Y - Range.X) : 0.f;
+
+	const VectorRegister4Float MinVector   = VectorSetFloat1(Range.X);
+	const VectorRegister4Float ScaleVector = VectorSetFloat1(Scale);
+	float* Out = Heights.GetData();
+
+	ForEachSample(
+		[&](int32 Index) { VectorStore(VectorMultiply(VectorSubtract(VectorLoad(Out + Index), MinVector), ScaleVector), Out + Index); },
+		[&](int32 Index) { Out[Index] = (Out[Index] - Range.X) * Scale; }
+	);
+}
+
+void FTerrainGenerator::ApplySeaLevel()
+{
+	float* Data = Heights.GetData();
+	const VectorRegister4Float SeaLevel = VectorSetFloat1(Settings.SeaLevel);
+
+	ForEachSample(
+		[&](int32 Index) { VectorStore(VectorMax(VectorLoad(Data + Index), SeaLevel), Data + Index); },
+		[&](int32 Index) { Data[Index] = FMath::Max(Data[Index], Settings.SeaLevel); }
+	);
+}
+
+// ==================== Output ==================== //
+
+void FTerrainGenerator::ToR16(TArray<uint16>& OutHeights) const
+{
+	OutHeights.SetNumUninitialized(Heights.Num());
+
+	const float* Data = Heights.GetData();
+	uint16* Out = OutHeights.GetData();
+
+	ForEachRow([&](int32 Y)
+	{
+		const int32 Row = Y * Settings.Resolution;
+
+		for (int32 X = 0; X < Settings.Resolution; ++X)
+			Out[Row + X] = (uint16)FMath::RoundToInt32(FMath::Clamp(Data[Row + X], 0.f, 1.f) * MAX_uint16);
+	});
+}
+
+bool FTerrainGenerator::SaveR16(const FString& Path) const
+{
+	TArray<uint16> Samples;
+	ToR16(Samples);
+
+	return FFileHelper::SaveArrayToFile(TArrayView<const uint8>(reinterpret_cast<const uint8*>(Samples.GetData()), Samples.Num() * sizeof(uint16)), *Path);
+}
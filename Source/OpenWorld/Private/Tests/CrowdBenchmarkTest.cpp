@@ -0,0 +1,164 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "DevelopmentUtils/CrowdBenchmark.h"
+#include "AI/AISystemBase.h"
+#include "Components/BrushComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "Misc/AutomationTest.h"
+#include "NavigationInvokerComponent.h"
+#include "NavigationSystem.h"
+#include "NavMesh/NavMeshBoundsVolume.h"
+#include "NavMesh/RecastNavMesh.h"
+#include "PhysicsEngine/BodySetup.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CrowdBenchmarkTest
+{
+	/** Half size of the arena, both armies and the gap between them fit with room to move around */
+	constexpr float ArenaExtent = 10000.f;
+
+	/** Same as the benchmark, the world is ticked by hand */
+	constexpr float DeltaTime = 1.f / 30.f;
+
+	/** The navmesh is built around an invoker, which only updates every ActiveTilesUpdateInterval */
+	constexpr int32 MaxNavigationFrames = 30 * 60;
+
+	/** A flat floor with a navmesh over all of it, the same every run whatever map the project opens on */
+	UWorld* CreateArena(FAutomationTestBase& Test)
+	{
+		UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("CrowdBenchmarkArena"));
+
+		FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		WorldContext.SetCurrentWorld(World);
+
+		FNavigationSystem::AddNavigationSystemToWorld(*World, FNavigationSystemRunMode::GameMode);
+
+		// Floor, a flattened engine cube whose top is at 0
+		AStaticMeshActor* Floor = World->SpawnActorDeferred<AStaticMeshActor>(AStaticMeshActor::StaticClass(), FTransform(FVector(0.f, 0.f, -50.f)));
+		Floor->GetStaticMeshComponent()->SetStaticMesh(LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube")));
+		Floor->GetStaticMeshComponent()->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+		Floor->FinishSpawning(FTransform(FRotator::ZeroRotator, FVector(0.f, 0.f, -50.f), FVector(ArenaExtent / 50.f, ArenaExtent / 50.f, 1.f)));
+
+		// Navigable bounds, the volume has no brush at runtime so its bounds come from a box body
+		ANavMeshBoundsVolume* NavBounds = World->SpawnActor<ANavMeshBoundsVolume>();
+		UBodySetup* BodySetup = NewObject<UBodySetup>(NavBounds);
+		BodySetup->AggGeom.BoxElems.Add(FKBoxElem(ArenaExtent * 2.f, ArenaExtent * 2.f, 2000.f));
+
+		NavBounds->GetBrushComponent()->BrushBodySetup = BodySetup;
+		NavBounds->GetBrushComponent()->UpdateBounds();
+
+		// The project builds the navmesh around invokers only, cover the whole arena with one before anybody moves
+		UNavigationInvokerComponent* Invoker = NewObject<UNavigationInvokerComponent>(Floor);
+		Invoker->SetGenerationRadii(ArenaExtent * 1.5f, ArenaExtent * 2.f);
+		Invoker->RegisterComponent();
+
+		World->InitializeActorsForPlay(FURL());
+
+		// No game mode in here to start play, do what it would
+		World->BeginPlay();
+		World->GetWorldSettings()->NotifyBeginPlay();
+		if (UAISystemBase* AISystem = World->GetAISystem()) AISystem->StartPlay();
+
+		UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World);
+
+		if (!NavSys)
+		{
+			Test.AddError(TEXT("No navigation system in the arena"));
+			return World;
+		}
+
+		NavSys->OnNavigationBoundsUpdated(NavBounds);
+		NavSys->Build();
+
+		// Wait for the tiles, outside of the measurement
+		for (int32 Frame = 0; Frame < MaxNavigationFrames; ++Frame)
+		{
+			const ARecastNavMesh* NavMesh = Cast<ARecastNavMesh>(NavSys->GetDefaultNavDataInstance(FNavigationSystem::DontCreate));
+			if (NavMesh && NavMesh->GetNavMeshTilesCount() > 0 && !NavSys->IsNavigationBuildInProgress()) return World;
+
+			World->Tick(LEVELTICK_All, DeltaTime);
+			++GFrameCounter;
+		}
+
+		Test.AddError(TEXT("The arena navmesh wasn't built"));
+
+		return World;
+	}
+
+	void DestroyArena(UWorld* World)
+	{
+		World->BeginTearingDown();
+
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+}
+
+/**
+ * One run per army size, so the CSV shows how the frame time scales with the number of combatants.
+ * Duration and seed from the command line, -OWCrowdDuration=30 -OWCrowdSeed=1
+ */
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FCrowdBenchmarkTest, "OpenWorld.Combat.CrowdBenchmark", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+void FCrowdBenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	for (const int32 Count : { 10, 25, 50 })
+	{
+		OutBeautifiedNames.Add(FString::Printf(TEXT("%dv%d"), Count, Count));
+		OutTestCommands.Add(FString::Printf(TEXT("%d %d"), Count, Count));
+	}
+}
+
+bool FCrowdBenchmarkTest::RunTest(const FString& Parameters)
+{
+	using namespace CrowdBenchmarkTest;
+
+	TArray<FString> Args;
+	Parameters.ParseIntoArrayWS(Args);
+
+	const int32 Friends = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 25;
+	const int32 Enemies = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 25;
+
+	float Duration = 30.f;
+	int32 Seed     = 1;
+	FParse::Value(FCommandLine::Get(), TEXT("OWCrowdDuration="), Duration);
+	FParse::Value(FCommandLine::Get(), TEXT("OWCrowdSeed="), Seed);
+
+	UWorld* World = CreateArena(*this);
+
+	if (!HasAnyErrors())
+	{
+		TWeakObjectPtr<ACrowdBenchmark> Benchmark = World->SpawnActor<ACrowdBenchmark>();
+
+		if (Benchmark.IsValid())
+		{
+			Benchmark->Run(Friends, Enemies, FMath::Max(Duration, 1.f), Seed, false);
+
+			// It destroys itself once the results are written. The cap only guards against a run that never ends
+			const int32 MaxFrames = FMath::CeilToInt32(Duration / DeltaTime) * 2 + 10;
+
+			for (int32 Frame = 0; Frame < MaxFrames && Benchmark.IsValid() && Benchmark->IsRunning(); ++Frame)
+			{
+				World->Tick(LEVELTICK_All, DeltaTime);
+				++GFrameCounter;
+			}
+
+			TestFalse(TEXT("Benchmark finished"), Benchmark.IsValid() && Benchmark->IsRunning());
+		}
+		else
+			AddError(TEXT("Failed to spawn the benchmark"));
+	}
+
+	DestroyArena(World);
+
+	return !HasAnyErrors();
+}
+
+#endif
@@ -0,0 +1,172 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Terrain/HeightmapTiled.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Terrain/HeightmapR16.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace HeightmapTiledTest
+{
+	/** Not a multiple of any tile size below, so the right and bottom tiles are cut short */
+	constexpr int32 Width  = 257;
+	constexpr int32 Height = 193;
+
+	/** Rolling hills on the left half (compresses well), noise on the right half (doesn't) */
+	TArray<uint16> MakeHeightmap()
+	{
+		FRandomStream Stream(1337);
+
+		TArray<uint16> Heights;
+		Heights.SetNumUninitialized(Width * Height);
+
+		for (int32 Y = 0; Y < Height; ++Y)
+			for (int32 X = 0; X < Width; ++X)
+			{
+				const float Hills = 32768.f + 12000.f * FMath::Sin(X * .05f) * FMath::Cos(Y * .07f) + 3000.f * FMath::Sin((X + Y) * .21f);
+
+				Heights[Y * Width + X] = X < Width / 2 ? (uint16)FMath::Clamp(FMath::RoundToInt32(Hills), 0, (int32)MAX_uint16) : (uint16)Stream.RandRange(0, MAX_uint16);
+			}
+
+		return Heights;
+	}
+}
+
+/**
+ * EncodeTile/DecodeTile round trip in memory, every sample must come back within MaxError. Covers edge tiles,
+ * flat tiles, and both zlib compressed and stored payloads
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHeightmapTiledRoundTripTest, "OpenWorld.Terrain.HeightmapTiled.RoundTrip", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FHeightmapTiledRoundTripTest::RunTest(const FString& Parameters)
+{
+	using namespace HeightmapTiledTest;
+
+	const TArray<uint16> Heights = MakeHeightmap();
+
+	bool bAnyCompressed = false;
+	bool bAnyStored     = false;
+
+	for (const int32 TileSize : { 2, 16, 64, 100 })
+		for (const int32 MaxError : { 0, 1, 8, 100 })
+		{
+			int32 WorstError = 0;
+			bool bDecoded    = true;
+
+			for (int32 TileY = 0; TileY * TileSize < Height; ++TileY)
+				for (int32 TileX = 0; TileX * TileSize < Width; ++TileX)
+				{
+					const int32 TileWidth  = FMath::Min(TileSize, Width - TileX * TileSize);
+					const int32 TileHeight = FMath::Min(TileSize, Height - TileY * TileSize);
+
+					TArray<uint16> Samples;
+					Samples.SetNumUninitialized(TileWidth * TileHeight);
+
+					for (int32 Row = 0; Row < TileHeight; ++Row)
+						FMemory::Memcpy(&Samples[Row * TileWidth], &Heights[(TileY * TileSize + Row) * Width + TileX * TileSize], TileWidth * sizeof(uint16));
+
+					FHeightmapTileEntry Entry;
+					TArray<uint8> Payload;
+					FHeightmapTiled::EncodeTile(Samples, TileWidth, MaxError, Entry, Payload);
+
+					bAnyCompressed |= Entry.bCompressed;
+					bAnyStored     |= !Entry.bCompressed;
+
+					TArray<uint16> Decoded;
+					if (!FHeightmapTiled::DecodeTile(Payload, Entry, TileWidth, TileHeight, Decoded) || Decoded.Num() != Samples.Num())
+					{
+						bDecoded = false;
+						continue;
+					}
+
+					for (int32 Index = 0; Index < Samples.Num(); ++Index)
+						WorstError = FMath::Max(WorstError, FMath::Abs(Samples[Index] - Decoded[Index]));
+				}
+
+			TestTrue(FString::Printf(TEXT("Tile size %d, max error %d: every tile decodes"), TileSize, MaxError), bDecoded);
+			TestTrue(FString::Printf(TEXT("Tile size %d, max error %d: worst error %d"), TileSize, MaxError, WorstError), WorstError <= MaxError);
+		}
+
+	// Flat, no steps at all
+	{
+		TArray<uint16> Flat;
+		Flat.Init(32768, 16 * 16);
+
+		FHeightmapTileEntry Entry;
+		TArray<uint8> Payload;
+		FHeightmapTiled::EncodeTile(Flat, 16, 8, Entry, Payload);
+
+		TArray<uint16> Decoded;
+		TestTrue(TEXT("Flat tile decodes"), FHeightmapTiled::DecodeTile(Payload, Entry, 16, 16, Decoded));
+		TestTrue(TEXT("Flat tile is exact"), Decoded == Flat);
+	}
+
+	TestTrue(TEXT("Some tiles were compressed"), bAnyCompressed);
+	TestTrue(TEXT("Some tiles were stored"), bAnyStored);
+
+	return true;
+}
+
+/** Through a file: Encode, Open, DecodeAll and Stream, then a damaged index must be refused before any tile is read */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHeightmapTiledFileTest, "OpenWorld.Terrain.HeightmapTiled.File", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FHeightmapTiledFileTest::RunTest(const FString& Parameters)
+{
+	using namespace HeightmapTiledTest;
+
+	const FString SourcePath = FPaths::AutomationTransientDir() / TEXT("HeightmapTiledTest.r16");
+	const FString TiledPath  = FPaths::AutomationTransientDir() / TEXT("HeightmapTiledTest.owh");
+
+	const TArray<uint16> Heights = MakeHeightmap();
+
+	if (!FFileHelper::SaveArrayToFile(TArrayView<const uint8>((const uint8*)Heights.GetData(), Heights.Num() * sizeof(uint16)), *SourcePath))
+	{
+		AddError(FString::Printf(TEXT("Failed to write %s"), *SourcePath));
+		return false;
+	}
+
+	{
+		FHeightmapR16 Source;
+		if (!TestTrue(TEXT("Source opens"), Source.Open(SourcePath, Width))) return false;
+		if (!TestTrue(TEXT("Encodes"), FHeightmapTiled::Encode(Source, TiledPath, 64, 0))) return false;
+	}
+
+	{
+		FHeightmapTiled Tiled;
+		if (!TestTrue(TEXT("Opens"), Tiled.Open(TiledPath))) return false;
+
+		TArray<uint16> Decoded;
+		TestTrue(TEXT("Decodes"), Tiled.DecodeAll(Decoded));
+		TestTrue(TEXT("Lossless round trip"), Decoded == Heights);
+
+		// A 10x10 region inside the first tile, then one across the four tiles around (64, 64)
+		TestEqual(TEXT("One tile streamed"), Tiled.Stream(FIntRect(5, 5, 15, 15), 0), 1);
+		TestEqual(TEXT("Three more streamed"), Tiled.Stream(FIntRect(60, 60, 70, 70), 0), 3);
+	}
+
+	// The first entry's Size sits after the 20 byte header and its 8 byte Offset
+	TArray<uint8> Bytes;
+	FFileHelper::LoadFileToArray(Bytes, *TiledPath);
+
+	AddExpectedError(TEXT("corrupted index"), EAutomationExpectedErrorFlags::Contains, 2);
+
+	for (const int32 Size : { -1, MAX_int32 })
+	{
+		TArray<uint8> Damaged = Bytes;
+		FMemory::Memcpy(&Damaged[28], &Size, sizeof(int32));
+		FFileHelper::SaveArrayToFile(Damaged, *TiledPath);
+
+		FHeightmapTiled Tiled;
+		TestFalse(FString::Printf(TEXT("Tile size %d refused"), Size), Tiled.Open(TiledPath));
+	}
+
+	IFileManager::Get().Delete(*SourcePath);
+	IFileManager::Get().Delete(*TiledPath);
+
+	return true;
+}
+
+#endif
@@ -2,6 +2,7 @@
 
 #include "Weapons/MeleeWeapon.h"
 #include "Components/BoxComponent.h"
+#include "Components/CooldownComponent.h"
 #include "Components/SphereComponent.h"
 #include "Characters/PlayerCharacter.h"
 #include "Enums/CollisionChannel.h"
@@ -10,9 +11,14 @@
 #include "Kismet/GameplayStatics.h"
 #include "NiagaraComponent.h"
 #include "NiagaraFunctionLibrary.h"
+#include "OpenWorld.h"
+#include "Subsystems/DecalSubsystem.h"
+#include "Subsystems/SimulationSubsystem.h"
 
 AMeleeWeapon::AMeleeWeapon()
 {
+	LLM_SCOPE_BYTAG(OW_Weapons);
+
 	PrimaryActorTick.bCanEverTick = false;
 
 	// Base Mesh
@@ -43,6 +49,9 @@ AMeleeWeapon::AMeleeWeapon()
 	InteractArea->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
 	InteractArea->SetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn, ECollisionResponse::ECR_Overlap);
 
+	// Cooldowns
+	Cooldowns = CreateDefaultSubobject<UCooldownComponent>(TEXT("Cooldowns"));
+
 	// ...
 	DefaultInitializer();
 }
@@ -64,12 +73,24 @@ void AMeleeWeapon::DefaultInitializer()
 
 void AMeleeWeapon::BeginPlay()
 {
+	LLM_SCOPE_BYTAG(OW_Weapons);
+
 	Super::BeginPlay();
 	
 	// Binding Collision Events
 	HitBox->OnComponentBeginOverlap.AddDynamic(this, &ThisClass::OnWeaponOverlap);
 	InteractArea->OnComponentBeginOverlap.AddDynamic(this, &ThisClass::OnEnterInteract);
 	InteractArea->OnComponentEndOverlap  .AddDynamic(this, &ThisClass::OnLeaveInteract);
+
+	// Cooldowns
+	Cooldowns->BindLambda(ECooldown::EC_TempDamage, [this]() {
+		Damage 	   = DefaultDamage;
+		bBlockable = true;
+	});
+	Cooldowns->BindLambda(ECooldown::EC_DisablePhysics, [this]() {
+		BaseMesh->SetSimulatePhysics(false);
+		BaseMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	});
 }
 
 // ==================== Collision Events ==================== //
@@ -90,7 +111,7 @@ void AMeleeWeapon::OnEnterInteract(UPrimitiveComponent* OverlappedComponent, AAc
 	if (!PlayerCharacter) return;
 
 	PlayerCharacter->SetOverlappingWeapon(this);
-	PlayerCharacter->ShowTip(TEXT("[F] - To pickup weapon"));
+	PlayerCharacter->ShowTip(ETipMessage::ETM_PickupWeapon, this);
 }
 
 void AMeleeWeapon::OnLeaveInteract(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
@@ -100,7 +121,7 @@ void AMeleeWeapon::OnLeaveInteract(UPrimitiveComponent* OverlappedComponent, AAc
 	if (!PlayerCharacter) return;
 
 	PlayerCharacter->SetOverlappingWeapon(nullptr);
-	PlayerCharacter->HideTip();
+	PlayerCharacter->HideTip(this);
 }
 
 // ==================== Interfaces ==================== //
@@ -126,6 +147,8 @@ void AMeleeWeapon::EquipTo(bool bEquipping)
 
 void AMeleeWeapon::Drop()
 {
+	CSV_CUSTOM_STAT(OpenWorldPopulation, WeaponDrops, 1, ECsvCustomStatOp::Accumulate);
+
 	DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
 
 	// Enable physics
@@ -134,11 +157,7 @@ void AMeleeWeapon::Drop()
 	BaseMesh->SetSimulatePhysics(true);
 
 	// For the sake of performance, disable physics
-	FTimerHandle DisableDelay;
-	GetWorldTimerManager().SetTimer(DisableDelay, [this]() {
-		BaseMesh->SetSimulatePhysics(false);
-		BaseMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-	}, 9.f, false);
+	Cooldowns->Start(ECooldown::EC_DisablePhysics, 9.f);
 
 	// Reset Owner
 	CharacterOwner = nullptr;
@@ -152,16 +171,30 @@ void AMeleeWeapon::Drop()
 
 void AMeleeWeapon::ApplyDamage(FHitResult &TraceResult)
 {
+	LLM_SCOPE_BYTAG(OW_CombatFX);
+
+	OW_SCOPE_CYCLE_COUNTER(ApplyDamage);
+
 	IHitInterface* ActorHit = Cast<IHitInterface>(TraceResult.GetActor());
 
 	// Only applying damage if other is enemy and damagable
 	if (!ActorHit || !ActorHit->IsEnemy(CharacterOwner.Get())) return;
 	
 	// Apply damage
-	float RandomOffset = FMath::RandRange(1.f, 5.f); 
-	float GivenDamage  = FMath::RandRange(Damage - RandomOffset, Damage + RandomOffset);
+	FRandomStream& Stream = USimulationSubsystem::GetStream(this, ERandomStream::ERS_Combat);
+
+	float RandomOffset = Stream.FRandRange(1.f, 5.f); 
+	float GivenDamage  = Stream.FRandRange(Damage - RandomOffset, Damage + RandomOffset);
 
 	ActorHit->OnWeaponHit(CharacterOwner.Get(), TraceResult.ImpactPoint, GivenDamage, bBlockable);
+	OW_INC_COUNTER(Hits);
+
+	UE_TRACE_LOG(OpenWorld, CombatHit, OpenWorldChannel)
+		<< CombatHit.Cycle(FPlatformTime::Cycles64())
+		<< CombatHit.Attacker(CharacterOwner.IsValid() ? CharacterOwner->GetUniqueID() : 0)
+		<< CombatHit.Victim(TraceResult.GetActor()->GetUniqueID())
+		<< CombatHit.Damage(GivenDamage)
+		<< CombatHit.Blocked(ActorHit->IsBlocking());
 
 	// Spawn blood trail only when oponent is not blocking the attack
 	if (!ActorHit->IsBlocking())
@@ -176,12 +209,15 @@ void AMeleeWeapon::ApplyDamage(FHitResult &TraceResult)
 			true
 		);
 		BloodTrailComponent->Activate();
+		OW_INC_COUNTER(NiagaraSpawns);
 		BloodTrailComponent->SetVariableObject(TEXT("User.ObjCollisionCallback"), this);
 	}
 }
 
 void AMeleeWeapon::HitTrace(FHitResult& TraceResult)
 {
+	OW_SCOPE_CYCLE_COUNTER(HitTrace);
+
     FVector Offset = HitBox->GetUpVector() * HitBox->GetScaledBoxExtent().Z;
     FVector StartTrace = HitBox->GetComponentLocation() - Offset;
     FVector EndTrace   = HitBox->GetComponentLocation() + Offset;
@@ -225,20 +261,24 @@ void AMeleeWeapon::SetTempDamage(float TempDamage, bool bDamageBlockable /*= tru
 	bBlockable = bDamageBlockable;
 
 	// Set the timer
-	GetWorldTimerManager().SetTimer(TempDamageDelayHandler, [this]() {
-		Damage 	   = DefaultDamage;
-		bBlockable = true;
-	}, 1.f, false);
+	Cooldowns->Start(ECooldown::EC_TempDamage, 1.f);
 }
 
 void AMeleeWeapon::ReceiveParticleData_Implementation(const TArray<FBasicParticleData>& Data, UNiagaraSystem* NiagaraSystem, const FVector& SimulationPositionOffset)
 {
-	// Spawn a blood splatter
+	LLM_SCOPE_BYTAG(OW_CombatFX);
+
+	UDecalSubsystem* DecalSubsystem = GetWorld()->GetSubsystem<UDecalSubsystem>();
+
+	if (!DecalSubsystem) return;
+
+	// Spawn a blood splatter, the subsystem takes care of merging close ones and capping the amount
+	UMaterialInterface* SplatterMaterial = BloodSplatter.LoadSynchronous();
+
 	for (const auto& Dat : Data)
 	{
-		UGameplayStatics::SpawnDecalAtLocation(
-			this,
-			BloodSplatter.LoadSynchronous(),
+		DecalSubsystem->SpawnDecal(
+			SplatterMaterial,
 			{ 5.f, 10.f, 10.f },
 			Dat.Position,
 			FRotator(-90.f, 0.f, 0.f),
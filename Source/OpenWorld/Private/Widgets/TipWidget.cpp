@@ -3,8 +3,8 @@
 #include "Widgets/TipWidget.h"
 #include "Components/TextBlock.h"
 
-void UTipWidget::ShowTip(const FString& Text)
+void UTipWidget::ShowTip(const FText& Text)
 {
-    TipText->SetText(FText::FromString(Text));
+    TipText->SetText(Text);
     SetVisibility(ESlateVisibility::Visible);
 }
@@ -8,11 +8,10 @@
 
 class ACombatController;
 class AMeleeWeapon;
+class AOWHUD;
 class APlayerCharacter;
-class UHealthBar;
 class UNavigationInvokerComponent;
 class USoundBase;
-class UWidgetComponent;
 
 UCLASS()
 class OPENWORLD_API ACombatCharacter : public AOWCharacter
@@ -34,6 +33,16 @@ public:
 	/*~ */
 	virtual void OnWeaponHit(AOWCharacter* DamagingCharacter, const FVector& HitImpact, const float GivenDamage, bool bBlockable) override;
 
+	// ===== Streaming ========== //
+
+	/**
+	 * Between SpawnActorDeferred and FinishSpawning, so BeginPlay already picks them up
+	 *
+	 * @param InWeaponClass None picks one of GivenWeaponClasses
+	 * @param InHealth 0 or less is full health
+	 */
+	void InitializeSpawn(ETeam InTeam, TSubclassOf<AMeleeWeapon> InWeaponClass, float InHealth);
+
 protected:
 	// ===== References ========== //
 
@@ -46,12 +55,6 @@ protected:
 
 	// ===== Components ========== //
 
-	UPROPERTY(VisibleAnywhere)
-	TObjectPtr<UWidgetComponent> HealthBar;
-
-	UPROPERTY(VisibleAnywhere)
-	TObjectPtr<UWidgetComponent> AttackIndicator;
-
 	UPROPERTY(VisibleAnywhere)
 	TObjectPtr<UNavigationInvokerComponent> NavInvoker;
 
@@ -64,6 +67,10 @@ protected:
 	UPROPERTY(EditAnywhere, Category = Combat)
 	TArray<TSubclassOf<AMeleeWeapon>> GivenWeaponClasses;
 
+	/** Set by whoever spawned us, wins over a random pick */
+	UPROPERTY()
+	TSubclassOf<AMeleeWeapon> SpawnWeaponClass;
+
 	void RandomizeWeapon();
 
 	virtual void AttackCombo() override;
@@ -74,9 +81,12 @@ protected:
 
 	// ===== UI ========== //
 
-	/** The actual health bar */
+	/** Health bar and attack indicator are drawn by the HUD overlay, we only report changes */
 	UPROPERTY()
-	TWeakObjectPtr<UHealthBar> HealthBarWidget;
+	TWeakObjectPtr<AOWHUD> OWHUD;
+
+	AOWHUD* GetOWHUD();
+	void SetAttackIndicator(bool bVisible);
 
 	// ===== Audio ========== //
 
@@ -10,6 +10,7 @@
 #include "OWCharacter.generated.h"
 
 class AMeleeWeapon;
+class UCooldownComponent;
 class USphereComponent;
 class UNiagaraSystem;
 
@@ -53,6 +54,10 @@ protected:
 	UPROPERTY(VisibleAnywhere) 
 	TObjectPtr<USphereComponent> KickHitbox;
 
+	/** Root motion, stun, combo, charge and ragdoll delays */
+	UPROPERTY(VisibleAnywhere)
+	TObjectPtr<UCooldownComponent> Cooldowns;
+
 	// ***===== Locomotions ==========*** //
 
 	UPROPERTY(EditAnywhere, Category=Locomotions)
@@ -71,9 +76,6 @@ protected:
 	UFUNCTION(BlueprintCallable)
 	void MoveForward();
 
-	/** Re-enabling root motion after certain time */
-	FTimerHandle RootMotionTimerHandler;
-
 	// ***===== Attributes ==========*** //
 
 	ECharacterState CharacterState = ECharacterState::ECS_NoAction;
@@ -99,8 +101,6 @@ protected:
 	
 	// *** Stunned *** //
 
-	FTimerHandle StunTimerHandle;
-	
 	FORCEINLINE void FinishedStunned();
 
 	// ***===== Combat ==========*** //
@@ -121,8 +121,6 @@ protected:
 	int8 AttackCount  = 0;
 
 	/** Combo timer, when its over so do the combo */
-	FTimerHandle ComboOverHandler;
-
 	UPROPERTY(EditAnywhere, Category=Combat)
 	float ComboOverTimer = 2.f;
 
@@ -180,7 +178,6 @@ protected:
 	float DamageMultiplier = 1.f;
 
 	/** Once the time is passed, will use charge attack instead */
-	FTimerHandle ChargeTimerHandle;
 	float ChargeAfter = .2f;
 	float AutoChargeTimer = 1.f;
 
@@ -260,4 +257,16 @@ public:
 	{
 		return Team;
 	}
+	FORCEINLINE float GetHealth() const
+	{
+		return Health;
+	}
+	FORCEINLINE float GetMaxHealth() const
+	{
+		return MaxHealth;
+	}
+	FORCEINLINE AMeleeWeapon* GetCarriedWeapon() const
+	{
+		return CarriedWeapon.Get();
+	}
 };
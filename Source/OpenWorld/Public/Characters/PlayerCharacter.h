@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "Characters/OWCharacter.h"
+#include "Enums/TipMessage.h"
+#include "Subsystems/GlobalParamSubsystem.h"
 #include "PlayerCharacter.generated.h"
 
 class AOWPlayerController;
@@ -41,8 +43,9 @@ public:
 
 	// ***===== UI ==========*** //
 
-	FORCEINLINE void ShowTip(const FString& Text);
-	FORCEINLINE void HideTip();
+	/** See AOWHUD::ShowTip, Source is whoever the tip is about */
+	void ShowTip(ETipMessage Tip, const UObject* Source);
+	void HideTip(const UObject* Source);
 
 protected:
 
@@ -77,12 +80,6 @@ private:
 
 	// ***===== References ==========*** //
 
-	UPROPERTY(EditAnywhere, Category=Materials)
-	TSoftObjectPtr<UMaterialParameterCollection> GlobalMatParam;
-
-	UPROPERTY()
-	TWeakObjectPtr<UMaterialParameterCollectionInstance> GlobalMatParamIns;
-
 	UPROPERTY()
 	TWeakObjectPtr<AOWPlayerController> OWPlayerController;
 
@@ -165,8 +162,7 @@ private:
 
 	// ***===== Parry ==========*** //
 
-	/** Will stunt the enemy if parry is succeed */
-	FTimerHandle ParryTimerHandle;
+	/** Will stunt the enemy if parry is succeed, the window is the EC_Parry cooldown */
 	float ParryTimer = 1.2f;
 
 	/** Slow down effect with timeline */
@@ -176,10 +172,7 @@ private:
 	/** Will be checked on the OnWeaponHit event 
 	 * @see OnWeaponHit
 	 */
-	FORCEINLINE const bool IsParrySucceed() const
-	{
-		return bSucceedBlocking && GetWorldTimerManager().IsTimerActive(ParryTimerHandle);
-	}
+	const bool IsParrySucceed() const;
 	
 	/** If succeed, the player will stunt the enemy */
 	FORCEINLINE void Parry(AOWCharacter* DamagingCharacter);
@@ -195,6 +188,14 @@ private:
 	FVector LastLocation1;
 	FVector LastLocation2;
 
+	/** MP_Global parameters, resolved once @see UGlobalParamSubsystem */
+	UPROPERTY()
+	TWeakObjectPtr<UGlobalParamSubsystem> GlobalParams;
+
+	FGlobalParamHandle CurrentLocationParam;
+	FGlobalParamHandle LastLocationParam;
+	FGlobalParamHandle LastLocation2Param;
+
 	/** Make nearby character's foliage bending */
 	void AffectsFoliage();
 
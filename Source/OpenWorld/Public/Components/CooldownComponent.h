@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Enums/Cooldown.h"
+#include "CooldownComponent.generated.h"
+
+class UCooldownSubsystem;
+
+/**
+ * Replaces the owner's FTimerHandles with fixed slots. Handlers are bound once, starting a cooldown only writes its expiry
+ * time, and every component of the world is checked in one pass by UCooldownSubsystem. Doesn't tick on its own
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class OPENWORLD_API UCooldownComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UCooldownComponent();
+
+	// ===== Handlers ========== //
+
+	template<typename UserClass>
+	FORCEINLINE void Bind(ECooldown Cooldown, UserClass* Object, void (UserClass::*Function)())
+	{
+		Handlers[(uint8)Cooldown].BindUObject(Object, Function);
+	}
+
+	/** Not called anymore once the owner is gone */
+	template<typename FunctorType>
+	FORCEINLINE void BindLambda(ECooldown Cooldown, FunctorType&& Functor)
+	{
+		Handlers[(uint8)Cooldown].BindWeakLambda(GetOwner(), Forward<FunctorType>(Functor));
+	}
+
+	// ===== Cooldowns ========== //
+
+	/** (Re)start it, the handler is called once Duration (dilated) seconds have passed */
+	void Start(ECooldown Cooldown, float Duration);
+	void Stop(ECooldown Cooldown);
+	void StopAll();
+
+	bool IsActive(ECooldown Cooldown) const;
+	float GetRemaining(ECooldown Cooldown) const;
+	int32 GetActiveCount() const;
+
+protected:
+	// ===== Lifecycles ========== //
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	friend class UCooldownSubsystem;
+
+	FSimpleDelegate Handlers[(uint8)ECooldown::EC_Max];
+
+	/** Where our slots are in the subsystem */
+	TWeakObjectPtr<UCooldownSubsystem> Subsystem;
+	int32 Handle = INDEX_NONE;
+
+	/** Registered on the first start */
+	UCooldownSubsystem* GetSubsystem();
+
+	FORCEINLINE void OnExpired(ECooldown Cooldown)
+	{
+		Handlers[(uint8)Cooldown].ExecuteIfBound();
+	}
+};
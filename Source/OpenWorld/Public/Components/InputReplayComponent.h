@@ -0,0 +1,118 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "InputActionValue.h"
+#include "InputReplayComponent.generated.h"
+
+class UInputAction;
+
+/**
+ * Records the value of every input action the pawn binds, frame by frame, and injects it back later.
+ * Both run in simulation mode (@see USimulationSubsystem) so a replay sees the same world as the recording did.
+ * Only changes are stored, a held value is injected every frame until the next change
+ *
+ * ow.Input.Record <Name> [Seed=1], ow.Input.Stop, ow.Input.Replay <Name> [Quit=0]
+ * Recordings live in Saved/InputRecordings/<Name>.owinput
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class OPENWORLD_API UInputReplayComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UInputReplayComponent();
+
+	static constexpr uint32 Magic = 0x4E49574F; // OWIN
+	static constexpr uint32 Version = 2;
+
+	// ===== Recording ========== //
+
+	bool StartRecording(const FString& Name, int32 Seed);
+
+	// ===== Replaying ========== //
+
+	/** @param bInQuitWhenDone Exit once the last frame is replayed, for headless runs */
+	bool StartReplay(const FString& Name, bool bInQuitWhenDone);
+
+	/** Save the recording or abort the replay */
+	void Stop();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	FORCEINLINE bool IsRecording() const
+	{
+		return Mode == EMode::Recording;
+	}
+	FORCEINLINE bool IsReplaying() const
+	{
+		return Mode == EMode::Replaying;
+	}
+
+	static FString GetRecordingPath(const FString& Name);
+
+protected:
+	// ===== Lifecycles ========== //
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	enum class EMode : uint8
+	{
+		None,
+		Recording,
+		Replaying
+	};
+
+	EMode Mode = EMode::None;
+	FString RecordingName;
+
+	int32 Seed = 0;
+	float FixedRate = 30.f;
+
+	/** Sorted by path, the file refers to them by index. Kept loaded by the mapping context */
+	TArray<const UInputAction*> Actions;
+
+	TArray<FInputActionValue> LastValues;
+
+	/** Frames since the start */
+	uint32 Frame = 0;
+
+	bool CollectActions();
+	bool StartSimulation(int32 InSeed, float InFixedRate);
+
+	// ===== Recording ========== //
+
+	/** Frame delta, action index and the value's components, appended as they happen */
+	TArray<uint8> Events;
+	uint32 LastEventFrame = 0;
+
+	void RecordFrame();
+	bool SaveRecording();
+
+	// ===== Replaying ========== //
+
+	struct FReplayEvent
+	{
+		uint32 Frame;
+		uint8 Action;
+		FInputActionValue Value;
+	};
+
+	TArray<FReplayEvent> ReplayEvents;
+	int32 NextEvent = 0;
+	uint32 LastFrame = 0;
+	bool bQuitWhenDone = false;
+
+	double LastFrameTime = 0.0;
+	TArray<float> FrameTimes;
+
+	bool LoadRecording(const FString& Path);
+
+	/** Inject before the controller processes its input, so a frame replays on the frame it was recorded */
+	void SetInjectBeforeInput(bool bBefore);
+	void ReplayFrame();
+	void FinishReplay();
+};
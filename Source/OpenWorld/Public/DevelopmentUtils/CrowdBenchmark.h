@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Enums/Team.h"
+#include "GameFramework/Actor.h"
+#include "CrowdBenchmark.generated.h"
+
+class ACombatCharacter;
+
+/**
+ * Two armies fighting for a fixed simulated duration with a fixed timestep and seed, so runs are comparable.
+ * The OpenWorld.Combat.CrowdBenchmark automation test runs it in its own flat world with a navmesh, headless:
+ * -nullrhi -ExecCmds="Automation RunTests OpenWorld.Combat.CrowdBenchmark; Quit". ow.Combat.CrowdBenchmark runs it
+ * around the player on the loaded map instead, to watch it. Results are appended to Saved/Benchmarks/CrowdBenchmark.csv, with the run total of every OpenWorld stat (@see FOWStatTotal)
+ */
+UCLASS(NotPlaceable, Transient)
+class OPENWORLD_API ACrowdBenchmark : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ACrowdBenchmark();
+
+	/** Spawn both teams around the player (the origin without one) and start measuring, destroys itself when done */
+	void Run(int32 InFriends, int32 InEnemies, float InDuration, int32 InSeed, bool bInQuitWhenDone);
+
+	FORCEINLINE bool IsRunning() const
+	{
+		return bRunning;
+	}
+
+	virtual void Tick(float DeltaTime) override;
+
+protected:
+	// ===== Lifecycles ========== //
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	// ===== Settings ========== //
+
+	int32 Friends = 0;
+	int32 Enemies = 0;
+	float Duration = 0.f;
+	int32 Seed = 0;
+	bool bQuitWhenDone = false;
+
+	/** Simulated seconds per frame, the engine runs as fast as it can */
+	static constexpr float FixedDeltaTime = 1.f / 30.f;
+
+	/** Gap between soldiers, and between the two front lines */
+	static constexpr float Spacing = 200.f;
+	static constexpr float FrontDistance = 2000.f;
+
+	// ===== Spawning ========== //
+
+	TArray<TWeakObjectPtr<ACombatCharacter>> Combatants;
+
+	void SpawnTeam(UClass* CombatantClass, ETeam InTeam, int32 Count, const FVector& Center, float Side);
+
+	// ===== Measuring ========== //
+
+	bool bRunning = false;
+
+	float SimulatedTime = 0.f;
+	double LastFrameTime = 0.0;
+
+	/** Real milliseconds, preallocated for the whole run */
+	TArray<float> FrameTimes;
+	double GameThreadTime = 0.0;
+	double RenderThreadTime = 0.0;
+
+	uint64 StartUsedPhysical = 0;
+
+	void Finish();
+	/** @param UsedMB Since the start, negative when memory was released */
+	void WriteResults(float AverageFrameTime, float P99FrameTime, int32 FriendsAlive, int32 EnemiesAlive, double UsedMB, double PeakUsedMB) const;
+	void Cleanup();
+};
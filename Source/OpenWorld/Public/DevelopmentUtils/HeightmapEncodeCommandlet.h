@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "HeightmapEncodeCommandlet.generated.h"
+
+/**
+ * Encode a .r16 heightmap into the tiled .owh container, then decode it back and check every sample.
+ * Logs the sizes and the encode, full decode and region streaming throughput next to reading the raw R16.
+ *
+ * UnrealEditor-Cmd OpenWorld.uproject -run=HeightmapEncode -Input=WorldGenerator/OpenWorld.r16 [-Output=File.owh] [-TileSize=64] [-MaxError=0] [-Width=0]
+ */
+UCLASS()
+class OPENWORLD_API UHeightmapEncodeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UHeightmapEncodeCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
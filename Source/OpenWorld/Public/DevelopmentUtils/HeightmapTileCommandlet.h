@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "HeightmapTileCommandlet.generated.h"
+
+/**
+ * Slice a .r16 heightmap into equally sized tiles named <Name>_x0_y0.r16, ready for the tiled landscape import
+ * (World Partition). Neighbouring tiles share their border row/column so the landscape stays seamless.
+ *
+ * UnrealEditor-Cmd OpenWorld.uproject -run=HeightmapTile -Input=WorldGenerator/OpenWorld.r16 [-Output=Dir] [-TileSize=505] [-Width=0]
+ */
+UCLASS()
+class OPENWORLD_API UHeightmapTileCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UHeightmapTileCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -6,6 +6,8 @@
 #include "GameFramework/Actor.h"
 #include "HumanoidReference.generated.h"
 
+class UGroundHeightSubsystem;
+
 /**
  * Placing humanoid references along the world 
  */
@@ -45,4 +47,44 @@ private:
 
 	UPROPERTY(EditInstanceOnly, Category=Utility)
 	float Gap;
+
+	/** Grid points per cell side, cells are the unit of regeneration */
+	UPROPERTY(EditInstanceOnly, Category=Utility, meta=(ClampMin=1))
+	int32 CellPoints = 32;
+
+	// ===== Cells ========== //
+
+	struct FReferenceCell
+	{
+		/** Grid parameters and geometry the transforms were traced with */
+		uint32 Signature = 0;
+		bool bTraced = false;
+
+		TArray<FTransform> Transforms;
+	};
+
+	/** Transient, the first generation after loading traces everything */
+	TMap<FIntPoint, FReferenceCell> Cells;
+
+	/**
+	 * Hash every collision component the traces could hit into the cells it covers, from its bounds, transform
+	 * and (for landscape) its heightfield GUID. One pass over the level, no queries
+	 */
+	void HashCellGeometry(const FIntRect& GridCells, TMap<FIntPoint, uint32>& OutGeometry) const;
+
+	/** Hash of what the cell's traces depend on, the cell is only traced again when this changes */
+	uint32 ComputeCellSignature(const FIntRect& Points, uint32 Geometry) const;
+
+	FORCEINLINE int32 ToCell(int32 Point) const
+	{
+		return Point >= 0 ? Point / CellPoints : -((-Point + CellPoints - 1) / CellPoints);
+	}
+
+	/** Trace every point of the cell on worker threads, down to the cached terrain height when there is one */
+	void TraceCell(const FIntRect& Points, UGroundHeightSubsystem* GroundHeights, TArray<FTransform>& OutTransforms) const;
+
+	FORCEINLINE FVector GetPointLocation(int32 X, int32 Y) const
+	{
+		return FVector(GridOrigin.X + X * Gap, GridOrigin.Y + Y * Gap, GridOrigin.Z);
+	}
 };
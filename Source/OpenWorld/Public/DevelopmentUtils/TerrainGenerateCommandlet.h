@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "TerrainGenerateCommandlet.generated.h"
+
+/**
+ * Generate the world terrain natively and write it as .r16, @see FTerrainGenerator
+ *
+ * UnrealEditor-Cmd OpenWorld.uproject -run=TerrainGenerate [-Output=WorldGenerator/OpenWorld_Generated.r16] [-Resolution=1009] [-Seed=1337]
+ *     [-Hydraulic=250] [-Thermal=40] [-SeaLevel=0.08] [-Ridged=0.7] [-Frequency=3] [-HeightRatio=0.1]
+ */
+UCLASS()
+class OPENWORLD_API UTerrainGenerateCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UTerrainGenerateCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,12 @@
+#pragma once
+
+/** Used by the combat audio subsystem for voice limiting */
+enum class ECombatSoundCategory : uint8
+{
+    ECSC_Hit,
+    ECSC_Block,
+    ECSC_Kick,
+    ECSC_Footstep,
+    ECSC_UI, // 2D sounds, such as slow motion
+    ECSC_Max
+};
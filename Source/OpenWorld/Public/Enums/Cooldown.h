@@ -0,0 +1,25 @@
+#pragma once
+
+/** Fixed slots of a UCooldownComponent, every owner gets all of them */
+enum class ECooldown : uint8
+{
+    // Characters
+    EC_RootMotion,
+    EC_Stun,
+    EC_ComboOver,
+    EC_Charge,
+    EC_Ragdoll,
+    EC_Parry,
+
+    // Weapons
+    EC_TempDamage,
+    EC_DisablePhysics,
+
+    // AI
+    EC_Engage,
+    EC_Reaction,
+    EC_Patrolling,
+    EC_Blocking,
+
+    EC_Max
+};
@@ -0,0 +1,11 @@
+#pragma once
+
+/** Every system draws from its own stream, so adding a roll in one doesn't shift the others */
+enum class ERandomStream : uint8
+{
+    ERS_AI,      // Engage decisions, strafing, blocking, patrolling
+    ERS_Combat,  // Damage rolls
+    ERS_Loadout, // Weapons given on spawn
+    ERS_Weather, // Thunder placement and timing
+    ERS_Max
+};
@@ -0,0 +1,12 @@
+#pragma once
+
+/** Every tip the HUD can show, the text and priority of each live in AOWHUD */
+enum class ETipMessage : uint8
+{
+    ETM_None,
+    ETM_PickupWeapon,
+    ETM_Takedown,
+    ETM_DodgeBlock,
+    ETM_Dash, // Charge attacks are unblockable, wins over dodge/block
+    ETM_Max
+};
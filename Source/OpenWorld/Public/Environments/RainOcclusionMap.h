@@ -0,0 +1,95 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class ALandscapeProxy;
+
+/**
+ * Top down height map of whatever blocks the rain (landscape, roofs, canopy) around a moving center.
+ * Texels are stored toroidally by world cell, so when the center crosses a cell only the strip that
+ * entered the window needs to be rebuilt and the GPU side can sample it with wrap addressing
+ */
+class OPENWORLD_API FRainOcclusionMap
+{
+public:
+	// ===== Lifecycles ========== //
+
+	void Initialize(int32 InResolution, float InCellSize);
+
+	/**
+	 * Move the window so it is centered at Center
+	 *
+	 * @return True if the window moved and some texels got dirty
+	 */
+	bool Recenter(const FVector& Center);
+
+	/**
+	 * Rebuild up to MaxTexels dirty texels from landscape height and static geometry bounds
+	 *
+	 * @return True if anything got rebuilt
+	 */
+	bool BuildDirty(UWorld* World, int32 MaxTexels);
+
+	// ===== Queries ========== //
+
+	/** Highest occluder above that XY, or lowest float if it is outside of the window/not built yet */
+	float GetOcclusionHeight(const FVector2D& Location) const;
+
+	/** Something is above that location (with Tolerance to ignore the ground it is standing on) */
+	FORCEINLINE bool IsOccluded(const FVector& Location, float Tolerance = 50.f) const
+	{
+		return GetOcclusionHeight(FVector2D(Location)) > Location.Z + Tolerance;
+	}
+
+	/** Window min XY, world size and cell size, used by the shaders to sample the map */
+	FORCEINLINE FLinearColor GetShaderBounds() const
+	{
+		return FLinearColor(WindowMin.X * CellSize, WindowMin.Y * CellSize, Resolution * CellSize, CellSize);
+	}
+
+	FORCEINLINE const TArray<float>& GetHeights() const
+	{
+		return Heights;
+	}
+	FORCEINLINE int32 GetResolution() const
+	{
+		return Resolution;
+	}
+	FORCEINLINE bool HasDirtyTexels() const
+	{
+		return !DirtyCells.IsEmpty();
+	}
+
+private:
+	int32 Resolution = 0;
+	float CellSize = 0.f;
+
+	/** Current window, in world cells */
+	FIntPoint WindowMin = FIntPoint(MAX_int32, MAX_int32);
+
+	/** Toroidal storage indexed by world cell modulo Resolution */
+	TArray<float> Heights;
+
+	/** World cells waiting for a rebuild */
+	TArray<FIntPoint> DirtyCells;
+
+	TArray<TWeakObjectPtr<ALandscapeProxy>> Landscapes;
+	bool bLandscapesCached = false;
+
+	FORCEINLINE int32 ToIndex(const FIntPoint& Cell) const
+	{
+		const int32 X = ((Cell.X % Resolution) + Resolution) % Resolution;
+		const int32 Y = ((Cell.Y % Resolution) + Resolution) % Resolution;
+
+		return Y * Resolution + X;
+	}
+	FORCEINLINE bool IsInWindow(const FIntPoint& Cell) const
+	{
+		return Cell.X >= WindowMin.X && Cell.Y >= WindowMin.Y && Cell.X < WindowMin.X + Resolution && Cell.Y < WindowMin.Y + Resolution;
+	}
+
+	void MarkDirty(const FIntRect& Cells);
+	float SampleLandscape(const FVector2D& Location) const;
+};
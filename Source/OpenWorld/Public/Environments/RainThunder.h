@@ -3,11 +3,12 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Environments/RainOcclusionMap.h"
 #include "GameFramework/Actor.h"
+#include "Subsystems/GlobalParamSubsystem.h"
 #include "RainThunder.generated.h"
 
 class APostProcessVolume;
-class UMaterialParameterCollectionInstance;
 class UNiagaraComponent;
 class UNiagaraSystem;
 class UTimelineComponent;
@@ -30,6 +31,12 @@ public:
 	void ToggleThunder(bool bEnabled);
 	void ToggleRain(bool bEnabled);
 
+	/** Nothing is blocking the rain above that location (only meaningful while raining) */
+	FORCEINLINE bool IsExposedToRain(const FVector& Location) const
+	{
+		return !OcclusionMap.IsOccluded(Location);
+	}
+
 protected:
 	// ===== Lifecycles ========== //
 
@@ -58,8 +65,12 @@ private:
 	UPROPERTY()
 	TObjectPtr<UMaterialInstanceDynamic> ThunderMaterial;
 
+	/** MP_Global parameters, resolved once @see UGlobalParamSubsystem */
 	UPROPERTY()
-	TWeakObjectPtr<UMaterialParameterCollectionInstance> GlobalMatParamIns;
+	TWeakObjectPtr<UGlobalParamSubsystem> GlobalParams;
+
+	FGlobalParamHandle RainLevelParam;
+	FGlobalParamHandle RainOcclusionBoundsParam;
 
 	void CreateMaterial();
 
@@ -83,6 +94,30 @@ private:
 
 	void UpdateRain(float DeltaTime);
 
+	// *** Occlusion *** //
+
+	/** Texels per side of the occlusion map around the player */
+	UPROPERTY(EditDefaultsOnly, Category=Rain)
+	int32 OcclusionResolution = 64;
+
+	UPROPERTY(EditDefaultsOnly, Category=Rain)
+	float OcclusionCellSize = 200.f;
+
+	/** Rebuild budget, so crossing cells or the first build never costs more than this in a frame */
+	UPROPERTY(EditDefaultsOnly, Category=Rain)
+	int32 OcclusionTexelsPerFrame = 256;
+
+	FRainOcclusionMap OcclusionMap;
+
+	/** GPU copy of the occlusion map, sampled by NS_Rain and the wetness materials */
+	UPROPERTY()
+	TObjectPtr<UTexture2D> OcclusionTexture;
+
+	bool bPlayerCovered = false;
+
+	void UpdateOcclusion();
+	void UploadOcclusionTexture();
+
 	// ===== Thunder ========== //
 
 	/** This mesh will be applied with thunder material */
@@ -113,9 +148,4 @@ private:
 
 	/** Flashing effect just like real life thunder */
 	void Flashing();
-
-public:
-	// ===== Modifiers ========== //
-
-	FORCEINLINE void SetGlobalMatParamIns(UMaterialParameterCollectionInstance* InGlobalParam);
 };
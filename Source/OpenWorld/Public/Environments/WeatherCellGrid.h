@@ -0,0 +1,73 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Weather of a single region, just a few floats so far away cells cost next to nothing */
+struct FWeatherCell
+{
+	/** 0 is clear sky, 1 is storm */
+	float Cloudiness = 0.f;
+
+	/** Derived from cloudiness, 0 is dry */
+	float Rain = 0.f;
+
+	/** Where the cloudiness is heading and for how long */
+	float TargetCloudiness = 0.f;
+	float TargetTimer = 0.f;
+};
+
+/** Whole simulation state, moved in and out of the background step as a single value */
+struct FWeatherSimulationState
+{
+	TArray<FWeatherCell> Cells;
+	FRandomStream Stream;
+};
+
+/**
+ * Coarse grid of weather cells covering the world, centered at the world origin.
+ * The step is pure (state in, state out), so it can run off the game thread
+ */
+class OPENWORLD_API FWeatherCellGrid
+{
+public:
+	// ===== Lifecycles ========== //
+
+	void Initialize(int32 InDimension, float InCellSize, int32 Seed);
+
+	/** Advance a copy of the state, safe to call from any thread */
+	static FWeatherSimulationState Step(FWeatherSimulationState State, int32 Dimension, float DeltaSeconds);
+
+	// ===== Queries ========== //
+
+	/** Bilinear blend of the cell at that location and its neighbours */
+	FWeatherCell Sample(const FVector& Location) const;
+
+	FORCEINLINE const FWeatherSimulationState& GetState() const
+	{
+		return State;
+	}
+	FORCEINLINE void SetState(FWeatherSimulationState&& NewState)
+	{
+		State = MoveTemp(NewState);
+	}
+	FORCEINLINE int32 GetDimension() const
+	{
+		return Dimension;
+	}
+
+private:
+	int32 Dimension = 0;
+	float CellSize = 1.f;
+
+	FWeatherSimulationState State;
+
+	FORCEINLINE const FWeatherCell& GetCell(int32 X, int32 Y) const
+	{
+		X = FMath::Clamp(X, 0, Dimension - 1);
+		Y = FMath::Clamp(Y, 0, Dimension - 1);
+
+		return State.Cells[Y * Dimension + X];
+	}
+};
@@ -7,6 +7,7 @@
 #include "CombatController.generated.h"
 
 class ACombatCharacter;
+class UCooldownComponent;
 
 UCLASS()
 class OPENWORLD_API ACombatController : public AAIController
@@ -39,6 +40,12 @@ private:
 	UPROPERTY()
 	TWeakObjectPtr<ACombatCharacter> CombatCharacter;
 
+	// ***===== Components ==========*** //
+
+	/** Engage, reaction, patrolling and blocking delays */
+	UPROPERTY(VisibleAnywhere)
+	TObjectPtr<UCooldownComponent> Cooldowns;
+
 	// ***===== AI ==========*** //
 
 	// *** Sensing *** //
@@ -48,6 +55,12 @@ private:
 	UFUNCTION()
 	virtual void OnTargetSense(AActor* Actor, FAIStimulus Stimulus);
 
+	/** State and timers of this controller into the CSV profiler, when capturing */
+	void EmitTelemetry() const;
+
+	/** Every decision draws from here, replays the same with a fixed seed @see USimulationSubsystem */
+	FRandomStream& GetAIStream() const;
+
 	// *** Engaging *** //
     // Get the Engaging randomly, but we can adjust the aggresivly
     /**
@@ -60,8 +73,6 @@ private:
 	TArray<int8> EngageChances = { 0, 0, 0, 0, 1, 1, 2, 3 };
 
 	/** Whether decide to strafe or attack */
-	FTimerHandle EngageDelayHandle;
-
 	UPROPERTY(EditAnywhere, Category=AI)
 	float EngageDelayMin = .7f;
 
@@ -70,20 +81,13 @@ private:
 
     void Blocking();
 
-    FORCEINLINE void ReEngage()
-    {
-        GetWorldTimerManager().ClearTimer(EngageDelayHandle);
-		Engage();
-    }
+    void ReEngage();
 
     // *** Reactions *** //
-    FTimerHandle ReactionDelay;
     FORCEINLINE void FinishedReaction();
 
 	// ***===== Patrolling ==========*** //
 
-	FTimerHandle PatrollingDelayHandler;
-	
 	UPROPERTY(EditAnywhere, Category=Patrolling)
 	float PatrollingDelayMin = 2.f;
 
@@ -111,9 +115,5 @@ private:
 	/** Strafing around player when on combat mode */
 	void Strafing();
 
-	// *** Blocking *** //
-	/** Disable blocking after certain time */
-	FTimerHandle BlockingTimerHandle;
-
 	void Engage();
 };
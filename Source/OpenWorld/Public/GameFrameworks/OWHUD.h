@@ -3,23 +3,45 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Enums/TipMessage.h"
 #include "GameFramework/HUD.h"
 #include "OWHUD.generated.h"
 
+class ACombatCharacter;
 class UTipWidget;
 
 UCLASS()
 class OPENWORLD_API AOWHUD : public AHUD
 {
 	GENERATED_BODY()
-	
+
 public:
 	AOWHUD();
 
-	// ===== Interfaces ========== //
+	// ===== Tips ========== //
+
+	/**
+	 * Ask for a tip until the same source hides it (or is destroyed). Only the highest priority tip asked for is visible,
+	 * and the widget is only touched when that changes, so any number of sources may ask for the same tip
+	 */
+	void ShowTip(ETipMessage Tip, const UObject* Source);
+	void HideTip(ETipMessage Tip, const UObject* Source);
+
+	/** Every tip that source asked for */
+	void HideTips(const UObject* Source);
+
+	// ===== Combat Overlay ========== //
 
-	FORCEINLINE void ShowTip(const FString& Text);
-	FORCEINLINE void HideTip();
+	/** Combatants only report changes, the overlay keeps what it needs to draw them */
+	void AddCombatant(ACombatCharacter* Combatant, float HealthRatio);
+	void RemoveCombatant(ACombatCharacter* Combatant);
+	void UpdateHealth(ACombatCharacter* Combatant, float HealthRatio);
+	void SetAttackIndicator(ACombatCharacter* Combatant, bool bVisible);
+
+	/** Spawn Count enemies in front of the camera and log what the overlay costs per frame while they are drawn */
+	void RunOverlayBenchmark(int32 Count, float Duration);
+
+	virtual void DrawHUD() override;
 
 protected:
 	// ===== Lifecycles ========== //
@@ -38,4 +60,81 @@ private:
 	TObjectPtr<UTipWidget> TipWidget;
 
 	void ConstructWidgets();
+
+	// ===== Tips ========== //
+
+	struct FTipRequest
+	{
+		ETipMessage Tip;
+		TWeakObjectPtr<const UObject> Source;
+	};
+
+	TArray<FTipRequest> TipRequests;
+	ETipMessage VisibleTip = ETipMessage::ETM_None;
+
+	void RefreshTip();
+
+	// ===== Combat Overlay ========== //
+
+	/** Only the most relevant ones are drawn: attacking first, then the player's target, then the nearest */
+	UPROPERTY(EditAnywhere, Category=Overlay)
+	int32 MaxOverlayElements = 16;
+
+	UPROPERTY(EditAnywhere, Category=Overlay)
+	float OverlayMaxDistance = 5000.f;
+
+	/** Above the capsule */
+	UPROPERTY(EditAnywhere, Category=Overlay)
+	float OverlayHeightOffset = 30.f;
+
+	UPROPERTY(EditAnywhere, Category=Overlay)
+	FVector2D HealthBarSize = FVector2D(80.f, 6.f);
+
+	UPROPERTY(EditAnywhere, Category=Overlay)
+	FLinearColor EnemyHealthColor = FLinearColor(.9f, .1f, .1f);
+
+	UPROPERTY(EditAnywhere, Category=Overlay)
+	FLinearColor FriendHealthColor = FLinearColor(.548f, .973f, .162f);
+
+	UPROPERTY(EditAnywhere, Category=Overlay)
+	FLinearColor AttackIndicatorColor = FLinearColor(1.f, .25f, 0.f);
+
+	struct FCombatant
+	{
+		float HealthRatio = 1.f;
+		bool bFriend = false;
+		bool bAttackIndicator = false;
+	};
+
+	TMap<TWeakObjectPtr<ACombatCharacter>, FCombatant> Combatants;
+
+	/** Rebuilt every frame, the storage is kept */
+	struct FOverlayElement
+	{
+		FVector2D Position;
+		const FCombatant* Combatant;
+
+		/** Attacking first, then the player's target, then the rest. Nearest first within a group */
+		uint8 Group;
+		double DistanceSquared;
+
+		FORCEINLINE bool operator<(const FOverlayElement& Other) const
+		{
+			return Group != Other.Group ? Group < Other.Group : DistanceSquared < Other.DistanceSquared;
+		}
+	};
+
+	TArray<FOverlayElement> OverlayElements;
+
+	void DrawCombatOverlay();
+
+	// ===== Benchmark ========== //
+
+	TArray<TWeakObjectPtr<AActor>> BenchmarkActors;
+	double BenchmarkEndTime = 0.0;
+	double BenchmarkSeconds = 0.0;
+	int32 BenchmarkFrames = 0;
+	int32 BenchmarkElements = 0;
+
+	void FinishOverlayBenchmark();
 };
@@ -7,6 +7,7 @@
 #include "OWPlayerController.generated.h"
 
 class UInputMappingContext;
+class UInputReplayComponent;
 
 UCLASS()
 class OPENWORLD_API AOWPlayerController : public APlayerController
@@ -32,4 +33,8 @@ private:
 
 	UPROPERTY(EditDefaultsOnly, Category=Input)
 	TSoftObjectPtr<UInputMappingContext> GameInput;
+
+	/** ow.Input.Record / ow.Input.Replay */
+	UPROPERTY(VisibleAnywhere)
+	TObjectPtr<UInputReplayComponent> InputReplay;
 };
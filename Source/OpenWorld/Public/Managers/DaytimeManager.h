@@ -8,6 +8,8 @@
 
 class ADirectionalLight;
 class APostProcessVolume;
+class UDirectionalLightComponent;
+class UTimeOfDaySubsystem;
 
 UCLASS()
 class OPENWORLD_API ADaytimeManager : public AActor
@@ -26,10 +28,22 @@ protected:
 	// ===== Lifecycles ========== //
 
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 private:
 	void ReferencesInitializer();
 
+	// ===== References ========== //
+
+	UPROPERTY()
+	TWeakObjectPtr<UTimeOfDaySubsystem> TimeOfDay;
+
+	UPROPERTY()
+	TWeakObjectPtr<UDirectionalLightComponent> SunLight;
+
+	UPROPERTY()
+	TWeakObjectPtr<UDirectionalLightComponent> MoonLight;
+
 	// ===== Components ========== //
 
 	/** Used as actual sun's rotation to avoid gimble lock */
@@ -47,13 +61,22 @@ private:
 	UPROPERTY(EditInstanceOnly, Category=Lightings)
 	TWeakObjectPtr<ADirectionalLight> Moon;
 
+	/** Orient the sky from the clock, this is only visual and never advances the time */
 	void UpdateTime();
 
+	/** Switch sun/moon, only called when crossing dawn/dusk */
+	void ApplyDayNight(bool bNight);
+
 	// ===== Attributes ========== //
 
+	/** Starting hour, in the editor it is also the previewed hour */
 	UPROPERTY(EditAnywhere, Category=Attributes, meta=(UIMin=0, UIMax=24))
 	float Time = 0.f;
 
+	/** In-game hours per world second (.2 is a 2 minutes day) */
 	UPROPERTY(EditAnywhere, Category=Attributes)
-	float TimeRate = .1f;
+	float HoursPerSecond = .2f;
+
+	/** Only -1 until the first ApplyDayNight */
+	int8 AppliedNight = -1;
 };
@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Tasks/Task.h"
+#include "Terrain/FoliageScatter.h"
+#include "FoliageManager.generated.h"
+
+class UHierarchicalInstancedStaticMeshComponent;
+
+/**
+ * Scatters foliage from rules into hierarchical instanced meshes per world cell.
+ * Cells are either baked into the level from the editor, or generated on worker threads as they come into range
+ */
+UCLASS()
+class OPENWORLD_API AFoliageManager : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AFoliageManager();
+
+	// ===== Generating ========== //
+
+	/**
+	 * Bake every cell over the landscape into the level, those are skipped by the runtime generation.
+	 * Scatters on SourceHeightmap when set, so the bake follows the terrain build rather than what is loaded
+	 */
+	UFUNCTION(CallInEditor, Category=Scatter)
+	void BuildAllCells();
+
+	UFUNCTION(CallInEditor, Category=Scatter)
+	void ClearCells();
+
+protected:
+	// ===== Lifecycles ========== //
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	// ===== Attributes ========== //
+
+	UPROPERTY(EditAnywhere, Category=Scatter)
+	TArray<FScatterRule> Rules;
+
+	UPROPERTY(EditAnywhere, Category=Scatter)
+	float CellSize = 12800.f;
+
+	UPROPERTY(EditAnywhere, Category=Scatter)
+	int32 Seed = 1337;
+
+	/** Resolution of the terrain copy the scatter runs on */
+	UPROPERTY(EditAnywhere, Category=Scatter)
+	float HeightSpacing = 100.f;
+
+	/** .r16 the landscape is imported from (e.g. the TerrainGenerate output), relative to the project */
+	UPROPERTY(EditAnywhere, Category=Scatter, meta=(FilePathFilter="r16"))
+	FFilePath SourceHeightmap;
+
+	/** Where that heightmap is placed, location and scale as in the landscape import */
+	UPROPERTY(EditAnywhere, Category=Scatter)
+	FTransform HeightmapTransform;
+
+	// ===== Baked ========== //
+
+	UPROPERTY()
+	TArray<FIntPoint> BakedCells;
+
+	UPROPERTY()
+	TArray<TObjectPtr<UHierarchicalInstancedStaticMeshComponent>> BakedComponents;
+
+	// ===== Streaming ========== //
+
+	UPROPERTY(EditAnywhere, Category=Streaming)
+	bool bGenerateOnDemand = true;
+
+	/** In cells around the camera */
+	UPROPERTY(EditAnywhere, Category=Streaming)
+	int32 StreamingRadius = 2;
+
+	UPROPERTY(EditAnywhere, Category=Streaming)
+	float StreamingInterval = .5f;
+
+	FTimerHandle StreamingTimerHandle;
+
+	TMap<FIntPoint, TArray<TWeakObjectPtr<UHierarchicalInstancedStaticMeshComponent>>> StreamedCells;
+
+	/** Cells being scattered on the workers */
+	struct FPendingCell
+	{
+		FIntPoint Cell;
+		UE::Tasks::TTask<TArray<TArray<FTransform>>> Task;
+	};
+
+	TArray<FPendingCell> PendingCells;
+
+	void UpdateStreaming();
+
+	// ===== Helpers ========== //
+
+	bool CaptureHeightfield(const FIntPoint& Cell, FScatterHeightfield& OutHeightfield) const;
+
+	/** Cells over Bounds, with the terrain under them */
+	void CaptureFromGround(const FBox& Bounds, TArray<FIntPoint>& OutCells, TArray<FScatterHeightfield>& OutHeightfields) const;
+	bool CaptureFromHeightmap(TArray<FIntPoint>& OutCells, TArray<FScatterHeightfield>& OutHeightfields) const;
+
+	/** One component per rule that got any instance */
+	TArray<UHierarchicalInstancedStaticMeshComponent*> CreateCellComponents(const TArray<TArray<FTransform>>& Transforms);
+};
@@ -0,0 +1,161 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/StreamableManager.h"
+#include "Enums/Team.h"
+#include "GameFramework/Actor.h"
+#include "SpawnManager.generated.h"
+
+class AMeleeWeapon;
+
+/** Everything needed to bring a gameplay actor back */
+USTRUCT()
+struct FSpawnDescriptor
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere)
+	TSoftClassPtr<AActor> Class;
+
+	UPROPERTY(EditAnywhere)
+	FTransform Transform;
+
+	// ===== Combat Characters ========== //
+
+	UPROPERTY(EditAnywhere)
+	ETeam Team = ETeam::T_Enemy;
+
+	/** None picks one of the character's own */
+	UPROPERTY(EditAnywhere)
+	TSoftClassPtr<AMeleeWeapon> Weapon;
+
+	/** 0 or less is full health */
+	UPROPERTY(EditAnywhere)
+	float Health = 0.f;
+};
+
+USTRUCT()
+struct FSpawnCell
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere)
+	TArray<FSpawnDescriptor> Spawns;
+};
+
+/**
+ * Keeps gameplay actors (enemies, friends, loose weapons) as data per world cell and only spawns the cells around the camera.
+ * Spawning is time sliced over several frames, classes are loaded asynchronously, and actors that leave the range are
+ * demoted back to data in whatever cell they walked into, so the actor count stays bounded however big the map gets
+ */
+UCLASS()
+class OPENWORLD_API ASpawnManager : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ASpawnManager();
+
+	// ===== Editor ========== //
+
+	/** Move every combat character and loose weapon placed in the level into the cells */
+	UFUNCTION(CallInEditor, Category=Streaming)
+	void CaptureLevelActors();
+
+	UFUNCTION(CallInEditor, Category=Streaming)
+	void ClearCells();
+
+	// ===== Getters ========== //
+
+	FORCEINLINE int32 GetActiveActorCount() const
+	{
+		return ActiveActors.Num();
+	}
+	FORCEINLINE int32 GetQueuedCount() const
+	{
+		return SpawnQueue.Num();
+	}
+
+protected:
+	// ===== Lifecycles ========== //
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	// ===== Cells ========== //
+
+	UPROPERTY(EditAnywhere, Category=Streaming)
+	float CellSize = 10000.f;
+
+	UPROPERTY(VisibleAnywhere, Category=Streaming)
+	TMap<FIntPoint, FSpawnCell> Cells;
+
+	FORCEINLINE FIntPoint ToCell(const FVector& Location) const
+	{
+		return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+	}
+
+	// ===== Streaming ========== //
+
+	/** In cells around the camera, actors are demoted one cell further out so walking along a border doesn't thrash */
+	UPROPERTY(EditAnywhere, Category=Streaming)
+	int32 StreamingRadius = 1;
+
+	UPROPERTY(EditAnywhere, Category=Streaming)
+	float StreamingInterval = .1f;
+
+	/** Spawning stops for this update once it took that long */
+	UPROPERTY(EditAnywhere, Category=Streaming)
+	float SpawnBudgetMs = 2.f;
+
+	FTimerHandle StreamingTimerHandle;
+
+	TSet<FIntPoint> ActiveCells;
+
+	struct FQueuedSpawn
+	{
+		FIntPoint Cell;
+		FSpawnDescriptor Descriptor;
+	};
+
+	/** Nearest cells first */
+	TArray<FQueuedSpawn> SpawnQueue;
+
+	TArray<TWeakObjectPtr<AActor>> ActiveActors;
+
+	/** Loads are retried this many times before a class is considered gone */
+	static constexpr int32 MaxClassLoadAttempts = 3;
+
+	/** Holding the handle keeps the class loaded while none of its actors are alive */
+	struct FClassLoad
+	{
+		TSharedPtr<FStreamableHandle> Handle;
+		int32 Attempts = 0;
+	};
+
+	/** Classes requested so far. Spawns waiting on them stay queued */
+	TMap<FSoftObjectPath, FClassLoad> ClassLoads;
+
+	void UpdateStreaming();
+
+	void ActivateCells(const FIntPoint& Center);
+	void DeactivateCells(const FIntPoint& Center);
+	void ProcessSpawnQueue();
+
+	/** False if its classes aren't loaded yet */
+	bool Spawn(const FSpawnDescriptor& Descriptor);
+
+	/** Back to data in the cell it stands in (dead ones are dropped), then destroyed along with its weapon */
+	void Demote(AActor* Actor, bool bKeep);
+
+	/** True once the class can be used (or failed to load every attempt), starts loading it otherwise */
+	bool RequestClass(const FSoftObjectPath& Path);
+
+	FORCEINLINE bool IsInRange(const FIntPoint& Cell, const FIntPoint& Center, int32 Radius) const
+	{
+		return FMath::Max(FMath::Abs(Cell.X - Center.X), FMath::Abs(Cell.Y - Center.Y)) <= Radius;
+	}
+};
@@ -3,7 +3,10 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Environments/WeatherCellGrid.h"
 #include "GameFramework/Actor.h"
+#include "Subsystems/GlobalParamSubsystem.h"
+#include "Tasks/Task.h"
 #include "WeatherManager.generated.h"
 
 class APostProcessVolume;
@@ -11,8 +14,6 @@ class ARain;
 class ASkyAtmosphere;
 class ARainThunder;
 class AVolumetricCloud;
-class UMaterialParameterCollection;
-class UMaterialParameterCollectionInstance;
 
 UCLASS()
 class OPENWORLD_API AWeatherManager : public AActor
@@ -26,10 +27,24 @@ public:
 
 	virtual void Tick(float DeltaTime) override;
 
+	// ===== Lightings ========== //
+
+	/** Log how many render updates the last lighting transition took */
+	void DumpTransitionStats() const;
+
+	// ===== Weather Cells ========== //
+
+	/** Blended weather of the cells around that location */
+	FORCEINLINE FWeatherCell GetWeatherAt(const FVector& Location) const
+	{
+		return WeatherGrid.Sample(Location);
+	}
+
 protected:
 	// ===== Lifecycles ========== //
 
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 private:
 	void DefaultInitializer();
@@ -40,11 +55,8 @@ private:
 	UPROPERTY()
 	TWeakObjectPtr<APawn> PlayerPawn;
 
-	UPROPERTY(VisibleInstanceOnly, Category=Materials)
-	TSoftObjectPtr<UMaterialParameterCollection> GlobalMatParam;
-
 	UPROPERTY()
-	TWeakObjectPtr<UMaterialParameterCollectionInstance> GlobalMatParamIns;
+	TWeakObjectPtr<UGlobalParamSubsystem> GlobalParams;
 
 	// ===== Lightings ========== //
 
@@ -60,6 +72,10 @@ private:
 	UPROPERTY(VisibleInstanceOnly, Category=Materials)
 	TObjectPtr<UMaterialInstanceDynamic> CloudMaterial;
 
+	/** Cloud material scalars, written by index @see UGlobalParamSubsystem */
+	FGlobalParamHandle CloudDensityParam;
+	FGlobalParamHandle CloudIntensityParam;
+
 	/** Make changing lightings to be smooth */
 	bool bChangingLighting = false;
 
@@ -71,12 +87,56 @@ private:
 	float TargetCloudDensity = 1.f;
 	float TargetCloudIntensity = -1.f;
 
+	/** How many times per second a transition is evaluated, the interpolation itself is rate independent */
+	UPROPERTY(EditAnywhere, Category=Lightings)
+	float LightingUpdateRate = 10.f;
+
+	/** Smallest visible change per channel, anything smaller is not pushed to the render side */
+	UPROPERTY(EditAnywhere, Category=Lightings)
+	float AtmosphereQuantization = 1.f / 255.f;
+
+	UPROPERTY(EditAnywhere, Category=Lightings)
+	float CloudDensityQuantization = .01f;
+
+	UPROPERTY(EditAnywhere, Category=Lightings)
+	float CloudIntensityQuantization = .02f;
+
+	/** What the sky atmosphere currently has */
+	FLinearColor PushedAtmosphereColor = CurrentAtmosphereColor;
+
+	/** Cost of the current/last transition */
+	struct FTransitionStats
+	{
+		uint64 StartFrame = 0;
+		float  StartTime = 0.f;
+		float  Duration = 0.f;
+		int32  Frames = 0;
+		int32  Evaluations = 0;
+		int32  RenderUpdates = 0;
+
+		/** Pushes an unthrottled update would have done: every value that changed, on every frame */
+		int32  UnthrottledUpdates = 0;
+		int32  SkippedByQuantization = 0;
+		int32  SkippedByInterval = 0;
+
+		/** Values at the last evaluation, to tell what changed since */
+		uint64       EvaluatedFrame = 0;
+		float        EvaluatedCloudDensity = 0.f;
+		float        EvaluatedCloudIntensity = 0.f;
+		FLinearColor EvaluatedAtmosphereColor;
+	};
+
+	FTransitionStats TransitionStats;
+
 	/** Make changing lightings to be smooth */
 	void ChangeLightingValues(float DeltaTime);
 
 	/** Call this to change the lighting values */
 	void SetLightingValues(const FLinearColor& AtmosphereColor, float CloudDensity, float CloudIntensity);
 
+	/** Push everything that changed visibly, bForce pushes the exact values (end of the transition) */
+	void ApplyLightingValues(bool bForce);
+
 	/** Function helper to interpolate linear color constantly */
 	FORCEINLINE FLinearColor InterpLinearColor(float DeltaTime, float InterpSpeed);
 
@@ -87,4 +147,46 @@ private:
 	TObjectPtr<ARainThunder> RainThunder;
 
 	void PrepareEnvironments();
+
+	// ===== Weather Cells ========== //
+
+	/** Cells per side, the grid is centered at the world origin */
+	UPROPERTY(EditAnywhere, Category=Weather)
+	int32 WeatherGridDimension = 32;
+
+	UPROPERTY(EditAnywhere, Category=Weather)
+	float WeatherCellSize = 50000.f;
+
+	/** Same seed, same weather: the grid steps once per interval however late the background task finishes */
+	UPROPERTY(EditAnywhere, Category=Weather)
+	int32 WeatherSeed = 1337;
+
+	/** How often the whole grid is stepped in the background */
+	UPROPERTY(EditAnywhere, Category=Weather)
+	float SimulationInterval = 2.f;
+
+	/** How often the cells around the player are blended into the lighting */
+	UPROPERTY(EditAnywhere, Category=Weather)
+	float LocalWeatherInterval = .5f;
+
+	FWeatherCellGrid WeatherGrid;
+
+	UE::Tasks::TTask<FWeatherSimulationState> SimulationTask;
+
+	/** Intervals that passed while the last step was still running, all of them go into the next launch */
+	int32 PendingSimulationSteps = 0;
+
+	FTimerHandle SimulationTimerHandle;
+	FTimerHandle LocalWeatherTimerHandle;
+
+	/** Last blended values pushed to the lighting/rain */
+	float AppliedCloudiness = -1.f;
+	bool bLocalRaining = false;
+	bool bLocalThunder = false;
+
+	/** Collect the last background step and launch the next one, with every interval it missed */
+	void SimulateWeather();
+
+	/** Blend the player's cell and its neighbours into rendering parameters */
+	void UpdateLocalWeather();
 };
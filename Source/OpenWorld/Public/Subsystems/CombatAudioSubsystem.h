@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Enums/CombatSoundCategory.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatAudioSubsystem.generated.h"
+
+class UAudioComponent;
+class USoundBase;
+
+/**
+ * Collects combat sound requests during the frame, collapses duplicates and applies
+ * voice limits/distance culling before anything reaches the audio engine
+ */
+UCLASS()
+class OPENWORLD_API UCombatAudioSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// ===== Lifecycles ========== //
+
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// ===== Interfaces ========== //
+
+	void PlaySoundAtLocation(USoundBase* Sound, ECombatSoundCategory Category, const FVector& Location, float VolumeMultiplier = 1.f, float PitchMultiplier = 1.f);
+	void PlaySound2D(USoundBase* Sound, ECombatSoundCategory Category = ECombatSoundCategory::ECSC_UI);
+
+	// ===== Stats ========== //
+
+	struct FAudioStats
+	{
+		int32 Requested = 0;
+		int32 Collapsed = 0;
+		int32 Culled    = 0;
+		int32 Limited   = 0;
+		int32 Played    = 0;
+	};
+
+	FORCEINLINE const FAudioStats& GetStats() const
+	{
+		return Stats;
+	}
+
+	void ResetStats();
+	void DumpStats() const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	// ===== Requests ========== //
+
+	struct FSoundRequest
+	{
+		TWeakObjectPtr<USoundBase> Sound;
+		ECombatSoundCategory Category;
+		FVector Location;
+		float VolumeMultiplier;
+		float PitchMultiplier;
+		bool  b2D;
+	};
+
+	TArray<FSoundRequest> PendingRequests;
+
+	void QueueRequest(const FSoundRequest& Request);
+	bool IsAudible(const FSoundRequest& Request, const FVector& ListenerLocation) const;
+
+	// ===== Pool ========== //
+
+	UPROPERTY()
+	TArray<TObjectPtr<UAudioComponent>> Pool;
+
+	/** Which category each pooled component is currently playing */
+	TArray<ECombatSoundCategory> PoolCategories;
+
+	UAudioComponent* AcquireComponent(ECombatSoundCategory Category);
+	int32 CountActiveVoices(ECombatSoundCategory Category) const;
+
+	// ===== Stats ========== //
+
+	FAudioStats Stats;
+};
@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Enums/Cooldown.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CooldownSubsystem.generated.h"
+
+class UCooldownComponent;
+
+/**
+ * Expiry times of every UCooldownComponent in one flat array (a fixed stride of slots per component) plus a bit mask
+ * of the active ones, so a frame costs one pass over the masks instead of the timer manager's heap churning
+ * for every restart
+ */
+UCLASS()
+class OPENWORLD_API UCooldownSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// ===== Lifecycles ========== //
+
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// ===== Owners ========== //
+
+	int32 Register(UCooldownComponent* Component);
+	void Unregister(int32 Handle);
+
+	// ===== Cooldowns ========== //
+
+	void Start(int32 Handle, ECooldown Cooldown, float Duration);
+	void Stop(int32 Handle, ECooldown Cooldown);
+	void StopAll(int32 Handle);
+
+	FORCEINLINE bool IsActive(int32 Handle, ECooldown Cooldown) const
+	{
+		return (ActiveMasks[Handle] & GetBit(Cooldown)) != 0;
+	}
+	float GetRemaining(int32 Handle, ECooldown Cooldown) const;
+	FORCEINLINE int32 GetActiveCount(int32 Handle) const
+	{
+		return FMath::CountBits(ActiveMasks[Handle]);
+	}
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	static constexpr int32 Stride = (int32)ECooldown::EC_Max;
+	static_assert(Stride <= 16, "Active cooldowns are kept in a 16 bit mask");
+
+	/** World seconds, Stride per owner */
+	TArray<double> ExpireTimes;
+	TArray<uint16> ActiveMasks;
+
+	UPROPERTY()
+	TArray<TObjectPtr<UCooldownComponent>> Owners;
+
+	TArray<int32> FreeHandles;
+
+	static FORCEINLINE uint16 GetBit(ECooldown Cooldown)
+	{
+		return 1 << (uint8)Cooldown;
+	}
+};
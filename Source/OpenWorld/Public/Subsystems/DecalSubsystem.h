@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DecalSubsystem.generated.h"
+
+class UDecalComponent;
+
+/**
+ * Owns a fixed pool of recycled decal components so gameplay code (blood splatters, etc)
+ * can request decals without creating a new component for every request
+ */
+UCLASS()
+class OPENWORLD_API UDecalSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// ===== Lifecycles ========== //
+
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// ===== Interfaces ========== //
+
+	/**
+	 * Request a decal, it may be merged into a nearby one, culled by distance or dropped by the per frame cap
+	 *
+	 * @return True if the request ended up visible (either spawned or merged)
+	 */
+	bool SpawnDecal(UMaterialInterface* Material, const FVector& Size, const FVector& Location, const FRotator& Rotation, float LifeSpan);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	// ===== Pool ========== //
+
+	/** Recycled components, indexed by slot */
+	UPROPERTY()
+	TArray<TObjectPtr<UDecalComponent>> Pool;
+
+	/** Per slot data, kept apart from the components so the merge search only touches plain floats */
+	struct FDecalSlot
+	{
+		FVector Location   = FVector::ZeroVector;
+		float   SpawnTime  = 0.f;
+		float   ExpireTime = 0.f;
+		float   Scale      = 1.f;
+		bool    bActive    = false;
+	};
+
+	TArray<FDecalSlot> Slots;
+
+	/** Released slots, reused before the pool grows or an active decal gets recycled */
+	TArray<int32> FreeSlots;
+	int32 ActiveCount = 0;
+
+	UDecalComponent* AcquireSlot(int32& OutSlot);
+	UDecalComponent* CreateDecal();
+	void ReleaseSlot(int32 Slot);
+
+	/** Try to fold a new splatter into an active one nearby instead of spawning another */
+	bool TryMerge(UMaterialInterface* Material, const FVector& Location);
+
+	// ===== Budget ========== //
+
+	uint64 LastSpawnFrame = 0;
+	int32  SpawnedThisFrame = 0;
+
+	bool IsInCullDistance(const FVector& Location) const;
+};
@@ -0,0 +1,109 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GlobalParamSubsystem.generated.h"
+
+class UMaterialInstanceDynamic;
+class UMaterialParameterCollection;
+class UMaterialParameterCollectionInstance;
+
+/** Pre-resolved parameter, cheap to copy and compare */
+struct FGlobalParamHandle
+{
+	int32 Index = INDEX_NONE;
+
+	FORCEINLINE bool IsValid() const
+	{
+		return Index != INDEX_NONE;
+	}
+};
+
+/**
+ * Owner of MP_Global (and any dynamic material parameter that is written every frame).
+ * Writers resolve their parameters once, writes smaller than the parameter's threshold are skipped
+ * and whatever changed is pushed once at the end of the frame
+ *
+ * Only dynamic material parameters are written by index. UMaterialParameterCollectionInstance keeps its overrides
+ * in a map keyed by name and has no indexed setter, so MP_Global writes still look the name up once per flushed change
+ */
+UCLASS()
+class OPENWORLD_API UGlobalParamSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// ===== Lifecycles ========== //
+
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// ===== Resolving ========== //
+
+	/** @param Threshold Writes that change the value by less than this are skipped */
+	FGlobalParamHandle ResolveScalar(FName Name, float Threshold = .001f);
+	FGlobalParamHandle ResolveVector(FName Name, float Threshold = .001f);
+
+	/** Scalar of a dynamic material, written through its parameter index instead of its name */
+	FGlobalParamHandle ResolveMaterialScalar(UMaterialInstanceDynamic* Material, FName Name, float InitialValue, float Threshold = .001f);
+
+	// ===== Writing ========== //
+
+	/**
+	 * @param bForce Push it even if the change is under the threshold (e.g. the last step of a transition)
+	 * @return True if the write is going to reach the render side on the next flush
+	 */
+	bool SetScalar(FGlobalParamHandle Handle, float Value, bool bForce = false);
+	bool SetVector(FGlobalParamHandle Handle, const FLinearColor& Value, bool bForce = false);
+
+	/** Push every pending write now, normally done once per frame */
+	void Flush();
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	// ===== References ========== //
+
+	UPROPERTY()
+	TObjectPtr<UMaterialParameterCollection> GlobalMatParam;
+
+	UPROPERTY()
+	TWeakObjectPtr<UMaterialParameterCollectionInstance> GlobalMatParamIns;
+
+	UMaterialParameterCollectionInstance* GetGlobalMatParamIns();
+
+	// ===== Parameters ========== //
+
+	enum class EParamType : uint8
+	{
+		Scalar,
+		Vector,
+		MaterialScalar
+	};
+
+	struct FParamEntry
+	{
+		FName Name;
+		EParamType Type;
+		float Threshold;
+
+		/** Only for MaterialScalar */
+		TWeakObjectPtr<UMaterialInstanceDynamic> Material;
+		int32 MaterialIndex = INDEX_NONE;
+
+		/** Scalars only use R */
+		FLinearColor Flushed = FLinearColor::Black;
+		FLinearColor Pending = FLinearColor::Black;
+		bool bDirty = false;
+	};
+
+	TArray<FParamEntry> Params;
+	TArray<int32> DirtyParams;
+
+	int32 FindParam(FName Name, EParamType Type, const UMaterialInstanceDynamic* Material = nullptr) const;
+	bool Write(FGlobalParamHandle Handle, const FLinearColor& Value, bool bForce);
+};
@@ -0,0 +1,154 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/List.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Terrain/HeightfieldQuadtree.h"
+#include "GroundHeightSubsystem.generated.h"
+
+class ALandscapeProxy;
+
+/** Terrain under a point */
+struct FGroundSample
+{
+	float   Height = 0.f;
+	FVector Normal = FVector::UpVector;
+
+	/** Degrees from flat */
+	float Slope = 0.f;
+
+	bool bValid = false;
+};
+
+/**
+ * Answers ground height, normal and slope anywhere on the landscape without touching physics.
+ * The landscape is copied into small height tiles on first use, tiles are dropped least recently used first,
+ * so only the areas that are actually queried stay in memory
+ */
+UCLASS()
+class OPENWORLD_API UGroundHeightSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// ===== Lifecycles ========== //
+
+	virtual void Deinitialize() override;
+
+	// ===== Queries ========== //
+
+	/** @return False if there is no landscape at that location */
+	bool GetGround(const FVector2D& Location, FGroundSample& OutSample);
+	bool GetGroundHeight(const FVector2D& Location, float& OutHeight);
+
+	/**
+	 * Same as calling GetGround for each location, but consecutive locations in the same tile skip the tile lookup
+	 *
+	 * @return How many locations had landscape under them
+	 */
+	int32 GetGroundBatch(TConstArrayView<FVector2D> Locations, TArrayView<FGroundSample> OutSamples);
+
+	/**
+	 * For when non terrain geometry matters (rocks, roofs, bridges): one trace, started from the cached terrain
+	 * height so it's short, and falling back to the terrain if nothing else is hit
+	 *
+	 * @param MaxAbove How high above the terrain something may stand
+	 */
+	bool TraceGround(const FVector2D& Location, FGroundSample& OutSample, ECollisionChannel Channel = ECC_Visibility, float MaxAbove = 10000.f);
+
+	// ===== Ray Casts ========== //
+
+	/**
+	 * Segment against the terrain alone, no physics. Goes through a min/max height pyramid of every loaded landscape,
+	 * built on first use, so line of sight and occlusion checks only look at the few quads the segment gets close to
+	 */
+	bool RayCastTerrain(const FVector& Start, const FVector& End, FHeightfieldHit& OutHit);
+
+	/** Stops at the first crossing, cheaper than RayCastTerrain when where doesn't matter */
+	bool IsTerrainVisible(const FVector& From, const FVector& To);
+
+	/** Compare terrain ray casts against line traces, logs the timings */
+	void RunRayBenchmark(int32 Count, float MaxLength);
+
+	// ===== Cache ========== //
+
+	/** Build every tile overlapping the area now, so later queries in there don't pay for it */
+	void Precache(const FBox2D& Area);
+
+	/** Drop the tiles overlapping the area (everything if it's not valid), e.g. after the landscape got sculpted or streamed in. The ray cast pyramid is always rebuilt */
+	void Invalidate(const FBox2D& Area = FBox2D(ForceInit));
+
+	/** Union of every landscape, in world space */
+	FBox GetLandscapeBounds();
+
+	/** Compare cached queries against line traces, logs the timings */
+	void RunBenchmark(int32 Count);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	// ===== Landscapes ========== //
+
+	TArray<TWeakObjectPtr<ALandscapeProxy>> Landscapes;
+
+	/** The landscape grid, so samples land on landscape vertices */
+	FVector2D GridOrigin = FVector2D::ZeroVector;
+	float SampleSpacing = 100.f;
+
+	double LandscapesCachedTime = -1.0;
+
+	void CacheLandscapes();
+
+	// ===== Tiles ========== //
+
+	/** Quads per tile side, a tile stores one more sample per side so bilinear never leaves it */
+	static constexpr int32 TileQuads = 64;
+	static constexpr int32 TileSamples = TileQuads + 1;
+
+	/** Tile coords, most recently used first */
+	using FTileUseList = TDoubleLinkedList<FIntPoint>;
+
+	struct FGroundTile
+	{
+		TArray<float> Heights;
+		FTileUseList::TDoubleLinkedListNode* UseNode = nullptr;
+		uint64 LastUsedFrame = 0;
+		double BuiltTime = 0.0;
+
+		/** Some samples had no landscape yet (streamed out), rebuilt after a while */
+		bool bIncomplete = false;
+	};
+
+	TMap<FIntPoint, FGroundTile> Tiles;
+	FTileUseList TileUseList;
+
+	const FGroundTile* FindOrBuildTile(const FIntPoint& TileCoord);
+	void BuildTile(const FIntPoint& TileCoord, FGroundTile& Tile);
+
+	/** Move to the front of the use list, once per frame */
+	void TouchTile(FGroundTile& Tile);
+	void RemoveTile(FIntPoint TileCoord);
+	void ResetTiles();
+	void EvictTiles();
+
+	bool Sample(const FGroundTile& Tile, const FVector2D& TileSpace, FGroundSample& OutSample) const;
+
+	FORCEINLINE FVector2D ToGrid(const FVector2D& Location) const
+	{
+		return (Location - GridOrigin) / SampleSpacing;
+	}
+	FORCEINLINE FIntPoint ToTileCoord(const FVector2D& Grid) const
+	{
+		return FIntPoint(FMath::FloorToInt32(Grid.X / TileQuads), FMath::FloorToInt32(Grid.Y / TileQuads));
+	}
+
+	// ===== Ray Casts ========== //
+
+	/** Whole landscape at vertex resolution, read from the collision heightfields so the tiles are left alone */
+	FHeightfieldQuadtree Quadtree;
+
+	void BuildQuadtree();
+};
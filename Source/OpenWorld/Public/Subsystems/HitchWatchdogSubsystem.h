@@ -0,0 +1,104 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HitchWatchdogSubsystem.generated.h"
+
+struct FEndLoadPackageContext;
+
+/**
+ * Watches the game thread for synchronous loads and long frames, and keeps the last ones in a ring buffer
+ * with their duration and call stack. The stacks are only symbolicated when reporting, ow.Watchdog.Dump
+ * or when the world is torn down, so watching costs next to nothing
+ */
+UCLASS()
+class OPENWORLD_API UHitchWatchdogSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// ===== Lifecycles ========== //
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual bool IsTickableWhenPaused() const override
+	{
+		return true;
+	}
+
+	// ===== Reporting ========== //
+
+	/** Log every record and write them to Saved/Logs/HitchReport.txt */
+	void DumpReport();
+	void ClearRecords();
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	enum class EHitchType : uint8
+	{
+		SyncLoad,
+		LongFrame
+	};
+
+	static constexpr int32 MaxStackDepth = 24;
+
+	struct FHitchRecord
+	{
+		EHitchType Type = EHitchType::SyncLoad;
+
+		/** Package for sync loads */
+		FName Name;
+
+		uint64 Frame = 0;
+		double StartTime = 0.0;
+		float DurationMs = 0.f;
+
+		/** Sync loads that haven't reported their end are measured up to the end of the frame */
+		bool bFinished = false;
+
+		/** Sync loads during a long frame */
+		int32 SyncLoads = 0;
+
+		uint64 BackTrace[MaxStackDepth];
+		uint32 StackDepth = 0;
+	};
+
+	/** Oldest records are overwritten */
+	TArray<FHitchRecord> Records;
+	int32 NextRecord = 0;
+	int32 RecordCount = 0;
+
+	/** Sync load waiting for its end */
+	struct FPendingLoad
+	{
+		FName Package;
+
+		/** Index into Records */
+		int32 Record = INDEX_NONE;
+	};
+
+	/**
+	 * By request, so overlapping loads of the same package are each measured.
+	 * The sync load delegate carries no request id, ours are handed out in OnSyncLoadPackage
+	 */
+	TMap<uint32, FPendingLoad> PendingLoads;
+	uint32 NextRequestId = 0;
+
+	double LastFrameTime = 0.0;
+	int32 FrameSyncLoads = 0;
+
+	FDelegateHandle SyncLoadHandle;
+	FDelegateHandle EndLoadHandle;
+
+	FHitchRecord& AddRecord(EHitchType Type);
+
+	void OnSyncLoadPackage(const FString& PackageName);
+	void OnEndLoadPackage(const FEndLoadPackageContext& Context);
+};
@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Enums/RandomStream.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SimulationSubsystem.generated.h"
+
+/**
+ * Owns the random streams gameplay draws from. Normally they're seeded from the clock, in simulation mode
+ * they're seeded from a fixed seed and the engine runs a fixed timestep, so a benchmark or a repro plays out the same every run.
+ * Start it with -OWSeed=<Seed> [-OWFixedRate=<Hz>] or ow.Simulation.Start
+ */
+UCLASS()
+class OPENWORLD_API USimulationSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// ===== Lifecycles ========== //
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// ===== Simulation ========== //
+
+	/** Reseed every stream and fix the timestep, the previous timestep is restored by StopSimulation */
+	void StartSimulation(int32 InSeed, float FixedRate = 30.f);
+	void StopSimulation();
+
+	FORCEINLINE bool IsSimulating() const
+	{
+		return bSimulating;
+	}
+	FORCEINLINE int32 GetSeed() const
+	{
+		return Seed;
+	}
+
+	// ===== Random ========== //
+
+	FORCEINLINE FRandomStream& GetStream(ERandomStream Stream)
+	{
+		return Streams[(uint8)Stream];
+	}
+
+	/** Stream of the world that object is in, callers don't need to care whether the subsystem exists */
+	static FRandomStream& GetStream(const UObject* WorldContextObject, ERandomStream Stream);
+
+private:
+	int32 Seed = 0;
+	bool bSimulating = false;
+
+	bool bPreviousUseFixedTimeStep = false;
+	double PreviousFixedDeltaTime = 0.0;
+
+	FRandomStream Streams[(uint8)ERandomStream::ERS_Max];
+
+	void SeedStreams(int32 InSeed);
+};
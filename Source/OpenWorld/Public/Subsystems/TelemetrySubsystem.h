@@ -0,0 +1,26 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TelemetrySubsystem.generated.h"
+
+/**
+ * Samples the populations nobody ticks for (live Niagara systems, ragdolls, dropped weapons) into the CSV profiler
+ * once per frame. Events and ticking populations are emitted by their own classes. Does nothing unless a capture is running
+ */
+UCLASS()
+class OPENWORLD_API UTelemetrySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// ===== Lifecycles ========== //
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+};
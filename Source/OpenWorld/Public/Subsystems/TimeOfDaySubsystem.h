@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TimeOfDaySubsystem.generated.h"
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnDayNightChanged, bool /* bNight */);
+
+/**
+ * Single clock of the world, derived from world time so day length never depends on tick rate or hitches.
+ * Anyone can query the time without ticking their own clock
+ */
+UCLASS()
+class OPENWORLD_API UTimeOfDaySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// ===== Lifecycles ========== //
+
+	virtual void Deinitialize() override;
+
+	// ===== Clock ========== //
+
+	/**
+	 * Restart the clock from that time
+	 *
+	 * @param InTime Hour of the day [0, 24)
+	 * @param InHoursPerSecond How many in-game hours pass every (dilated) world second
+	 */
+	void SetClock(float InTime, float InHoursPerSecond);
+
+	/** Current hour of the day [0, 24) */
+	float GetTime() const;
+
+	FORCEINLINE bool IsNight() const
+	{
+		return bNight;
+	}
+	FORCEINLINE float GetHoursPerSecond() const
+	{
+		return HoursPerSecond;
+	}
+
+	/** Broadcast only when crossing dawn/dusk, never every update */
+	FOnDayNightChanged OnDayNightChanged;
+
+	// ===== Orientation ========== //
+
+	static constexpr float Dawn = 5.5f;
+	static constexpr float Dusk = 17.5f;
+
+	static FORCEINLINE bool IsNightTime(float InTime)
+	{
+		return InTime < Dawn || InTime > Dusk;
+	}
+
+	/** Roll of the sky pivot at that time, the moon is placed opposite to the sun */
+	static float GetSkyAngle(float InTime);
+
+	/** Rotation of the sun light at that time, Yaw is the heading of the sky pivot */
+	static FRotator GetSunRotation(float InTime, float Yaw = 0.f);
+
+private:
+	float StartTime = 0.f;
+	float StartWorldTime = 0.f;
+	float HoursPerSecond = 0.f;
+	bool  bNight = false;
+
+	/** The crossings are known ahead of time, so a single timer replaces polling */
+	FTimerHandle CrossingTimerHandle;
+
+	void ScheduleNextCrossing();
+	void OnCrossing();
+};
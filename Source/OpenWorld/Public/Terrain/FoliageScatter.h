@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GroundHeightSubsystem.h"
+#include "FoliageScatter.generated.h"
+
+class FHeightmapR16;
+class UStaticMesh;
+
+/** What to scatter and where it is allowed to grow */
+USTRUCT()
+struct FScatterRule
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere)
+	TObjectPtr<UStaticMesh> Mesh;
+
+	/** Instances per 10x10 meters */
+	UPROPERTY(EditAnywhere, meta=(ClampMin=0))
+	float Density = 1.f;
+
+	UPROPERTY(EditAnywhere)
+	float MinHeight = -100000.f;
+
+	UPROPERTY(EditAnywhere)
+	float MaxHeight = 100000.f;
+
+	/** Degrees */
+	UPROPERTY(EditAnywhere, meta=(ClampMin=0, ClampMax=90))
+	float MinSlope = 0.f;
+
+	UPROPERTY(EditAnywhere, meta=(ClampMin=0, ClampMax=90))
+	float MaxSlope = 30.f;
+
+	UPROPERTY(EditAnywhere)
+	FVector2D ScaleRange = FVector2D(.8f, 1.2f);
+
+	/** Sink it a bit so it doesn't float on slopes */
+	UPROPERTY(EditAnywhere)
+	float ZOffset = 0.f;
+
+	/** Rocks follow the ground, trees grow straight up */
+	UPROPERTY(EditAnywhere)
+	bool bAlignToNormal = false;
+
+	UPROPERTY(EditAnywhere)
+	bool bCollision = true;
+
+	UPROPERTY(EditAnywhere)
+	float CullDistance = 20000.f;
+};
+
+/** Small copy of the terrain under an area, so the scatter can run on any thread */
+struct OPENWORLD_API FScatterHeightfield
+{
+	FVector2D Origin = FVector2D::ZeroVector;
+	float Spacing = 100.f;
+	FIntPoint Size = FIntPoint::ZeroValue;
+
+	/** Size.X * Size.Y samples, lowest float where there is no ground */
+	TArray<float> Heights;
+
+	/** From the ground height cache, game thread only */
+	void CaptureGround(UGroundHeightSubsystem& GroundHeights, const FBox2D& Area, float InSpacing);
+
+	/** Straight from a heightmap file, usable without a world (e.g. at cook time). The landscape must not be rotated */
+	void CaptureHeightmap(const FHeightmapR16& Heightmap, const FTransform& LandscapeTransform, const FBox2D& Area, float InSpacing);
+
+	bool Sample(const FVector2D& Location, FGroundSample& OutSample) const;
+
+	/** Anything to grow on */
+	bool HasGround() const;
+};
+
+/**
+ * Deterministic foliage scatter: every (cell, rule) gets its own random stream seeded from the world seed,
+ * so a cell always comes out the same no matter when, where or in which order it is generated
+ */
+class OPENWORLD_API FFoliageScatter
+{
+public:
+	/** @return Instance transforms (world space) per rule */
+	static TArray<TArray<FTransform>> ScatterCell(const FScatterHeightfield& Heightfield, TConstArrayView<FScatterRule> Rules, const FIntPoint& Cell, float CellSize, int32 Seed);
+
+	static FORCEINLINE FBox2D GetCellBounds(const FIntPoint& Cell, float CellSize)
+	{
+		return FBox2D(FVector2D(Cell) * CellSize, FVector2D(Cell + FIntPoint(1)) * CellSize);
+	}
+};
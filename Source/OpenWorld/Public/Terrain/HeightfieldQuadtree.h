@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FHeightmapR16;
+
+struct FHeightfieldHit
+{
+	FVector Location = FVector::ZeroVector;
+	FVector Normal = FVector::UpVector;
+
+	/** 0 at the start of the segment, 1 at its end */
+	float Time = 1.f;
+};
+
+/**
+ * Min/max height pyramid over a heightfield. Every node knows the height range of the quads below it,
+ * so a segment that passes above (or below) a node skips all of it and only the quads it actually
+ * gets close to are tested against their two triangles, the same split the landscape uses
+ */
+class OPENWORLD_API FHeightfieldQuadtree
+{
+public:
+	// ===== Lifecycles ========== //
+
+	/**
+	 * @param InHeights World heights, InSize.X * InSize.Y samples, lowest float for holes
+	 * @param InOrigin World location of the first sample
+	 * @param InSpacing World distance between samples
+	 */
+	void Build(TArray<float>&& InHeights, const FIntPoint& InSize, const FVector2D& InOrigin, float InSpacing);
+
+	/** The landscape must not be rotated */
+	void BuildFromHeightmap(const FHeightmapR16& Heightmap, const FTransform& LandscapeTransform);
+
+	void Reset();
+
+	// ===== Queries ========== //
+
+	/** Closest crossing of the segment with the heightfield */
+	bool RayCast(const FVector& Start, const FVector& End, FHeightfieldHit& OutHit) const;
+
+	/** Nothing of the heightfield between the two points, stops at the first crossing found */
+	bool IsVisible(const FVector& From, const FVector& To) const;
+
+	FORCEINLINE bool IsValid() const
+	{
+		return !Levels.IsEmpty();
+	}
+	FORCEINLINE SIZE_T GetAllocatedSize() const
+	{
+		SIZE_T Size = Heights.GetAllocatedSize() + Levels.GetAllocatedSize();
+		for (const TArray<FVector2f>& Level : Levels) Size += Level.GetAllocatedSize();
+
+		return Size;
+	}
+
+private:
+	FIntPoint Size = FIntPoint::ZeroValue;
+	FVector2D Origin = FVector2D::ZeroVector;
+	float Spacing = 1.f;
+
+	TArray<float> Heights;
+
+	/** Level 0 is one node per quad, every level above halves both sides. X is the min height, Y the max */
+	TArray<TArray<FVector2f>> Levels;
+	TArray<FIntPoint> LevelSizes;
+
+	template <bool bAnyHit>
+	bool Trace(const FVector& Start, const FVector& End, FHeightfieldHit* OutHit) const;
+
+	/** Entry/exit time of the segment (in grid space) over the node, false if it misses it */
+	bool ClipToNode(int32 Level, int32 X, int32 Y, const FVector2D& GridStart, const FVector2D& GridDelta, float& OutEnter, float& OutExit) const;
+
+	bool IntersectQuad(int32 X, int32 Y, const FVector& Start, const FVector& End, FHeightfieldHit& OutHit) const;
+};
@@ -0,0 +1,124 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FHeightmapR16;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/** Rectangle of a heightmap, reads straight from the source without copying */
+struct OPENWORLD_API FHeightmapView
+{
+	const FHeightmapR16* Source = nullptr;
+	FIntRect Rect;
+
+	FORCEINLINE bool IsValid() const
+	{
+		return Source != nullptr && Rect.Area() > 0;
+	}
+	FORCEINLINE int32 GetWidth() const
+	{
+		return Rect.Width();
+	}
+	FORCEINLINE int32 GetHeight() const
+	{
+		return Rect.Height();
+	}
+
+	/** Local coordinates, clamped to the source (not to the view) so neighbouring views blend seamlessly */
+	uint16 GetRaw(int32 X, int32 Y) const;
+	float SampleBilinear(const FVector2D& Pixel) const;
+	float SampleBicubic(const FVector2D& Pixel) const;
+
+	/** Row by row copy into a tightly packed Width * Height array */
+	void CopyTo(TArray<uint16>& OutHeights) const;
+};
+
+/**
+ * Raw 16 bit little endian heightmap (World Machine/Gaea .r16, same as the landscape import).
+ * The file is memory mapped, so opening an 8k map costs nothing and only the pages that are read get loaded.
+ * Platforms without mapping support fall back to reading the whole file
+ */
+class OPENWORLD_API FHeightmapR16
+{
+public:
+	FHeightmapR16() = default;
+	~FHeightmapR16();
+
+	FHeightmapR16(const FHeightmapR16&) = delete;
+	FHeightmapR16& operator=(const FHeightmapR16&) = delete;
+
+	// ===== Lifecycles ========== //
+
+	/**
+	 * @param InWidth Samples per row, 0 to derive it from the file size (square maps only)
+	 * @return False if the file is missing or its size doesn't match the dimension
+	 */
+	bool Open(const FString& Path, int32 InWidth = 0);
+	void Close();
+
+	// ===== Sampling ========== //
+
+	/** Clamped to the edges */
+	FORCEINLINE uint16 GetRaw(int32 X, int32 Y) const
+	{
+		X = FMath::Clamp(X, 0, Width - 1);
+		Y = FMath::Clamp(Y, 0, Height - 1);
+
+		return Data[(int64)Y * Width + X];
+	}
+
+	/** Pixel space, 0 is the center of the first sample. Results are in raw units (0 - 65535) */
+	float SampleBilinear(const FVector2D& Pixel) const;
+
+	/** Catmull-Rom, smoother slopes than bilinear when the map is magnified */
+	float SampleBicubic(const FVector2D& Pixel) const;
+
+	/** Clipped to the map */
+	FHeightmapView GetView(const FIntRect& Rect) const;
+
+	/** Split into tiles that share their border row/column, like landscape components do */
+	TArray<FHeightmapView> GetTiles(int32 TileSize) const;
+
+	/** Raw value to landscape local Z (before the actor scale), 32768 is zero */
+	static FORCEINLINE float ToLocalHeight(float Raw)
+	{
+		return (Raw - 32768.f) / 128.f;
+	}
+
+	// ===== Getters ========== //
+
+	FORCEINLINE bool IsValid() const
+	{
+		return Data != nullptr;
+	}
+	FORCEINLINE int32 GetWidth() const
+	{
+		return Width;
+	}
+	FORCEINLINE int32 GetHeight() const
+	{
+		return Height;
+	}
+	FORCEINLINE const uint16* GetData() const
+	{
+		return Data;
+	}
+	FORCEINLINE bool IsMapped() const
+	{
+		return MappedRegion.IsValid();
+	}
+
+private:
+	int32 Width = 0;
+	int32 Height = 0;
+	const uint16* Data = nullptr;
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	/** Only used when the platform can't map files */
+	TArray64<uint8> FallbackData;
+};
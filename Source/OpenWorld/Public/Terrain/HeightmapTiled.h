@@ -0,0 +1,134 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FArchive;
+class FHeightmapR16;
+
+/** Where a tile sits in a .owh file and what it needs to be decoded */
+struct FHeightmapTileEntry
+{
+	int64 Offset = 0;
+
+	/** Bytes on disk, and after undoing the compression */
+	int32 Size = 0;
+	int32 RawSize = 0;
+
+	uint16 Min = 0;
+	uint16 Max = 0;
+
+	/** Quantization, 1 is lossless */
+	uint16 Step = 1;
+
+	bool bCompressed = false;
+
+	friend FArchive& operator<<(FArchive& Ar, FHeightmapTileEntry& Entry);
+};
+
+struct FHeightmapEncodeStats
+{
+	int64 RawBytes = 0;
+	int64 EncodedBytes = 0;
+	double Seconds = 0.0;
+};
+
+/**
+ * Tiled heightmap container (.owh). A header and a tile index come first, so any tile can be read on its own.
+ * Each tile is stored relative to its own min, quantized by its own step, predicted from its left/top neighbours
+ * and only the zigzag varint residuals are kept (zlib on top when that's smaller). Smooth terrain ends up at
+ * a fraction of raw R16, and a region is read without touching the rest of the file
+ */
+class OPENWORLD_API FHeightmapTiled
+{
+public:
+	FHeightmapTiled() = default;
+	~FHeightmapTiled();
+
+	FHeightmapTiled(const FHeightmapTiled&) = delete;
+	FHeightmapTiled& operator=(const FHeightmapTiled&) = delete;
+
+	static constexpr uint32 Magic = 0x4857574F; // OWWH
+	static constexpr uint32 Version = 1;
+
+	// ===== Encoding ========== //
+
+	/**
+	 * @param InTileSize Samples per tile side, tiles don't overlap
+	 * @param MaxError Largest difference allowed per sample in raw units, 0 is lossless
+	 */
+	static bool Encode(const FHeightmapR16& Source, const FString& Path, int32 InTileSize = 64, int32 MaxError = 0, FHeightmapEncodeStats* OutStats = nullptr);
+
+	/** One tile's samples into its payload, and back */
+	static void EncodeTile(TConstArrayView<uint16> Samples, int32 TileWidth, int32 MaxError, FHeightmapTileEntry& OutEntry, TArray<uint8>& OutPayload);
+	static bool DecodeTile(TConstArrayView<uint8> Payload, const FHeightmapTileEntry& Entry, int32 TileWidth, int32 TileHeight, TArray<uint16>& OutSamples);
+
+	// ===== Lifecycles ========== //
+
+	/** Reads the header and the index only, tiles are loaded by Stream */
+	bool Open(const FString& Path);
+	void Close();
+
+	// ===== Streaming ========== //
+
+	/**
+	 * Load every tile overlapping the region (in samples) that isn't loaded yet, and drop the ones further than Margin tiles from it
+	 *
+	 * @return How many tiles were loaded
+	 */
+	int32 Stream(const FIntRect& Region, int32 Margin = 1);
+
+	/** Everything at once, e.g. to check the encoder */
+	bool DecodeAll(TArray<uint16>& OutHeights);
+
+	// ===== Sampling ========== //
+
+	/** False if the tile holding it isn't loaded */
+	bool GetRaw(int32 X, int32 Y, uint16& OutRaw) const;
+
+	/** Pixel space like FHeightmapR16, false if one of the four samples isn't loaded */
+	bool SampleBilinear(const FVector2D& Pixel, float& OutRaw) const;
+
+	// ===== Getters ========== //
+
+	FORCEINLINE bool IsValid() const
+	{
+		return Reader.IsValid();
+	}
+	FORCEINLINE int32 GetWidth() const
+	{
+		return Width;
+	}
+	FORCEINLINE int32 GetHeight() const
+	{
+		return Height;
+	}
+	FORCEINLINE int32 GetTileSize() const
+	{
+		return TileSize;
+	}
+	FORCEINLINE int32 GetLoadedTileCount() const
+	{
+		return LoadedTiles.Num();
+	}
+
+private:
+	int32 Width = 0;
+	int32 Height = 0;
+	int32 TileSize = 0;
+	FIntPoint TileCount = FIntPoint::ZeroValue;
+
+	TUniquePtr<FArchive> Reader;
+	TArray<FHeightmapTileEntry> Entries;
+
+	TMap<FIntPoint, TArray<uint16>> LoadedTiles;
+
+	/** Tiles at the right and bottom edges may be cut short */
+	FORCEINLINE FIntPoint GetTileDimension(const FIntPoint& Tile) const
+	{
+		return FIntPoint(FMath::Min(TileSize, Width - Tile.X * TileSize), FMath::Min(TileSize, Height - Tile.Y * TileSize));
+	}
+
+	bool LoadTile(const FIntPoint& Tile, TArray<uint16>& OutSamples);
+};
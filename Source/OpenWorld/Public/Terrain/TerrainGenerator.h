@@ -0,0 +1,114 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Every knob of the pipeline, the same settings and seed always give the same terrain */
+struct FTerrainSettings
+{
+	/** Samples per side, 1009/2017/4033/8129 match full landscape component counts */
+	int32 Resolution = 1009;
+	int32 Seed = 1337;
+
+	// ===== Mountain ========== //
+
+	/** Base features across the map */
+	float Frequency = 3.f;
+	int32 Octaves = 8;
+	float Lacunarity = 2.f;
+	float Gain = .5f;
+
+	/** 0 is rolling hills, 1 is sharp ridges */
+	float Ridged = .7f;
+
+	/** Push the edges down so the map reads as a mountain range rather than a crop of one */
+	float Falloff = .5f;
+
+	// ===== Transform ========== //
+
+	float HeightScale = 1.f;
+	float HeightOffset = 0.f;
+
+	/** Above 1 flattens valleys and sharpens peaks */
+	float Exponent = 1.3f;
+
+	// ===== Erosion ========== //
+
+	/** Highest point over the map width, erosion runs on real slopes so it needs to know how steep the map is */
+	float HeightRatio = .1f;
+
+	int32 HydraulicIterations = 250;
+	float RainRate = .01f;
+	float SedimentCapacity = 1.f;
+	float Dissolving = .3f;
+	float Deposition = .3f;
+	float Evaporation = .5f;
+
+	int32 ThermalIterations = 40;
+
+	/** Degrees, material slides down anything steeper */
+	float TalusAngle = 35.f;
+
+	// ===== Sea ========== //
+
+	/** Normalized height everything below gets flattened to */
+	float SeaLevel = .08f;
+};
+
+/**
+ * Native replacement of the Gaea graph (Mountain -> Transform -> Erosion -> Sea).
+ * Every stage is a data parallel pass over rows reading the previous state only, so the result doesn't depend
+ * on the thread count, and the per sample math runs 4 samples at a time
+ */
+class OPENWORLD_API FTerrainGenerator
+{
+public:
+	explicit FTerrainGenerator(const FTerrainSettings& InSettings);
+
+	// ===== Stages ========== //
+
+	/** Every stage in order */
+	void Generate();
+
+	void GenerateMountain();
+	void ApplyTransform();
+
+	/** Virtual pipe water simulation (rain, flow, dissolve/deposit, sediment transport, evaporation) */
+	void ApplyHydraulicErosion();
+
+	/** Slopes above the talus angle collapse onto their lower neighbours */
+	void ApplyThermalErosion();
+
+	/** Remap to 0 - 1 */
+	void Normalize();
+	void ApplySeaLevel();
+
+	// ===== Output ========== //
+
+	void ToR16(TArray<uint16>& OutHeights) const;
+	bool SaveR16(const FString& Path) const;
+
+	FORCEINLINE const TArray<float>& GetHeights() const
+	{
+		return Heights;
+	}
+	FORCEINLINE int32 GetResolution() const
+	{
+		return Settings.Resolution;
+	}
+
+private:
+	FTerrainSettings Settings;
+
+	/** Resolution * Resolution, row major */
+	TArray<float> Heights;
+
+	/** Run Body(Y) for every row on the workers */
+	template <typename BodyType>
+	void ForEachRow(BodyType&& Body) const;
+
+	/** Run Body(Index) over every sample, 4 at a time, with a scalar tail */
+	template <typename VectorBodyType, typename ScalarBodyType>
+	void ForEachSample(VectorBodyType&& VectorBody, ScalarBodyType&& ScalarBody) const;
+};
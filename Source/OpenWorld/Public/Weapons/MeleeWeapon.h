@@ -9,6 +9,7 @@
 
 class AOWCharacter;
 class UBoxComponent;
+class UCooldownComponent;
 class USphereComponent;
 class UNiagaraComponent;
 class UNiagaraSystem;
@@ -59,6 +60,10 @@ protected:
 	UPROPERTY(VisibleAnywhere)
 	TObjectPtr<USphereComponent> InteractArea;
 
+	/** Temp damage and dropped physics delays */
+	UPROPERTY(VisibleAnywhere)
+	TObjectPtr<UCooldownComponent> Cooldowns;
+
 	// ===== Collision Events ========== //
 
 	UFUNCTION()
@@ -92,11 +97,9 @@ protected:
 	UPROPERTY(EditAnywhere, Category=Combat)
 	float Damage = 20.f;
 
+	/** After certain time (EC_TempDamage), set back the damage to default one */
 	float DefaultDamage = Damage;
 
-	/** After certain time, set back the damage to default one */
-	FTimerHandle TempDamageDelayHandler;
-
 	void ApplyDamage(FHitResult &TraceResult);
     void HitTrace(FHitResult &TraceResult);
 
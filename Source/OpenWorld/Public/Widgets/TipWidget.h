@@ -14,7 +14,7 @@ class OPENWORLD_API UTipWidget : public UUserWidget
 	GENERATED_BODY()
 	
 public:
-	FORCEINLINE void ShowTip(const FString& Text);
+	FORCEINLINE void ShowTip(const FText& Text);
 	FORCEINLINE void HideTip()
 	{
 		SetVisibility(ESlateVisibility::Collapsed);